@@ -25,6 +25,8 @@
 #ifdef ANDROID
 #include <linux/ashmem.h>
 #include <sys/ioctl.h>
+#elif defined __linux__
+#include <sys/syscall.h>
 #endif
 #endif
 
@@ -54,12 +56,34 @@ static int AshmemCreateFileMapping(const char* name, size_t size)
 }
 #endif
 
-void MemArena::GrabSHMSegment(size_t size)
+#if defined __linux__ && !defined ANDROID
+// Makes the pages of the segment be allocated on a NUMA node when they are first touched, through
+// any view. mbind() is called directly as its header is part of libnuma.
+static void SetPreferredNode(int fd, size_t size, u32 node)
+{
+  constexpr int MPOL_PREFERRED = 1;
+  constexpr u32 MAX_NODES = sizeof(unsigned long) * 8;
+  if (node >= MAX_NODES)
+    return;
+
+  void* const view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (view == MAP_FAILED)
+    return;
+
+  const unsigned long node_mask = 1UL << node;
+  if (syscall(SYS_mbind, view, size, MPOL_PREFERRED, &node_mask, MAX_NODES + 1, 0) != 0)
+    WARN_LOG(MEMMAP, "mbind failed: %s", LastStrerrorString().c_str());
+  munmap(view, size);
+}
+#endif
+
+void MemArena::GrabSHMSegment(size_t size, std::optional<u32> numa_node)
 {
 #ifdef _WIN32
   const std::string name = "dolphin-emu." + std::to_string(GetCurrentProcessId());
-  hMemoryMapping = CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
-                                     static_cast<DWORD>(size), UTF8ToTStr(name).c_str());
+  hMemoryMapping = CreateFileMappingNuma(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+                                         static_cast<DWORD>(size), UTF8ToTStr(name).c_str(),
+                                         numa_node ? *numa_node : NUMA_NO_PREFERRED_NODE);
 #elif defined(ANDROID)
   fd = AshmemCreateFileMapping(("dolphin-emu." + std::to_string(getpid())).c_str(), size);
   if (fd < 0)
@@ -78,6 +102,10 @@ void MemArena::GrabSHMSegment(size_t size)
   shm_unlink(file_name.c_str());
   if (ftruncate(fd, size) < 0)
     ERROR_LOG(MEMMAP, "Failed to allocate low memory space");
+#ifdef __linux__
+  if (numa_node)
+    SetPreferredNode(fd, size, *numa_node);
+#endif
 #endif
 }
 
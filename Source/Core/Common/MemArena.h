@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <optional>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -21,7 +22,8 @@ namespace Common
 class MemArena
 {
 public:
-  void GrabSHMSegment(size_t size);
+  // If a NUMA node is given, the memory is allocated on it where the OS lets us choose.
+  void GrabSHMSegment(size_t size, std::optional<u32> numa_node = std::nullopt);
   void ReleaseSHMSegment();
   void* CreateView(s64 offset, size_t size, void* base = nullptr);
   void ReleaseView(void* view, size_t size);
@@ -3,8 +3,17 @@
 // Refer to the license.txt file included.
 
 #include "Common/Thread.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+#include <fmt/format.h>
+
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -38,6 +47,89 @@ int CurrentThreadId()
 #endif
 }
 
+constexpr u32 MAX_PROCESSORS = 4096;
+constexpr u32 MAX_NUMA_NODES = 64;
+
+static std::optional<std::vector<u32>> GetNodeProcessors(u32 node)
+{
+  if (node >= MAX_NUMA_NODES)
+    return std::nullopt;
+
+#ifdef _WIN32
+  ULONGLONG mask;
+  if (!GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask) || mask == 0)
+    return std::nullopt;
+
+  std::vector<u32> processors;
+  for (u32 i = 0; i < 64; ++i)
+  {
+    if ((mask >> i) & 1)
+      processors.push_back(i);
+  }
+  return processors;
+#elif defined __linux__ && !defined ANDROID
+  // sysfs reports a size which the file doesn't have, so it can't be read in one go.
+  std::string list;
+  std::ifstream file;
+  File::OpenFStream(file, fmt::format("/sys/devices/system/node/node{}/cpulist", node),
+                    std::ios_base::in);
+  if (!std::getline(file, list))
+    return std::nullopt;
+  return ParseProcessorList(list);
+#else
+  return std::nullopt;
+#endif
+}
+
+std::optional<std::vector<u32>> ParseProcessorList(std::string_view list)
+{
+  constexpr std::string_view NODE_PREFIX = "node:";
+  if (StringBeginsWith(list, NODE_PREFIX))
+  {
+    const std::string node_string(list.substr(NODE_PREFIX.size()));
+    u32 node;
+    if (node_string.empty() || !TryParse(node_string, &node))
+      return std::nullopt;
+    return GetNodeProcessors(node);
+  }
+
+  std::vector<u32> processors;
+  for (const std::string& range : SplitString(std::string(StripSpaces(list)), ','))
+  {
+    const size_t dash = range.find('-');
+    const std::string first_string = range.substr(0, dash);
+    const std::string last_string =
+        dash == std::string::npos ? first_string : range.substr(dash + 1);
+    u32 first, last;
+    if (first_string.empty() || last_string.empty() || !TryParse(first_string, &first) ||
+        !TryParse(last_string, &last) || last < first || last >= MAX_PROCESSORS)
+    {
+      return std::nullopt;
+    }
+
+    for (u32 processor = first; processor <= last; ++processor)
+      processors.push_back(processor);
+  }
+
+  if (processors.empty())
+    return std::nullopt;
+  return processors;
+}
+
+std::optional<u32> GetProcessorNode(u32 processor)
+{
+  for (u32 node = 0; node < MAX_NUMA_NODES; ++node)
+  {
+    const std::optional<std::vector<u32>> processors = GetNodeProcessors(node);
+    if (processors &&
+        std::find(processors->begin(), processors->end(), processor) != processors->end())
+    {
+      return node;
+    }
+  }
+  return std::nullopt;
+}
+
 #ifdef _WIN32
 
 void SetThreadAffinity(std::thread::native_handle_type thread, u32 mask)
@@ -50,6 +142,18 @@ void SetCurrentThreadAffinity(u32 mask)
   SetThreadAffinityMask(GetCurrentThread(), mask);
 }
 
+bool SetCurrentThreadAffinity(const std::vector<u32>& processors)
+{
+  DWORD_PTR mask = 0;
+  for (u32 processor : processors)
+  {
+    if (processor >= sizeof(mask) * 8)
+      return false;
+    mask |= DWORD_PTR(1) << processor;
+  }
+  return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
 // Supporting functions
 void SleepCurrentThread(int ms)
 {
@@ -119,6 +223,32 @@ void SetCurrentThreadAffinity(u32 mask)
   SetThreadAffinity(pthread_self(), mask);
 }
 
+bool SetCurrentThreadAffinity(const std::vector<u32>& processors)
+{
+#ifdef __APPLE__
+  // Affinity tags only group threads together, they can't pin them to processors.
+  return false;
+#elif (defined __linux__ || defined BSD4_4 || defined __FreeBSD__) && !(defined ANDROID)
+#ifdef __FreeBSD__
+  cpuset_t cpu_set;
+#else
+  cpu_set_t cpu_set;
+#endif
+  CPU_ZERO(&cpu_set);
+
+  for (u32 processor : processors)
+  {
+    if (processor >= CPU_SETSIZE)
+      return false;
+    CPU_SET(processor, &cpu_set);
+  }
+
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+  return false;
+#endif
+}
+
 void SleepCurrentThread(int ms)
 {
   usleep(1000 * ms);
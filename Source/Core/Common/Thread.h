@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <optional>
+#include <string_view>
 #include <thread>
+#include <vector>
 
 // Don't include Common.h here as it will break LogManager
 #include "Common/CommonTypes.h"
@@ -23,6 +26,15 @@ int CurrentThreadId();
 void SetThreadAffinity(std::thread::native_handle_type thread, u32 mask);
 void SetCurrentThreadAffinity(u32 mask);
 
+// Parses a list of logical processors like "0-3,8", or "node:N" for the processors of a NUMA node.
+// Returns nullopt if the list is empty or invalid, or if the node isn't known.
+std::optional<std::vector<u32>> ParseProcessorList(std::string_view list);
+// Returns the NUMA node of a logical processor, if it is known.
+std::optional<u32> GetProcessorNode(u32 processor);
+// Pins the current thread to a list of logical processors. Returns false if that isn't supported,
+// which on Windows is the case for processors outside of the first processor group.
+bool SetCurrentThreadAffinity(const std::vector<u32>& processors);
+
 void SleepCurrentThread(int ms);
 void SwitchCurrentThread();  // On Linux, this is equal to sleep 1ms
 
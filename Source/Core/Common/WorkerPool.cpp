@@ -0,0 +1,99 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/WorkerPool.h"
+
+#include "Common/Thread.h"
+
+namespace Common
+{
+void WorkerPool::Reset(u32 num_workers, std::string name)
+{
+  Shutdown();
+
+  m_shutdown = false;
+  m_workers.reserve(num_workers);
+  for (u32 i = 0; i < num_workers; i++)
+    m_workers.emplace_back(&WorkerPool::WorkerThread, this, name);
+}
+
+void WorkerPool::Shutdown()
+{
+  {
+    std::lock_guard lk(m_lock);
+    m_shutdown = true;
+  }
+  m_wakeup.notify_all();
+
+  for (std::thread& worker : m_workers)
+    worker.join();
+  m_workers.clear();
+}
+
+void WorkerPool::ParallelFor(u32 count, const std::function<void(u32)>& function)
+{
+  if (m_workers.empty() || count <= 1)
+  {
+    for (u32 i = 0; i < count; i++)
+      function(i);
+    return;
+  }
+
+  std::lock_guard submit_lk(m_submit_lock);
+
+  Batch batch;
+  batch.function = &function;
+  batch.count = count;
+  {
+    std::lock_guard lk(m_lock);
+    m_batch = &batch;
+    m_batch_generation++;
+  }
+  m_wakeup.notify_all();
+
+  RunBatch(&batch);
+
+  // Every index has been claimed at this point, but workers may still be running the last ones.
+  std::unique_lock lk(m_lock);
+  m_batch = nullptr;
+  m_batch_done.wait(lk, [&batch] { return batch.active_workers == 0; });
+}
+
+void WorkerPool::RunBatch(Batch* batch)
+{
+  u32 index;
+  while ((index = batch->next_index.fetch_add(1, std::memory_order_relaxed)) < batch->count)
+    (*batch->function)(index);
+}
+
+void WorkerPool::WorkerThread(std::string name)
+{
+  Common::SetCurrentThreadName(name.c_str());
+
+  u64 last_generation = 0;
+  std::unique_lock lk(m_lock);
+  while (true)
+  {
+    m_wakeup.wait(lk, [&] { return m_shutdown || m_batch_generation != last_generation; });
+    if (m_shutdown)
+      return;
+
+    last_generation = m_batch_generation;
+
+    // The batch may already be over if this worker was slow to wake up.
+    Batch* batch = m_batch;
+    if (!batch)
+      continue;
+
+    batch->active_workers++;
+    lk.unlock();
+    RunBatch(batch);
+    lk.lock();
+
+    if (--batch->active_workers == 0)
+      m_batch_done.notify_one();
+  }
+}
+
+}  // namespace Common
@@ -0,0 +1,69 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// A fixed set of threads used to split up a chunk of work and wait for all of it to complete.
+// Unlike WorkQueueThread, the submitting thread blocks until the work is done, and takes part in it
+// itself, so a pool with zero workers simply runs everything on the calling thread.
+
+namespace Common
+{
+class WorkerPool
+{
+public:
+  WorkerPool() = default;
+  WorkerPool(u32 num_workers, std::string name) { Reset(num_workers, std::move(name)); }
+  ~WorkerPool() { Shutdown(); }
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  // Stops the current workers, and starts num_workers new ones.
+  void Reset(u32 num_workers, std::string name);
+  void Shutdown();
+
+  u32 GetWorkerCount() const { return static_cast<u32>(m_workers.size()); }
+
+  // Calls function(i) for every i in [0, count), spread across the workers and the calling thread.
+  // Returns once every call has completed. Only one batch runs at a time.
+  void ParallelFor(u32 count, const std::function<void(u32)>& function);
+
+private:
+  struct Batch
+  {
+    const std::function<void(u32)>* function;
+    u32 count;
+    std::atomic<u32> next_index{0};
+    u32 active_workers = 0;
+  };
+
+  static void RunBatch(Batch* batch);
+  void WorkerThread(std::string name);
+
+  std::vector<std::thread> m_workers;
+
+  // Serializes ParallelFor calls.
+  std::mutex m_submit_lock;
+
+  // Protects everything below.
+  std::mutex m_lock;
+  std::condition_variable m_wakeup;
+  std::condition_variable m_batch_done;
+  Batch* m_batch = nullptr;
+  u64 m_batch_generation = 0;
+  bool m_shutdown = false;
+};
+
+}  // namespace Common
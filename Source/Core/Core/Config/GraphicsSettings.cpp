@@ -34,6 +34,8 @@ const ConfigInfo<bool> GFX_SHOW_NETPLAY_MESSAGES{{System::GFX, "Settings", "Show
                                                  false};
 const ConfigInfo<bool> GFX_LOG_RENDER_TIME_TO_FILE{{System::GFX, "Settings", "LogRenderTimeToFile"},
                                                    false};
+const ConfigInfo<bool> GFX_LOG_GPU_THREAD_TIMES_TO_FILE{
+    {System::GFX, "Settings", "LogGPUThreadTimesToFile"}, false};
 const ConfigInfo<bool> GFX_OVERLAY_STATS{{System::GFX, "Settings", "OverlayStats"}, false};
 const ConfigInfo<bool> GFX_OVERLAY_PROJ_STATS{{System::GFX, "Settings", "OverlayProjStats"}, false};
 const ConfigInfo<bool> GFX_DUMP_TEXTURES{{System::GFX, "Settings", "DumpTextures"}, false};
@@ -44,6 +46,7 @@ const ConfigInfo<bool> GFX_DUMP_EFB_TARGET{{System::GFX, "Settings", "DumpEFBTar
 const ConfigInfo<bool> GFX_DUMP_XFB_TARGET{{System::GFX, "Settings", "DumpXFBTarget"}, false};
 const ConfigInfo<bool> GFX_DUMP_FRAMES_AS_IMAGES{{System::GFX, "Settings", "DumpFramesAsImages"},
                                                  false};
+const ConfigInfo<bool> GFX_DUMP_FRAME_HASHES{{System::GFX, "Settings", "DumpFrameHashes"}, false};
 const ConfigInfo<bool> GFX_FREE_LOOK{{System::GFX, "Settings", "FreeLook"}, false};
 const ConfigInfo<bool> GFX_USE_FFV1{{System::GFX, "Settings", "UseFFV1"}, false};
 const ConfigInfo<std::string> GFX_DUMP_FORMAT{{System::GFX, "Settings", "DumpFormat"}, "avi"};
@@ -51,6 +54,8 @@ const ConfigInfo<std::string> GFX_DUMP_CODEC{{System::GFX, "Settings", "DumpCode
 const ConfigInfo<std::string> GFX_DUMP_ENCODER{{System::GFX, "Settings", "DumpEncoder"}, ""};
 const ConfigInfo<std::string> GFX_DUMP_PATH{{System::GFX, "Settings", "DumpPath"}, ""};
 const ConfigInfo<int> GFX_BITRATE_KBPS{{System::GFX, "Settings", "BitrateKbps"}, 25000};
+const ConfigInfo<int> GFX_DUMP_ENCODER_THREADS{{System::GFX, "Settings", "DumpEncoderThreads"}, 0};
+const ConfigInfo<int> GFX_DUMP_QUEUE_SIZE{{System::GFX, "Settings", "DumpQueueSize"}, 4};
 const ConfigInfo<bool> GFX_INTERNAL_RESOLUTION_FRAME_DUMPS{
     {System::GFX, "Settings", "InternalResolutionFrameDumps"}, false};
 const ConfigInfo<bool> GFX_ENABLE_GPU_TEXTURE_DECODING{
@@ -93,6 +98,16 @@ const ConfigInfo<int> GFX_SHADER_COMPILER_THREADS{
     {System::GFX, "Settings", "ShaderCompilerThreads"}, 1};
 const ConfigInfo<int> GFX_SHADER_PRECOMPILER_THREADS{
     {System::GFX, "Settings", "ShaderPrecompilerThreads"}, 1};
+const ConfigInfo<int> GFX_TEXTURE_DECODE_THREADS{{System::GFX, "Settings", "TextureDecodeThreads"},
+                                                 -1};
+const ConfigInfo<int> GFX_VERTEX_LOADER_THREADS{{System::GFX, "Settings", "VertexLoaderThreads"},
+                                                0};
+const ConfigInfo<bool> GFX_CPU_CULL{{System::GFX, "Settings", "CPUCull"}, false};
+const ConfigInfo<bool> GFX_DISPLAY_LIST_CACHE{{System::GFX, "Settings", "DisplayListCache"},
+                                              false};
+const ConfigInfo<bool> GFX_DIRECT_FIFO_READ{{System::GFX, "Settings", "DirectFifoRead"}, false};
+const ConfigInfo<bool> GFX_VERTEX_DEDUPLICATION{{System::GFX, "Settings", "VertexDeduplication"},
+                                                false};
 const ConfigInfo<bool> GFX_SAVE_TEXTURE_CACHE_TO_STATE{
     {System::GFX, "Settings", "SaveTextureCacheToState"}, true};
 
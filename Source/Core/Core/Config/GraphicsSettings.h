@@ -32,6 +32,7 @@ extern const ConfigInfo<bool> GFX_SHOW_FPS;
 extern const ConfigInfo<bool> GFX_SHOW_NETPLAY_PING;
 extern const ConfigInfo<bool> GFX_SHOW_NETPLAY_MESSAGES;
 extern const ConfigInfo<bool> GFX_LOG_RENDER_TIME_TO_FILE;
+extern const ConfigInfo<bool> GFX_LOG_GPU_THREAD_TIMES_TO_FILE;
 extern const ConfigInfo<bool> GFX_OVERLAY_STATS;
 extern const ConfigInfo<bool> GFX_OVERLAY_PROJ_STATS;
 extern const ConfigInfo<bool> GFX_DUMP_TEXTURES;
@@ -40,6 +41,7 @@ extern const ConfigInfo<bool> GFX_CACHE_HIRES_TEXTURES;
 extern const ConfigInfo<bool> GFX_DUMP_EFB_TARGET;
 extern const ConfigInfo<bool> GFX_DUMP_XFB_TARGET;
 extern const ConfigInfo<bool> GFX_DUMP_FRAMES_AS_IMAGES;
+extern const ConfigInfo<bool> GFX_DUMP_FRAME_HASHES;
 extern const ConfigInfo<bool> GFX_FREE_LOOK;
 extern const ConfigInfo<bool> GFX_USE_FFV1;
 extern const ConfigInfo<std::string> GFX_DUMP_FORMAT;
@@ -47,6 +49,8 @@ extern const ConfigInfo<std::string> GFX_DUMP_CODEC;
 extern const ConfigInfo<std::string> GFX_DUMP_ENCODER;
 extern const ConfigInfo<std::string> GFX_DUMP_PATH;
 extern const ConfigInfo<int> GFX_BITRATE_KBPS;
+extern const ConfigInfo<int> GFX_DUMP_ENCODER_THREADS;
+extern const ConfigInfo<int> GFX_DUMP_QUEUE_SIZE;
 extern const ConfigInfo<bool> GFX_INTERNAL_RESOLUTION_FRAME_DUMPS;
 extern const ConfigInfo<bool> GFX_ENABLE_GPU_TEXTURE_DECODING;
 extern const ConfigInfo<bool> GFX_ENABLE_PIXEL_LIGHTING;
@@ -67,6 +71,12 @@ extern const ConfigInfo<bool> GFX_WAIT_FOR_SHADERS_BEFORE_STARTING;
 extern const ConfigInfo<ShaderCompilationMode> GFX_SHADER_COMPILATION_MODE;
 extern const ConfigInfo<int> GFX_SHADER_COMPILER_THREADS;
 extern const ConfigInfo<int> GFX_SHADER_PRECOMPILER_THREADS;
+extern const ConfigInfo<int> GFX_TEXTURE_DECODE_THREADS;
+extern const ConfigInfo<int> GFX_VERTEX_LOADER_THREADS;
+extern const ConfigInfo<bool> GFX_CPU_CULL;
+extern const ConfigInfo<bool> GFX_DISPLAY_LIST_CACHE;
+extern const ConfigInfo<bool> GFX_DIRECT_FIFO_READ;
+extern const ConfigInfo<bool> GFX_VERTEX_DEDUPLICATION;
 extern const ConfigInfo<bool> GFX_SAVE_TEXTURE_CACHE_TO_STATE;
 
 extern const ConfigInfo<bool> GFX_SW_ZCOMPLOC;
@@ -26,6 +26,14 @@ const ConfigInfo<bool> MAIN_DSP_HLE{{System::Main, "Core", "DSPHLE"}, true};
 const ConfigInfo<int> MAIN_TIMING_VARIANCE{{System::Main, "Core", "TimingVariance"}, 40};
 const ConfigInfo<bool> MAIN_CPU_THREAD{{System::Main, "Core", "CPUThread"}, true};
 const ConfigInfo<bool> MAIN_SYNC_ON_SKIP_IDLE{{System::Main, "Core", "SyncOnSkipIdle"}, true};
+const ConfigInfo<std::string> MAIN_CPU_THREAD_AFFINITY{{System::Main, "Core", "CPUThreadAffinity"},
+                                                       ""};
+const ConfigInfo<std::string> MAIN_GPU_THREAD_AFFINITY{{System::Main, "Core", "GPUThreadAffinity"},
+                                                       ""};
+const ConfigInfo<std::string> MAIN_DSP_THREAD_AFFINITY{{System::Main, "Core", "DSPThreadAffinity"},
+                                                       ""};
+const ConfigInfo<std::string> MAIN_DVD_THREAD_AFFINITY{{System::Main, "Core", "DVDThreadAffinity"},
+                                                       ""};
 const ConfigInfo<std::string> MAIN_DEFAULT_ISO{{System::Main, "Core", "DefaultISO"}, ""};
 const ConfigInfo<bool> MAIN_ENABLE_CHEATS{{System::Main, "Core", "EnableCheats"}, false};
 const ConfigInfo<int> MAIN_GC_LANGUAGE{{System::Main, "Core", "SelectedLanguage"}, 0};
@@ -95,6 +103,8 @@ const ConfigInfo<bool> MAIN_FAST_DISC_SPEED{{System::Main, "Core", "FastDiscSpee
 const ConfigInfo<bool> MAIN_LOW_DCBZ_HACK{{System::Main, "Core", "LowDCBZHack"}, false};
 const ConfigInfo<bool> MAIN_FPRF{{System::Main, "Core", "FPRF"}, false};
 const ConfigInfo<bool> MAIN_ACCURATE_NANS{{System::Main, "Core", "AccurateNaNs"}, false};
+const ConfigInfo<bool> MAIN_HLE_NATIVE_FUNCTIONS{{System::Main, "Core", "HLENativeFunctions"},
+                                                 false};
 const ConfigInfo<float> MAIN_EMULATION_SPEED{{System::Main, "Core", "EmulationSpeed"}, 1.0f};
 const ConfigInfo<float> MAIN_OVERCLOCK{{System::Main, "Core", "Overclock"}, 1.0f};
 const ConfigInfo<bool> MAIN_OVERCLOCK_ENABLE{{System::Main, "Core", "OverclockEnable"}, false};
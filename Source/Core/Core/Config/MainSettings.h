@@ -32,6 +32,12 @@ extern const ConfigInfo<bool> MAIN_DSP_HLE;
 extern const ConfigInfo<int> MAIN_TIMING_VARIANCE;
 extern const ConfigInfo<bool> MAIN_CPU_THREAD;
 extern const ConfigInfo<bool> MAIN_SYNC_ON_SKIP_IDLE;
+// Processors to pin the emulation threads to, as a list like "0-3,8", or as "node:N" for the
+// processors of a NUMA node. The emulated memory is allocated on the node of the CPU thread.
+extern const ConfigInfo<std::string> MAIN_CPU_THREAD_AFFINITY;
+extern const ConfigInfo<std::string> MAIN_GPU_THREAD_AFFINITY;
+extern const ConfigInfo<std::string> MAIN_DSP_THREAD_AFFINITY;
+extern const ConfigInfo<std::string> MAIN_DVD_THREAD_AFFINITY;
 extern const ConfigInfo<std::string> MAIN_DEFAULT_ISO;
 extern const ConfigInfo<bool> MAIN_ENABLE_CHEATS;
 extern const ConfigInfo<int> MAIN_GC_LANGUAGE;
@@ -73,6 +79,8 @@ extern const ConfigInfo<bool> MAIN_FAST_DISC_SPEED;
 extern const ConfigInfo<bool> MAIN_LOW_DCBZ_HACK;
 extern const ConfigInfo<bool> MAIN_FPRF;
 extern const ConfigInfo<bool> MAIN_ACCURATE_NANS;
+// Finds hot leaf functions of the SDK through their signatures, and runs them natively.
+extern const ConfigInfo<bool> MAIN_HLE_NATIVE_FUNCTIONS;
 extern const ConfigInfo<float> MAIN_EMULATION_SPEED;
 extern const ConfigInfo<float> MAIN_OVERCLOCK;
 extern const ConfigInfo<bool> MAIN_OVERCLOCK_ENABLE;
@@ -28,7 +28,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       return true;
   }
 
-  static constexpr std::array<const Config::ConfigLocation*, 93> s_setting_saveable = {
+  static constexpr std::array<const Config::ConfigLocation*, 103> s_setting_saveable = {
       // Main.Core
 
       &Config::MAIN_DEFAULT_ISO.location,
@@ -61,6 +61,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       &Config::GFX_SHOW_NETPLAY_PING.location,
       &Config::GFX_SHOW_NETPLAY_MESSAGES.location,
       &Config::GFX_LOG_RENDER_TIME_TO_FILE.location,
+      &Config::GFX_LOG_GPU_THREAD_TIMES_TO_FILE.location,
       &Config::GFX_OVERLAY_STATS.location,
       &Config::GFX_OVERLAY_PROJ_STATS.location,
       &Config::GFX_DUMP_TEXTURES.location,
@@ -68,6 +69,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       &Config::GFX_CACHE_HIRES_TEXTURES.location,
       &Config::GFX_DUMP_EFB_TARGET.location,
       &Config::GFX_DUMP_FRAMES_AS_IMAGES.location,
+      &Config::GFX_DUMP_FRAME_HASHES.location,
       &Config::GFX_FREE_LOOK.location,
       &Config::GFX_USE_FFV1.location,
       &Config::GFX_DUMP_FORMAT.location,
@@ -75,6 +77,8 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       &Config::GFX_DUMP_ENCODER.location,
       &Config::GFX_DUMP_PATH.location,
       &Config::GFX_BITRATE_KBPS.location,
+      &Config::GFX_DUMP_ENCODER_THREADS.location,
+      &Config::GFX_DUMP_QUEUE_SIZE.location,
       &Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS.location,
       &Config::GFX_ENABLE_GPU_TEXTURE_DECODING.location,
       &Config::GFX_ENABLE_PIXEL_LIGHTING.location,
@@ -95,6 +99,12 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       &Config::GFX_SHADER_COMPILATION_MODE.location,
       &Config::GFX_SHADER_COMPILER_THREADS.location,
       &Config::GFX_SHADER_PRECOMPILER_THREADS.location,
+      &Config::GFX_TEXTURE_DECODE_THREADS.location,
+      &Config::GFX_VERTEX_LOADER_THREADS.location,
+      &Config::GFX_CPU_CULL.location,
+      &Config::GFX_DISPLAY_LIST_CACHE.location,
+      &Config::GFX_DIRECT_FIFO_READ.location,
+      &Config::GFX_VERTEX_DEDUPLICATION.location,
       &Config::GFX_SAVE_TEXTURE_CACHE_TO_STATE.location,
 
       &Config::GFX_SW_ZCOMPLOC.location,
@@ -24,6 +24,7 @@
 #include "Common/CPUDetect.h"
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/Event.h"
 #include "Common/FileUtil.h"
 #include "Common/Flag.h"
@@ -39,6 +40,7 @@
 #include "Core/Analytics.h"
 #include "Core/Boot/Boot.h"
 #include "Core/BootManager.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/DSPEmulator.h"
@@ -99,6 +101,7 @@ static Common::Flag s_is_booting;
 static Common::Event s_done_booting;
 static std::thread s_emu_thread;
 static StateChangedCallbackFunc s_on_state_changed_callback;
+static FramePresentedCallbackFunc s_on_frame_presented_callback;
 
 static std::thread s_cpu_thread;
 static bool s_request_refresh_info = false;
@@ -299,6 +302,20 @@ void UndeclareAsCPUThread()
   tls_is_cpu_thread = false;
 }
 
+void SetCurrentThreadAffinity(const Config::ConfigInfo<std::string>& setting)
+{
+  const std::string processors = Config::Get(setting);
+  if (processors.empty())
+    return;
+
+  const std::optional<std::vector<u32>> list = Common::ParseProcessorList(processors);
+  if (!list || !Common::SetCurrentThreadAffinity(*list))
+  {
+    WARN_LOG(CORE, "Failed to pin a thread to the processors of %s: %s",
+             setting.location.key.c_str(), processors.c_str());
+  }
+}
+
 // For the CPU Thread only.
 static void CPUSetInitialExecutionState()
 {
@@ -322,6 +339,7 @@ static void CpuThread(const std::optional<std::string>& savestate_path, bool del
     Common::SetCurrentThreadName("CPU thread");
   else
     Common::SetCurrentThreadName("CPU-GPU thread");
+  SetCurrentThreadAffinity(Config::MAIN_CPU_THREAD_AFFINITY);
 
   // This needs to be delayed until after the video backend is ready.
   DolphinAnalytics::Instance().ReportGameStart();
@@ -383,6 +401,7 @@ static void FifoPlayerThread(const std::optional<std::string>& savestate_path,
     Common::SetCurrentThreadName("FIFO player thread");
   else
     Common::SetCurrentThreadName("FIFO-GPU thread");
+  SetCurrentThreadAffinity(Config::MAIN_CPU_THREAD_AFFINITY);
 
   // Enter CPU run loop. When we leave it - we are done.
   if (auto cpu_core = FifoPlayer::GetInstance().GetCPUCore())
@@ -595,6 +614,8 @@ static void EmuThread(std::unique_ptr<BootParameters> boot, WindowSystemInfo wsi
 
     // Spawn the CPU thread. The CPU thread will signal the event that boot is complete.
     s_cpu_thread = std::thread(cpuThreadFunc, savestate_path, delete_savestate);
+    // Only once the CPU thread is spawned, as it would inherit the affinity.
+    SetCurrentThreadAffinity(Config::MAIN_GPU_THREAD_AFFINITY);
 
     // become the GPU thread
     Fifo::RunGpuLoop();
@@ -856,7 +877,11 @@ void VideoThrottle()
 void Callback_VideoCopiedToXFB(bool video_update)
 {
   if (video_update)
+  {
     s_drawn_frame++;
+    if (s_on_frame_presented_callback)
+      s_on_frame_presented_callback();
+  }
 }
 
 // Called at field boundaries in `VideoInterface::Update()`
@@ -969,6 +994,11 @@ void SetOnStateChangedCallback(StateChangedCallbackFunc callback)
   s_on_state_changed_callback = std::move(callback);
 }
 
+void SetOnFramePresentedCallback(FramePresentedCallbackFunc callback)
+{
+  s_on_frame_presented_callback = std::move(callback);
+}
+
 void UpdateWantDeterminism(bool initial)
 {
   // For now, this value is not itself configurable.  Instead, individual
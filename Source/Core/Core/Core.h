@@ -20,6 +20,12 @@
 struct BootParameters;
 struct WindowSystemInfo;
 
+namespace Config
+{
+template <typename T>
+struct ConfigInfo;
+}
+
 namespace Core
 {
 bool GetIsThrottlerTempDisabled();
@@ -44,6 +50,10 @@ void Shutdown();
 void DeclareAsCPUThread();
 void UndeclareAsCPUThread();
 
+// Pins the current thread to the processors of an affinity setting such as
+// Config::MAIN_CPU_THREAD_AFFINITY, unless it's empty.
+void SetCurrentThreadAffinity(const Config::ConfigInfo<std::string>& setting);
+
 std::string StopMessage(bool main_thread, std::string_view message);
 
 bool IsRunning();
@@ -92,6 +102,10 @@ void RunOnCPUThread(std::function<void()> function, bool wait_for_completion);
 using StateChangedCallbackFunc = std::function<void(Core::State)>;
 void SetOnStateChangedCallback(StateChangedCallbackFunc callback);
 
+// Called on the GPU thread each time the renderer presents a new frame.
+using FramePresentedCallbackFunc = std::function<void()>;
+void SetOnFramePresentedCallback(FramePresentedCallbackFunc callback);
+
 // Run on the Host thread when the factors change. [NOT THREADSAFE]
 void UpdateWantDeterminism(bool initial = false);
 
@@ -475,12 +475,12 @@ Gen::OpArg DSPEmitter::M_SDSP_external_interrupt_waiting()
 
 Gen::OpArg DSPEmitter::M_SDSP_r_st(size_t index)
 {
-  return MDisp(R15, static_cast<int>(offsetof(SDSP, r.st[index])));
+  return MDisp(R15, static_cast<int>((offsetof(SDSP, r.st) + (index) * sizeof(SDSP{}.r.st[0]))));
 }
 
 Gen::OpArg DSPEmitter::M_SDSP_reg_stack_ptr(size_t index)
 {
-  return MDisp(R15, static_cast<int>(offsetof(SDSP, reg_stack_ptr[index])));
+  return MDisp(R15, static_cast<int>((offsetof(SDSP, reg_stack_ptr) + (index) * sizeof(SDSP{}.reg_stack_ptr[0]))));
 }
 
 }  // namespace DSP::JIT::x64
@@ -31,25 +31,25 @@ static Gen::OpArg GetRegisterPointer(size_t reg)
   case DSP_REG_AR1:
   case DSP_REG_AR2:
   case DSP_REG_AR3:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ar[reg - DSP_REG_AR0])));
+    return MDisp(R15, static_cast<int>((offsetof(SDSP, r.ar) + (reg - DSP_REG_AR0) * sizeof(SDSP{}.r.ar[0]))));
   case DSP_REG_IX0:
   case DSP_REG_IX1:
   case DSP_REG_IX2:
   case DSP_REG_IX3:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ix[reg - DSP_REG_IX0])));
+    return MDisp(R15, static_cast<int>((offsetof(SDSP, r.ix) + (reg - DSP_REG_IX0) * sizeof(SDSP{}.r.ix[0]))));
   case DSP_REG_WR0:
   case DSP_REG_WR1:
   case DSP_REG_WR2:
   case DSP_REG_WR3:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.wr[reg - DSP_REG_WR0])));
+    return MDisp(R15, static_cast<int>((offsetof(SDSP, r.wr) + (reg - DSP_REG_WR0) * sizeof(SDSP{}.r.wr[0]))));
   case DSP_REG_ST0:
   case DSP_REG_ST1:
   case DSP_REG_ST2:
   case DSP_REG_ST3:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.st[reg - DSP_REG_ST0])));
+    return MDisp(R15, static_cast<int>((offsetof(SDSP, r.st) + (reg - DSP_REG_ST0) * sizeof(SDSP{}.r.st[0]))));
   case DSP_REG_ACH0:
   case DSP_REG_ACH1:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ac[reg - DSP_REG_ACH0].h)));
+    return MDisp(R15, static_cast<int>((offsetof(SDSP, r.ac) + (reg - DSP_REG_ACH0) * sizeof(SDSP{}.r.ac[0]) + offsetof(std::remove_reference_t<decltype(SDSP{}.r.ac[0])>, h))));
   case DSP_REG_CR:
     return MDisp(R15, static_cast<int>(offsetof(SDSP, r.cr)));
   case DSP_REG_SR:
@@ -64,22 +64,22 @@ static Gen::OpArg GetRegisterPointer(size_t reg)
     return MDisp(R15, static_cast<int>(offsetof(SDSP, r.prod.m2)));
   case DSP_REG_AXL0:
   case DSP_REG_AXL1:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ax[reg - DSP_REG_AXL0].l)));
+    return MDisp(R15, static_cast<int>((offsetof(SDSP, r.ax) + (reg - DSP_REG_AXL0) * sizeof(SDSP{}.r.ax[0]) + offsetof(std::remove_reference_t<decltype(SDSP{}.r.ax[0])>, l))));
   case DSP_REG_AXH0:
   case DSP_REG_AXH1:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ax[reg - DSP_REG_AXH0].h)));
+    return MDisp(R15, static_cast<int>((offsetof(SDSP, r.ax) + (reg - DSP_REG_AXH0) * sizeof(SDSP{}.r.ax[0]) + offsetof(std::remove_reference_t<decltype(SDSP{}.r.ax[0])>, h))));
   case DSP_REG_ACL0:
   case DSP_REG_ACL1:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ac[reg - DSP_REG_ACL0].l)));
+    return MDisp(R15, static_cast<int>((offsetof(SDSP, r.ac) + (reg - DSP_REG_ACL0) * sizeof(SDSP{}.r.ac[0]) + offsetof(std::remove_reference_t<decltype(SDSP{}.r.ac[0])>, l))));
   case DSP_REG_ACM0:
   case DSP_REG_ACM1:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ac[reg - DSP_REG_ACM0].m)));
+    return MDisp(R15, static_cast<int>((offsetof(SDSP, r.ac) + (reg - DSP_REG_ACM0) * sizeof(SDSP{}.r.ac[0]) + offsetof(std::remove_reference_t<decltype(SDSP{}.r.ac[0])>, m))));
   case DSP_REG_AX0_32:
   case DSP_REG_AX1_32:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ax[reg - DSP_REG_AX0_32].val)));
+    return MDisp(R15, static_cast<int>((offsetof(SDSP, r.ax) + (reg - DSP_REG_AX0_32) * sizeof(SDSP{}.r.ax[0]) + offsetof(std::remove_reference_t<decltype(SDSP{}.r.ax[0])>, val))));
   case DSP_REG_ACC0_64:
   case DSP_REG_ACC1_64:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ac[reg - DSP_REG_ACC0_64].val)));
+    return MDisp(R15, static_cast<int>((offsetof(SDSP, r.ac) + (reg - DSP_REG_ACC0_64) * sizeof(SDSP{}.r.ac[0]) + offsetof(std::remove_reference_t<decltype(SDSP{}.r.ac[0])>, val))));
   case DSP_REG_PROD_64:
     return MDisp(R15, static_cast<int>(offsetof(SDSP, r.prod.val)));
   default:
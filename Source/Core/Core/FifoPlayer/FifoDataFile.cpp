@@ -5,20 +5,31 @@
 #include "Core/FifoPlayer/FifoDataFile.h"
 
 #include <algorithm>
+#include <cinttypes>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#include <zlib.h>
+
 #include "Common/File.h"
+#include "Common/Logging/Log.h"
 
+// Version 5 compresses frames and memory updates, so older loaders can't read it.
 enum
 {
   FILE_ID = 0x0d01f1f0,
-  VERSION_NUMBER = 4,
-  MIN_LOADER_VERSION = 1,
+  VERSION_NUMBER = 5,
+  MIN_LOADER_VERSION = 5,
 };
 
+// Number of frames of a compressed file which are kept in memory at once.
+constexpr size_t MAX_STREAMED_FRAMES = 16;
+
 #pragma pack(push, 1)
 
 struct FileHeader
@@ -43,6 +54,8 @@ struct FileHeader
 };
 static_assert(sizeof(FileHeader) == 128, "FileHeader should be 128 bytes");
 
+// Since version 5, fifoDataOffset points to a compressed block holding the FIFO data followed by
+// the frame's FileMemoryUpdates, and memoryUpdatesOffset is unused.
 struct FileFrameInfo
 {
   u64 fifoDataOffset;
@@ -51,10 +64,13 @@ struct FileFrameInfo
   u32 fifoEnd;
   u64 memoryUpdatesOffset;
   u32 numMemoryUpdates;
-  u8 reserved[32];
+  u32 compressedSize;
+  u8 reserved[28];
 };
 static_assert(sizeof(FileFrameInfo) == 64, "FileFrameInfo should be 64 bytes");
 
+// Since version 5, dataOffset points to the compressed size of the data as a u32, followed by the
+// compressed data. Updates with the same data share it.
 struct FileMemoryUpdate
 {
   u32 fifoPosition;
@@ -68,6 +84,32 @@ static_assert(sizeof(FileMemoryUpdate) == 24, "FileMemoryUpdate should be 24 byt
 
 #pragma pack(pop)
 
+static bool Compress(const u8* data, size_t size, std::vector<u8>& compressed)
+{
+  uLongf compressed_size = compressBound(static_cast<uLong>(size));
+  compressed.resize(compressed_size);
+  if (compress2(compressed.data(), &compressed_size, data, static_cast<uLong>(size),
+                Z_DEFAULT_COMPRESSION) != Z_OK)
+  {
+    return false;
+  }
+
+  compressed.resize(compressed_size);
+  return true;
+}
+
+static bool Decompress(const std::vector<u8>& compressed, u8* data, size_t size)
+{
+  // Older versions of zlib can't decompress into an empty buffer.
+  if (size == 0)
+    return true;
+
+  uLongf decompressed_size = static_cast<uLongf>(size);
+  return uncompress(data, &decompressed_size, compressed.data(),
+                    static_cast<uLong>(compressed.size())) == Z_OK &&
+         decompressed_size == size;
+}
+
 FifoDataFile::FifoDataFile() = default;
 
 FifoDataFile::~FifoDataFile() = default;
@@ -92,9 +134,29 @@ bool FifoDataFile::GetIsWii() const
   return GetFlag(FLAG_IS_WII);
 }
 
-void FifoDataFile::AddFrame(const FifoFrameInfo& frameInfo)
+void FifoDataFile::AddFrame(FifoFrameInfo frameInfo)
 {
-  m_Frames.push_back(frameInfo);
+  m_Frames.push_back(std::make_shared<FifoFrameInfo>(std::move(frameInfo)));
+}
+
+std::shared_ptr<const FifoFrameInfo> FifoDataFile::GetFrame(u32 frame) const
+{
+  std::lock_guard<std::mutex> lk(m_FramesLock);
+
+  std::shared_ptr<const FifoFrameInfo>& loaded_frame = m_Frames[frame];
+  if (loaded_frame || !m_StreamFile)
+    return loaded_frame;
+
+  loaded_frame = ReadCompressedFrame(m_FrameIndex[frame]);
+
+  m_StreamedFrames.push_back(frame);
+  if (m_StreamedFrames.size() > MAX_STREAMED_FRAMES)
+  {
+    m_Frames[m_StreamedFrames.front()].reset();
+    m_StreamedFrames.pop_front();
+  }
+
+  return loaded_frame;
 }
 
 bool FifoDataFile::Save(const std::string& filename)
@@ -108,7 +170,7 @@ bool FifoDataFile::Save(const std::string& filename)
 
   // Add space for frame list
   u64 frameListOffset = file.Tell();
-  PadFile(m_Frames.size() * sizeof(FileFrameInfo), file);
+  PadFile(GetFrameCount() * sizeof(FileFrameInfo), file);
 
   u64 bpMemOffset = file.Tell();
   file.WriteArray(m_BPMem, BP_MEM_SIZE);
@@ -147,37 +209,96 @@ bool FifoDataFile::Save(const std::string& filename)
   header.texMemSize = TEX_MEM_SIZE;
 
   header.frameListOffset = frameListOffset;
-  header.frameCount = (u32)m_Frames.size();
+  header.frameCount = GetFrameCount();
 
   header.flags = m_Flags;
 
   file.Seek(0, SEEK_SET);
   file.WriteBytes(&header, sizeof(FileHeader));
 
+  // Memory updates with the same data only have it written once. The frames holding the first
+  // copy of each are kept alive so that the data can be compared.
+  struct WrittenMemory
+  {
+    const std::vector<u8>* data;
+    u64 offset;
+  };
+  std::unordered_multimap<size_t, WrittenMemory> written_memory;
+  std::vector<std::shared_ptr<const FifoFrameInfo>> written_memory_frames;
+
+  std::vector<u8> block;
+  std::vector<u8> compressed;
+
   // Write frames list
-  for (unsigned int i = 0; i < m_Frames.size(); ++i)
+  file.Seek(0, SEEK_END);
+  for (u32 i = 0; i < GetFrameCount(); ++i)
   {
-    const FifoFrameInfo& srcFrame = m_Frames[i];
+    const std::shared_ptr<const FifoFrameInfo> srcFrame = GetFrame(i);
+    bool frame_has_new_memory = false;
+
+    // The frame's memory update list is stored after the FIFO data.
+    block.assign(srcFrame->fifoData.begin(), srcFrame->fifoData.end());
+    for (const MemoryUpdate& srcUpdate : srcFrame->memoryUpdates)
+    {
+      const size_t hash = std::hash<std::string_view>()(std::string_view(
+          reinterpret_cast<const char*>(srcUpdate.data.data()), srcUpdate.data.size()));
+      const auto range = written_memory.equal_range(hash);
+      const auto existing = std::find_if(range.first, range.second, [&srcUpdate](const auto& entry) {
+        return *entry.second.data == srcUpdate.data;
+      });
+
+      u64 dataOffset;
+      if (existing != range.second)
+      {
+        dataOffset = existing->second.offset;
+      }
+      else
+      {
+        if (!Compress(srcUpdate.data.data(), srcUpdate.data.size(), compressed))
+          return false;
+
+        dataOffset = file.Tell();
+        const u32 compressedSize = static_cast<u32>(compressed.size());
+        file.WriteBytes(&compressedSize, sizeof(compressedSize));
+        file.WriteBytes(compressed.data(), compressed.size());
+
+        written_memory.emplace(hash, WrittenMemory{&srcUpdate.data, dataOffset});
+        frame_has_new_memory = true;
+      }
+
+      FileMemoryUpdate dstUpdate = {};
+      dstUpdate.address = srcUpdate.address;
+      dstUpdate.dataOffset = dataOffset;
+      dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
+      dstUpdate.fifoPosition = srcUpdate.fifoPosition;
+      dstUpdate.type = srcUpdate.type;
+
+      const u8* dstUpdateBytes = reinterpret_cast<const u8*>(&dstUpdate);
+      block.insert(block.end(), dstUpdateBytes, dstUpdateBytes + sizeof(FileMemoryUpdate));
+    }
+
+    if (frame_has_new_memory)
+      written_memory_frames.push_back(srcFrame);
+
+    if (!Compress(block.data(), block.size(), compressed))
+      return false;
 
-    // Write FIFO data
-    file.Seek(0, SEEK_END);
     u64 dataOffset = file.Tell();
-    file.WriteBytes(srcFrame.fifoData.data(), srcFrame.fifoData.size());
+    file.WriteBytes(compressed.data(), compressed.size());
 
-    u64 memoryUpdatesOffset = WriteMemoryUpdates(srcFrame.memoryUpdates, file);
-
-    FileFrameInfo dstFrame;
-    dstFrame.fifoDataSize = static_cast<u32>(srcFrame.fifoData.size());
+    FileFrameInfo dstFrame = {};
+    dstFrame.fifoDataSize = static_cast<u32>(srcFrame->fifoData.size());
     dstFrame.fifoDataOffset = dataOffset;
-    dstFrame.fifoStart = srcFrame.fifoStart;
-    dstFrame.fifoEnd = srcFrame.fifoEnd;
-    dstFrame.memoryUpdatesOffset = memoryUpdatesOffset;
-    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame.memoryUpdates.size());
+    dstFrame.fifoStart = srcFrame->fifoStart;
+    dstFrame.fifoEnd = srcFrame->fifoEnd;
+    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame->memoryUpdates.size());
+    dstFrame.compressedSize = static_cast<u32>(compressed.size());
 
     // Write frame info
     u64 frameOffset = frameListOffset + (i * sizeof(FileFrameInfo));
     file.Seek(frameOffset, SEEK_SET);
     file.WriteBytes(&dstFrame, sizeof(FileFrameInfo));
+    file.Seek(0, SEEK_END);
   }
 
   if (!file.Close())
@@ -238,6 +359,19 @@ std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bo
     file.ReadArray(dataFile->m_TexMem, size);
   }
 
+  // Frames of compressed files are only read when they are used.
+  if (dataFile->m_Version >= 5)
+  {
+    dataFile->m_FrameIndex.resize(header.frameCount);
+    file.Seek(header.frameListOffset, SEEK_SET);
+    if (!file.ReadArray(dataFile->m_FrameIndex.data(), header.frameCount))
+      return nullptr;
+
+    dataFile->m_Frames.resize(header.frameCount);
+    dataFile->m_StreamFile = std::make_unique<File::IOFile>(std::move(file));
+    return dataFile;
+  }
+
   // Read frames
   for (u32 i = 0; i < header.frameCount; ++i)
   {
@@ -257,7 +391,7 @@ std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bo
     ReadMemoryUpdates(srcFrame.memoryUpdatesOffset, srcFrame.numMemoryUpdates,
                       dstFrame.memoryUpdates, file);
 
-    dataFile->AddFrame(dstFrame);
+    dataFile->AddFrame(std::move(dstFrame));
   }
 
   file.Close();
@@ -284,37 +418,6 @@ bool FifoDataFile::GetFlag(u32 flag) const
   return !!(m_Flags & flag);
 }
 
-u64 FifoDataFile::WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates,
-                                     File::IOFile& file)
-{
-  // Add space for memory update list
-  u64 updateListOffset = file.Tell();
-  PadFile(memUpdates.size() * sizeof(FileMemoryUpdate), file);
-
-  for (unsigned int i = 0; i < memUpdates.size(); ++i)
-  {
-    const MemoryUpdate& srcUpdate = memUpdates[i];
-
-    // Write memory
-    file.Seek(0, SEEK_END);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcUpdate.data.data(), srcUpdate.data.size());
-
-    FileMemoryUpdate dstUpdate;
-    dstUpdate.address = srcUpdate.address;
-    dstUpdate.dataOffset = dataOffset;
-    dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
-    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
-    dstUpdate.type = srcUpdate.type;
-
-    u64 updateOffset = updateListOffset + (i * sizeof(FileMemoryUpdate));
-    file.Seek(updateOffset, SEEK_SET);
-    file.WriteBytes(&dstUpdate, sizeof(FileMemoryUpdate));
-  }
-
-  return updateListOffset;
-}
-
 void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
                                      std::vector<MemoryUpdate>& memUpdates, File::IOFile& file)
 {
@@ -337,3 +440,61 @@ void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
     file.ReadBytes(dstUpdate.data.data(), srcUpdate.dataSize);
   }
 }
+
+std::shared_ptr<const FifoFrameInfo>
+FifoDataFile::ReadCompressedFrame(const FileFrameInfo& info) const
+{
+  auto frame = std::make_shared<FifoFrameInfo>();
+  frame->fifoStart = info.fifoStart;
+  frame->fifoEnd = info.fifoEnd;
+
+  std::vector<u8> compressed(info.compressedSize);
+  std::vector<u8> block(info.fifoDataSize + info.numMemoryUpdates * sizeof(FileMemoryUpdate));
+  if (!m_StreamFile->Seek(info.fifoDataOffset, SEEK_SET) ||
+      !m_StreamFile->ReadBytes(compressed.data(), compressed.size()) ||
+      !Decompress(compressed, block.data(), block.size()))
+  {
+    ERROR_LOG(CORE, "Failed to read FIFO log frame at offset %" PRIx64, info.fifoDataOffset);
+    m_StreamFile->Clear();
+    return frame;
+  }
+
+  frame->fifoData.assign(block.begin(), block.begin() + info.fifoDataSize);
+
+  frame->memoryUpdates.resize(info.numMemoryUpdates);
+  for (u32 i = 0; i < info.numMemoryUpdates; ++i)
+  {
+    FileMemoryUpdate srcUpdate;
+    std::memcpy(&srcUpdate, &block[info.fifoDataSize + i * sizeof(FileMemoryUpdate)],
+                sizeof(FileMemoryUpdate));
+
+    MemoryUpdate& dstUpdate = frame->memoryUpdates[i];
+    dstUpdate.address = srcUpdate.address;
+    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
+    dstUpdate.data.resize(srcUpdate.dataSize);
+    dstUpdate.type = static_cast<MemoryUpdate::Type>(srcUpdate.type);
+
+    if (!ReadCompressedMemory(srcUpdate.dataOffset, dstUpdate.data))
+    {
+      ERROR_LOG(CORE, "Failed to read FIFO log memory update at offset %" PRIx64,
+                srcUpdate.dataOffset);
+      m_StreamFile->Clear();
+    }
+  }
+
+  return frame;
+}
+
+bool FifoDataFile::ReadCompressedMemory(u64 offset, std::vector<u8>& data) const
+{
+  u32 compressedSize;
+  if (!m_StreamFile->Seek(offset, SEEK_SET) ||
+      !m_StreamFile->ReadBytes(&compressedSize, sizeof(compressedSize)))
+  {
+    return false;
+  }
+
+  std::vector<u8> compressed(compressedSize);
+  return m_StreamFile->ReadBytes(compressed.data(), compressed.size()) &&
+         Decompress(compressed, data.data(), data.size());
+}
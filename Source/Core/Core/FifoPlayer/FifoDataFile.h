@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -16,6 +18,8 @@ namespace File
 class IOFile;
 }
 
+struct FileFrameInfo;
+
 struct MemoryUpdate
 {
   enum Type
@@ -69,8 +73,10 @@ public:
   u32* GetXFMem() { return m_XFMem; }
   u32* GetXFRegs() { return m_XFRegs; }
   u8* GetTexMem() { return m_TexMem; }
-  void AddFrame(const FifoFrameInfo& frameInfo);
-  const FifoFrameInfo& GetFrame(u32 frame) const { return m_Frames[frame]; }
+  void AddFrame(FifoFrameInfo frameInfo);
+  // Frames of compressed files are read from the file when they are needed, and only the most
+  // recently used ones are kept in memory. Hold on to the returned pointer while using the frame.
+  std::shared_ptr<const FifoFrameInfo> GetFrame(u32 frame) const;
   u32 GetFrameCount() const { return static_cast<u32>(m_Frames.size()); }
   bool Save(const std::string& filename);
 
@@ -87,9 +93,10 @@ private:
   void SetFlag(u32 flag, bool set);
   bool GetFlag(u32 flag) const;
 
-  u64 WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
   static void ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
                                 std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
+  std::shared_ptr<const FifoFrameInfo> ReadCompressedFrame(const FileFrameInfo& info) const;
+  bool ReadCompressedMemory(u64 offset, std::vector<u8>& data) const;
 
   u32 m_BPMem[BP_MEM_SIZE];
   u32 m_CPMem[CP_MEM_SIZE];
@@ -100,5 +107,12 @@ private:
   u32 m_Flags = 0;
   u32 m_Version = 0;
 
-  std::vector<FifoFrameInfo> m_Frames;
+  // Only used for compressed files, which are kept open to read frames from.
+  std::unique_ptr<File::IOFile> m_StreamFile;
+  std::vector<FileFrameInfo> m_FrameIndex;
+
+  // Entries of frames which have been evicted from memory are null.
+  mutable std::vector<std::shared_ptr<const FifoFrameInfo>> m_Frames;
+  mutable std::deque<u32> m_StreamedFrames;
+  mutable std::mutex m_FramesLock;
 };
@@ -21,82 +21,78 @@ struct CmdData
   const u8* ptr;
 };
 
-void FifoPlaybackAnalyzer::AnalyzeFrames(FifoDataFile* file,
-                                         std::vector<AnalyzedFrameInfo>& frameInfo)
+FifoPlaybackAnalyzer::State FifoPlaybackAnalyzer::GetInitialState(FifoDataFile* file)
 {
-  u32* cpMem = file->GetCPMem();
-  FifoAnalyzer::LoadCPReg(0x50, cpMem[0x50], s_CpMem);
-  FifoAnalyzer::LoadCPReg(0x60, cpMem[0x60], s_CpMem);
+  State state{};
+  const u32* cpMem = file->GetCPMem();
+  FifoAnalyzer::LoadCPReg(0x50, cpMem[0x50], state.cpMem);
+  FifoAnalyzer::LoadCPReg(0x60, cpMem[0x60], state.cpMem);
 
   for (int i = 0; i < 8; ++i)
   {
-    FifoAnalyzer::LoadCPReg(0x70 + i, cpMem[0x70 + i], s_CpMem);
-    FifoAnalyzer::LoadCPReg(0x80 + i, cpMem[0x80 + i], s_CpMem);
-    FifoAnalyzer::LoadCPReg(0x90 + i, cpMem[0x90 + i], s_CpMem);
+    FifoAnalyzer::LoadCPReg(0x70 + i, cpMem[0x70 + i], state.cpMem);
+    FifoAnalyzer::LoadCPReg(0x80 + i, cpMem[0x80 + i], state.cpMem);
+    FifoAnalyzer::LoadCPReg(0x90 + i, cpMem[0x90 + i], state.cpMem);
   }
 
-  frameInfo.clear();
-  frameInfo.resize(file->GetFrameCount());
+  return state;
+}
 
-  for (u32 frameIdx = 0; frameIdx < file->GetFrameCount(); ++frameIdx)
-  {
-    const FifoFrameInfo& frame = file->GetFrame(frameIdx);
-    AnalyzedFrameInfo& analyzed = frameInfo[frameIdx];
+void FifoPlaybackAnalyzer::AnalyzeFrame(const FifoFrameInfo& frame, State& state,
+                                        AnalyzedFrameInfo& analyzed)
+{
+  // Frames after one which couldn't be analyzed are left empty.
+  if (state.failed)
+    return;
 
-    s_DrawingObject = false;
+  s_CpMem = state.cpMem;
+  s_DrawingObject = false;
 
-    u32 cmdStart = 0;
-    u32 nextMemUpdate = 0;
+  u32 cmdStart = 0;
 
 #if LOG_FIFO_CMDS
-    // Debugging
-    std::vector<CmdData> prevCmds;
+  // Debugging
+  std::vector<CmdData> prevCmds;
 #endif
 
-    while (cmdStart < frame.fifoData.size())
-    {
-      // Add memory updates that have occurred before this point in the frame
-      while (nextMemUpdate < frame.memoryUpdates.size() &&
-             frame.memoryUpdates[nextMemUpdate].fifoPosition <= cmdStart)
-      {
-        analyzed.memoryUpdates.push_back(frame.memoryUpdates[nextMemUpdate]);
-        ++nextMemUpdate;
-      }
-
-      const bool wasDrawing = s_DrawingObject;
-      const u32 cmdSize =
-          FifoAnalyzer::AnalyzeCommand(&frame.fifoData[cmdStart], DecodeMode::Playback);
+  while (cmdStart < frame.fifoData.size())
+  {
+    const bool wasDrawing = s_DrawingObject;
+    const u32 cmdSize =
+        FifoAnalyzer::AnalyzeCommand(&frame.fifoData[cmdStart], DecodeMode::Playback);
 
 #if LOG_FIFO_CMDS
-      CmdData cmdData;
-      cmdData.offset = cmdStart;
-      cmdData.ptr = &frame.fifoData[cmdStart];
-      cmdData.size = cmdSize;
-      prevCmds.push_back(cmdData);
+    CmdData cmdData;
+    cmdData.offset = cmdStart;
+    cmdData.ptr = &frame.fifoData[cmdStart];
+    cmdData.size = cmdSize;
+    prevCmds.push_back(cmdData);
 #endif
 
-      // Check for error
-      if (cmdSize == 0)
-      {
-        // Clean up frame analysis
-        analyzed.objectStarts.clear();
-        analyzed.objectEnds.clear();
-
-        return;
-      }
-
-      if (wasDrawing != s_DrawingObject)
-      {
-        if (s_DrawingObject)
-          analyzed.objectStarts.push_back(cmdStart);
-        else
-          analyzed.objectEnds.push_back(cmdStart);
-      }
-
-      cmdStart += cmdSize;
+    // Check for error
+    if (cmdSize == 0)
+    {
+      // Clean up frame analysis
+      analyzed.objectStarts.clear();
+      analyzed.objectEnds.clear();
+
+      state.failed = true;
+      return;
+    }
+
+    if (wasDrawing != s_DrawingObject)
+    {
+      if (s_DrawingObject)
+        analyzed.objectStarts.push_back(cmdStart);
+      else
+        analyzed.objectEnds.push_back(cmdStart);
     }
 
-    if (analyzed.objectEnds.size() < analyzed.objectStarts.size())
-      analyzed.objectEnds.push_back(cmdStart);
+    cmdStart += cmdSize;
   }
+
+  if (analyzed.objectEnds.size() < analyzed.objectStarts.size())
+    analyzed.objectEnds.push_back(cmdStart);
+
+  state.cpMem = s_CpMem;
 }
@@ -7,16 +7,24 @@
 #include <string>
 #include <vector>
 
+#include "Core/FifoPlayer/FifoAnalyzer.h"
 #include "Core/FifoPlayer/FifoDataFile.h"
 
 struct AnalyzedFrameInfo
 {
   std::vector<u32> objectStarts;
   std::vector<u32> objectEnds;
-  std::vector<MemoryUpdate> memoryUpdates;
 };
 
 namespace FifoPlaybackAnalyzer
 {
-void AnalyzeFrames(FifoDataFile* file, std::vector<AnalyzedFrameInfo>& frameInfo);
+// What the analysis of a frame leaves for the next one. Frames must be analyzed in order.
+struct State
+{
+  FifoAnalyzer::CPMemory cpMem;
+  bool failed = false;
+};
+
+State GetInitialState(FifoDataFile* file);
+void AnalyzeFrame(const FifoFrameInfo& frame, State& state, AnalyzedFrameInfo& analyzed);
 }  // namespace FifoPlaybackAnalyzer
@@ -49,7 +49,10 @@ bool FifoPlayer::Open(const std::string& filename)
 
   if (m_File)
   {
-    FifoPlaybackAnalyzer::AnalyzeFrames(m_File.get(), m_FrameInfo);
+    std::lock_guard<std::mutex> lk(m_AnalyzerLock);
+    m_FrameInfo.resize(m_File->GetFrameCount());
+    m_AnalyzedFrameCount = 0;
+    m_AnalyzerState = FifoPlaybackAnalyzer::GetInitialState(m_File.get());
 
     m_FrameRangeEnd = m_File->GetFrameCount();
   }
@@ -62,6 +65,11 @@ bool FifoPlayer::Open(const std::string& filename)
 
 void FifoPlayer::Close()
 {
+  {
+    std::lock_guard<std::mutex> lk(m_AnalyzerLock);
+    m_FrameInfo.clear();
+    m_AnalyzedFrameCount = 0;
+  }
   m_File.reset();
 
   m_FrameRangeStart = 0;
@@ -154,7 +162,7 @@ CPU::State FifoPlayer::AdvanceFrame()
   if (m_EarlyMemoryUpdates && m_CurrentFrame == m_FrameRangeStart)
     WriteAllMemoryUpdates();
 
-  WriteFrame(m_File->GetFrame(m_CurrentFrame), m_FrameInfo[m_CurrentFrame]);
+  WriteFrame(*m_File->GetFrame(m_CurrentFrame), GetAnalyzedFrameInfo(m_CurrentFrame));
 
   ++m_CurrentFrame;
   return CPU::State::Running;
@@ -189,11 +197,28 @@ bool FifoPlayer::IsRunningWithFakeVideoInterfaceUpdates() const
   return m_File->ShouldGenerateFakeVIUpdates();
 }
 
+const AnalyzedFrameInfo& FifoPlayer::GetAnalyzedFrameInfo(u32 frame) const
+{
+  std::lock_guard<std::mutex> lk(m_AnalyzerLock);
+
+  // Each frame is analyzed with the CP state the frames before it left, and only the results are
+  // kept, so frames of compressed files are still only read from the file one at a time.
+  while (m_AnalyzedFrameCount <= frame)
+  {
+    const std::shared_ptr<const FifoFrameInfo> frame_ptr = m_File->GetFrame(m_AnalyzedFrameCount);
+    FifoPlaybackAnalyzer::AnalyzeFrame(*frame_ptr, m_AnalyzerState,
+                                       m_FrameInfo[m_AnalyzedFrameCount]);
+    ++m_AnalyzedFrameCount;
+  }
+
+  return m_FrameInfo[frame];
+}
+
 u32 FifoPlayer::GetFrameObjectCount() const
 {
-  if (m_CurrentFrame < m_FrameInfo.size())
+  if (m_File && m_CurrentFrame < m_File->GetFrameCount())
   {
-    return (u32)(m_FrameInfo[m_CurrentFrame].objectStarts.size());
+    return (u32)(GetAnalyzedFrameInfo(m_CurrentFrame).objectStarts.size());
   }
 
   return 0;
@@ -267,7 +292,7 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
     // Write fifo data skipping objects before the draw range
     while (objectNum < drawStart)
     {
-      WriteFramePart(position, info.objectStarts[objectNum], memoryUpdate, frame, info);
+      WriteFramePart(position, info.objectStarts[objectNum], memoryUpdate, frame);
 
       position = info.objectEnds[objectNum];
       ++objectNum;
@@ -277,7 +302,7 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
     if (objectNum < numObjects && drawStart <= drawEnd)
     {
       objectNum = drawEnd;
-      WriteFramePart(position, info.objectEnds[objectNum], memoryUpdate, frame, info);
+      WriteFramePart(position, info.objectEnds[objectNum], memoryUpdate, frame);
       position = info.objectEnds[objectNum];
       ++objectNum;
     }
@@ -285,7 +310,7 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
     // Write fifo data skipping objects after the draw range
     while (objectNum < numObjects)
     {
-      WriteFramePart(position, info.objectStarts[objectNum], memoryUpdate, frame, info);
+      WriteFramePart(position, info.objectStarts[objectNum], memoryUpdate, frame);
 
       position = info.objectEnds[objectNum];
       ++objectNum;
@@ -293,7 +318,7 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
   }
 
   // Write data after the last object
-  WriteFramePart(position, static_cast<u32>(frame.fifoData.size()), memoryUpdate, frame, info);
+  WriteFramePart(position, static_cast<u32>(frame.fifoData.size()), memoryUpdate, frame);
 
   FlushWGP();
 
@@ -306,13 +331,13 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
 }
 
 void FifoPlayer::WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate,
-                                const FifoFrameInfo& frame, const AnalyzedFrameInfo& info)
+                                const FifoFrameInfo& frame)
 {
   const u8* const data = frame.fifoData.data();
 
   while (nextMemUpdate < frame.memoryUpdates.size() && dataStart < dataEnd)
   {
-    const MemoryUpdate& memUpdate = info.memoryUpdates[nextMemUpdate];
+    const MemoryUpdate& memUpdate = frame.memoryUpdates[nextMemUpdate];
 
     if (memUpdate.fifoPosition < dataEnd)
     {
@@ -341,10 +366,12 @@ void FifoPlayer::WriteAllMemoryUpdates()
 {
   ASSERT(m_File);
 
+  // This needs the memory of every frame before the first one is played, but frames are still
+  // read one at a time and aren't kept.
   for (u32 frameNum = 0; frameNum < m_File->GetFrameCount(); ++frameNum)
   {
-    const FifoFrameInfo& frame = m_File->GetFrame(frameNum);
-    for (auto& update : frame.memoryUpdates)
+    const std::shared_ptr<const FifoFrameInfo> frame = m_File->GetFrame(frameNum);
+    for (auto& update : frame->memoryUpdates)
     {
       WriteMemory(update);
     }
@@ -399,7 +426,8 @@ void FifoPlayer::SetupFifo()
   WriteCP(CommandProcessor::CTRL_REGISTER, 0);   // disable read, BP, interrupts
   WriteCP(CommandProcessor::CLEAR_REGISTER, 7);  // clear overflow, underflow, metrics
 
-  const FifoFrameInfo& frame = m_File->GetFrame(m_CurrentFrame);
+  const std::shared_ptr<const FifoFrameInfo> frame_ptr = m_File->GetFrame(m_CurrentFrame);
+  const FifoFrameInfo& frame = *frame_ptr;
 
   // Set fifo bounds
   WriteCP(CommandProcessor::FIFO_BASE_LO, frame.fifoStart);
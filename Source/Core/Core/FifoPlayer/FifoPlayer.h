@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -76,7 +77,8 @@ public:
   FifoDataFile* GetFile() const { return m_File.get(); }
   u32 GetFrameObjectCount() const;
   u32 GetCurrentFrameNum() const { return m_CurrentFrame; }
-  const AnalyzedFrameInfo& GetAnalyzedFrameInfo(u32 frame) const { return m_FrameInfo[frame]; }
+  // Frames are analyzed the first time they are needed, along with the ones before them.
+  const AnalyzedFrameInfo& GetAnalyzedFrameInfo(u32 frame) const;
   // Frame range
   u32 GetFrameRangeStart() const { return m_FrameRangeStart; }
   void SetFrameRangeStart(u32 start);
@@ -107,8 +109,7 @@ private:
   CPU::State AdvanceFrame();
 
   void WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo& info);
-  void WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate, const FifoFrameInfo& frame,
-                      const AnalyzedFrameInfo& info);
+  void WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate, const FifoFrameInfo& frame);
 
   void WriteAllMemoryUpdates();
   void WriteMemory(const MemoryUpdate& memUpdate);
@@ -158,5 +159,9 @@ private:
 
   std::unique_ptr<FifoDataFile> m_File;
 
-  std::vector<AnalyzedFrameInfo> m_FrameInfo;
+  // Only the first m_AnalyzedFrameCount entries are filled.
+  mutable std::vector<AnalyzedFrameInfo> m_FrameInfo;
+  mutable u32 m_AnalyzedFrameCount = 0;
+  mutable FifoPlaybackAnalyzer::State m_AnalyzerState;
+  mutable std::mutex m_AnalyzerLock;
 };
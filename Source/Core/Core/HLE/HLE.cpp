@@ -8,16 +8,23 @@
 #include <array>
 #include <map>
 
+#include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
 
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/GeckoCode.h"
 #include "Core/HLE/HLE_Misc.h"
+#include "Core/HLE/HLE_Native.h"
 #include "Core/HLE/HLE_OS.h"
 #include "Core/HW/Memmap.h"
 #include "Core/IOS/ES/ES.h"
+#include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/SignatureDB/SignatureDB.h"
 
 namespace HLE
 {
@@ -42,7 +49,7 @@ struct SPatch
 };
 
 // clang-format off
-constexpr std::array<SPatch, 21> OSPatches{{
+constexpr std::array<SPatch, 26> OSPatches{{
     // Placeholder, OSPatches[0] is the "non-existent function" index
     {"FAKE_TO_SKIP_0",               HLE_Misc::UnimplementedFunction,       HookType::Replace, HookFlag::Generic},
 
@@ -70,6 +77,13 @@ constexpr std::array<SPatch, 21> OSPatches{{
     {"___blank",                     HLE_OS::HLE_GeneralDebugPrint,         HookType::Start,   HookFlag::Debug}, // used for early init things (normally)
     {"__write_console",              HLE_OS::HLE_write_console,             HookType::Start,   HookFlag::Debug}, // used by sysmenu (+more?)
 
+    // Hot leaf functions, which are also looked up in the signature database
+    {"memcpy",                       HLE_Native::Memcpy,                    HookType::Conditional, HookFlag::Native},
+    {"__fill_mem",                   HLE_Native::FillMem,                   HookType::Conditional, HookFlag::Native}, // memset without the return value
+    {"DCFlushRange",                 HLE_Native::DCFlushRange,              HookType::Conditional, HookFlag::Native},
+    {"DCStoreRange",                 HLE_Native::DCStoreRange,              HookType::Conditional, HookFlag::Native},
+    {"DCInvalidateRange",            HLE_Native::DCInvalidateRange,         HookType::Conditional, HookFlag::Native},
+
     {"GeckoCodehandler",             HLE_Misc::GeckoCodeHandlerICacheFlush, HookType::Start,   HookFlag::Fixed},
     {"GeckoHandlerReturnTrampoline", HLE_Misc::GeckoReturnTrampoline,       HookType::Replace, HookFlag::Fixed},
     {"AppLoaderReport",              HLE_OS::HLE_GeneralDebugPrint,         HookType::Replace, HookFlag::Fixed} // apploader needs OSReport-like function
@@ -111,6 +125,40 @@ void PatchFixedFunctions()
   Patch(Gecko::HLE_TRAMPOLINE_ADDRESS, "GeckoHandlerReturnTrampoline");
 }
 
+// Adds the native functions to the symbols if they can be found through their signatures. Only
+// leaf functions are added, as the guest code can't be trusted to be the usual function otherwise.
+static void FindNativeFunctions()
+{
+  SignatureDB db(SignatureDB::HandlerType::DSY);
+  if (!db.Load(File::GetSysDirectory() + TOTALDB))
+    return;
+
+  PPCSymbolDB found_functions;
+  PPCAnalyst::FindFunctions(0x80000000, 0x81800000, &found_functions);
+  db.Apply(&found_functions);
+
+  bool added = false;
+  for (const SPatch& patch : OSPatches)
+  {
+    if (patch.flags != HookFlag::Native)
+      continue;
+
+    for (const auto& symbol : found_functions.GetSymbolsFromName(patch.m_szPatchName))
+    {
+      const Common::Symbol* const existing = g_symbolDB.GetSymbolFromAddr(symbol->address);
+      if (!(symbol->flags & Common::FFLAG_LEAF) ||
+          (existing && existing->address == symbol->address))
+      {
+        continue;
+      }
+      g_symbolDB.AddKnownSymbol(symbol->address, symbol->size, symbol->name);
+      added = true;
+    }
+  }
+  if (added)
+    g_symbolDB.Index();
+}
+
 void PatchFunctions()
 {
   // Remove all hooks that aren't fixed address hooks
@@ -127,12 +175,19 @@ void PatchFunctions()
     }
   }
 
+  const bool native_functions = Config::Get(Config::MAIN_HLE_NATIVE_FUNCTIONS);
+  if (native_functions)
+    FindNativeFunctions();
+
   for (u32 i = 1; i < OSPatches.size(); ++i)
   {
     // Fixed hooks don't map to symbols
     if (OSPatches[i].flags == HookFlag::Fixed)
       continue;
 
+    if (OSPatches[i].flags == HookFlag::Native && !native_functions)
+      continue;
+
     for (const auto& symbol : g_symbolDB.GetSymbolsFromName(OSPatches[i].m_szPatchName))
     {
       for (u32 addr = symbol->address; addr < symbol->address + symbol->size; addr += 4)
@@ -162,6 +217,7 @@ void PatchFunctions()
 void Clear()
 {
   s_original_instructions.clear();
+  HLE_Native::ResetStats();
 }
 
 void Reload()
@@ -176,6 +232,8 @@ void Execute(u32 _CurrentPC, u32 _Instruction)
   unsigned int FunctionIndex = _Instruction & 0xFFFFF;
   if (FunctionIndex > 0 && FunctionIndex < OSPatches.size())
   {
+    if (OSPatches[FunctionIndex].type == HookType::Conditional)
+      NPC = _CurrentPC;
     OSPatches[FunctionIndex].PatchFunction();
   }
   else
@@ -213,6 +271,9 @@ HookFlag GetFunctionFlagsByIndex(u32 index)
 
 bool IsEnabled(HookFlag flag)
 {
+  if (flag == HLE::HookFlag::Native)
+    return Config::Get(Config::MAIN_HLE_NATIVE_FUNCTIONS);
+
   return flag != HLE::HookFlag::Debug || SConfig::GetInstance().bEnableDebugging ||
          PowerPC::GetMode() == PowerPC::CoreMode::Interpreter;
 }
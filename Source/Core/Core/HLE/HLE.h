@@ -14,7 +14,10 @@ enum class HookType
 {
   Start,    // Hook the beginning of the function and execute the function afterwards
   Replace,  // Replace the function with the HLE version
-  None,     // Do not hook the function
+  // Replace the function with the HLE version if it handled the call. Otherwise, the HLE version
+  // leaves NPC at the start of the function and the function is executed as usual.
+  Conditional,
+  None,  // Do not hook the function
 };
 
 enum class HookFlag
@@ -22,6 +25,7 @@ enum class HookFlag
   Generic,  // Miscellaneous function
   Debug,    // Debug output function
   Fixed,    // An arbitrary hook mapped to a fixed address instead of a symbol
+  Native,   // Native version of a hot leaf function, see Config::MAIN_HLE_NATIVE_FUNCTIONS
 };
 
 void PatchFixedFunctions();
@@ -62,7 +66,7 @@ bool ReplaceFunctionIfPossible(u32 address, FunctionObject fn)
     return false;
 
   const HookType type = GetFunctionTypeByIndex(function);
-  if (type != HookType::Start && type != HookType::Replace)
+  if (type == HookType::None)
     return false;
 
   const HookFlag flags = GetFunctionFlagsByIndex(function);
@@ -0,0 +1,190 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/HLE/HLE_Native.h"
+
+#include <array>
+#include <cstring>
+
+#include "Common/CommonTypes.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+
+namespace HLE_Native
+{
+enum class Function
+{
+  Memcpy,
+  FillMem,
+  DCFlushRange,
+  DCStoreRange,
+  DCInvalidateRange,
+  NumFunctions,
+};
+
+static std::array<Profiler::HLEFunctionStat, static_cast<size_t>(Function::NumFunctions)> s_stats{{
+    {"memcpy", 0, 0},
+    {"__fill_mem", 0, 0},
+    {"DCFlushRange", 0, 0},
+    {"DCStoreRange", 0, 0},
+    {"DCInvalidateRange", 0, 0},
+}};
+
+constexpr u32 INSTRUCTION_SC = 0x44000002;
+constexpr u32 INSTRUCTION_BLR = 0x4e800020;
+constexpr u32 MAX_FUNCTION_SIZE = 0x100;
+
+static void Return(Function function)
+{
+  NPC = LR;
+  s_stats[static_cast<size_t>(function)].hits++;
+}
+
+static void RunGuestCode(Function function)
+{
+  s_stats[static_cast<size_t>(function)].misses++;
+}
+
+u8* GetBATPagePointer(u32 address)
+{
+  if (!PowerPC::IsOptimizableRAMAddress(address))
+    return nullptr;
+
+  PowerPC::TranslateBatAddess(PowerPC::dbat_table, &address);
+  // The locked L1 cache and the fake VMEM are accessed directly too, but don't need to be handled.
+  if (address < Memory::REALRAM_SIZE ||
+      (Memory::m_pEXRAM && address >> 28 == 0x1 && (address & 0x0FFFFFFF) < Memory::EXRAM_SIZE))
+  {
+    return Memory::GetPointer(address);
+  }
+  return nullptr;
+}
+
+u8* GetRAMPointer(u32 address, u32 size)
+{
+  const u32 last = address + (size - 1);
+  if (last < address)
+    return nullptr;
+
+  u8* const pointer = GetBATPagePointer(address);
+  for (u32 page = (address >> PowerPC::BAT_INDEX_SHIFT) + 1;
+       pointer && page <= last >> PowerPC::BAT_INDEX_SHIFT; page++)
+  {
+    const u32 page_address = page << PowerPC::BAT_INDEX_SHIFT;
+    if (GetBATPagePointer(page_address) != pointer + (page_address - address))
+      return nullptr;
+  }
+  return pointer;
+}
+
+void Memcpy()
+{
+  const u32 dst = GPR(3);
+  const u32 src = GPR(4);
+  const u32 size = GPR(5);
+  if (size != 0)
+  {
+    u8* const dst_pointer = GetRAMPointer(dst, size);
+    const u8* const src_pointer = GetRAMPointer(src, size);
+    // The implementations don't agree on what happens when the ranges overlap.
+    if (!dst_pointer || !src_pointer ||
+        (dst_pointer < src_pointer + size && src_pointer < dst_pointer + size))
+    {
+      RunGuestCode(Function::Memcpy);
+      return;
+    }
+    std::memcpy(dst_pointer, src_pointer, size);
+  }
+  Return(Function::Memcpy);
+}
+
+void FillMem()
+{
+  const u32 dst = GPR(3);
+  const u8 value = static_cast<u8>(GPR(4));
+  const u32 size = GPR(5);
+  if (size != 0)
+  {
+    u8* const dst_pointer = GetRAMPointer(dst, size);
+    if (!dst_pointer)
+    {
+      RunGuestCode(Function::FillMem);
+      return;
+    }
+    std::memset(dst_pointer, value, size);
+  }
+  Return(Function::FillMem);
+}
+
+// Does what the guest code does with each cache line from r3 to r3 + r4 for the dcbf, dcbst and
+// dcbi instructions, which all invalidate the JIT cache there. The functions start at NPC, and
+// continue at the system call they end with, if any, which lets the OS synchronize the memory.
+static void CacheRange(Function function)
+{
+  const u32 start = NPC;
+  const u32 address = GPR(3);
+  const u32 size = GPR(4);
+  if (size != 0)
+  {
+    // The line count is computed like the guest code does it, overflow included. It adds a whole
+    // line to the size when the start isn't aligned, so one line too many may be touched.
+    const u32 lines = (size + ((address & 0x1f) ? 0x20 : 0) + 0x1f) >> 5;
+    if (lines == 0)
+    {
+      RunGuestCode(function);
+      return;
+    }
+    for (u32 i = 0; i < lines; i++)
+      JitInterface::InvalidateICache((address & ~0x1f) + i * 32, 32, false);
+
+    for (u32 pc = start; pc < start + MAX_FUNCTION_SIZE; pc += 4)
+    {
+      const PowerPC::TryReadInstResult inst = PowerPC::TryReadInstruction(pc);
+      if (!inst.valid || inst.hex == INSTRUCTION_BLR)
+        break;
+      if (inst.hex == INSTRUCTION_SC)
+      {
+        NPC = pc;
+        s_stats[static_cast<size_t>(function)].hits++;
+        return;
+      }
+    }
+  }
+  Return(function);
+}
+
+void DCFlushRange()
+{
+  CacheRange(Function::DCFlushRange);
+}
+
+void DCStoreRange()
+{
+  CacheRange(Function::DCStoreRange);
+}
+
+void DCInvalidateRange()
+{
+  // dcbi is privileged.
+  if (MSR.PR)
+  {
+    RunGuestCode(Function::DCInvalidateRange);
+    return;
+  }
+  CacheRange(Function::DCInvalidateRange);
+}
+
+std::vector<Profiler::HLEFunctionStat> GetStats()
+{
+  return {s_stats.begin(), s_stats.end()};
+}
+
+void ResetStats()
+{
+  for (auto& stat : s_stats)
+    stat.hits = stat.misses = 0;
+}
+}  // namespace HLE_Native
@@ -0,0 +1,33 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/Profiler.h"
+
+// Native versions of hot leaf functions of the SDK, for HookType::Conditional hooks. They only
+// handle a call if the guest code couldn't have done anything else than what they do, such as
+// raising an exception or hitting a memory check. Otherwise, they leave NPC at the start of the
+// function so that the guest code runs instead.
+namespace HLE_Native
+{
+// Returns the host pointer to the page of RAM which address is in, if it's mapped by a BAT and can
+// be accessed without any checks.
+u8* GetBATPagePointer(u32 address);
+// Returns the host pointer to a range of guest memory which isn't empty, if the guest code would
+// only access RAM in the range.
+u8* GetRAMPointer(u32 address, u32 size);
+
+void Memcpy();
+void FillMem();
+void DCFlushRange();
+void DCStoreRange();
+void DCInvalidateRange();
+
+std::vector<Profiler::HLEFunctionStat> GetStats();
+void ResetStats();
+}  // namespace HLE_Native
@@ -16,6 +16,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/Thread.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/DSP/DSPAccelerator.h"
@@ -92,6 +93,7 @@ void DSPLLE::DoState(PointerWrap& p)
 void DSPLLE::DSPThread(DSPLLE* dsp_lle)
 {
   Common::SetCurrentThreadName("DSP thread");
+  Core::SetCurrentThreadAffinity(Config::MAIN_DSP_THREAD_AFFINITY);
 
   while (dsp_lle->m_is_running.IsSet())
   {
@@ -23,6 +23,7 @@
 #include "Common/Thread.h"
 #include "Common/Timer.h"
 
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -366,6 +367,7 @@ static void FinishRead(u64 id, s64 cycles_late)
 static void DVDThread()
 {
   Common::SetCurrentThreadName("DVD thread");
+  Core::SetCurrentThreadAffinity(Config::MAIN_DVD_THREAD_AFFINITY);
 
   while (true)
   {
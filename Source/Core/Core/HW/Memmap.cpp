@@ -12,12 +12,23 @@
 #include <algorithm>
 #include <cstring>
 #include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/Swap.h"
+#include "Common/Thread.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/AudioInterface.h"
 #include "Core/HW/DSP.h"
@@ -116,6 +127,16 @@ struct LogicalMemoryView
   u32 mapped_size;
 };
 
+// A page of the logical view mapped for a translation of the page table.
+struct PageTableView
+{
+  void* mapped_pointer;
+  bool writable;
+};
+
+// The size of the pages of the page table, which is also the granularity of its mappings.
+constexpr u32 PAGE_TABLE_PAGE_SIZE = 0x1000;
+
 // Dolphin allocates memory to represent four regions:
 // - 32MB RAM (actually 24MB on hardware), available on Gamecube and Wii
 // - 64MB "EXRAM", RAM only available on Wii
@@ -141,7 +162,9 @@ struct LogicalMemoryView
 //
 // The 4GB starting at logical_base represents access from the CPU
 // with address translation turned on.  This mapping is computed based
-// on the BAT registers.
+// on the BAT registers. Pages which are translated by the page table
+// instead are mapped one at a time when the JIT first accesses them, and
+// unmapped again when their entry leaves the data TLB.
 //
 // Each of these 4GB regions is followed by 4GB of empty space so overflows
 // in address computation in the JIT don't access the wrong memory.
@@ -165,6 +188,7 @@ static PhysicalMemoryRegion physical_regions[] = {
 };
 
 static std::vector<LogicalMemoryView> logical_mapped_entries;
+static std::unordered_map<u32, PageTableView> page_table_mapped_entries;
 
 static u32 GetFlags()
 {
@@ -187,6 +211,16 @@ static u32 GetFlags()
   return flags;
 }
 
+// Returns the NUMA node of the first processor the CPU thread is pinned to, if it is pinned.
+static std::optional<u32> GetCPUThreadNode()
+{
+  const std::optional<std::vector<u32>> processors =
+      Common::ParseProcessorList(Config::Get(Config::MAIN_CPU_THREAD_AFFINITY));
+  if (!processors)
+    return std::nullopt;
+  return Common::GetProcessorNode(processors->front());
+}
+
 void Init()
 {
   bool wii = SConfig::GetInstance().bWii;
@@ -199,7 +233,7 @@ void Init()
     region.shm_position = mem_size;
     mem_size += region.size;
   }
-  g_arena.GrabSHMSegment(mem_size);
+  g_arena.GrabSHMSegment(mem_size, GetCPUThreadNode());
 
   // Create an anonymous view of the physical memory
   for (PhysicalMemoryRegion& region : physical_regions)
@@ -262,6 +296,9 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
   if (!is_fastmem_arena_initialized)
     return;
 
+  // The BATs take priority over the page table, so they may now cover some of these pages.
+  ClearPageTableMappings();
+
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
@@ -301,6 +338,78 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
   }
 }
 
+bool MapPageTablePage(u32 logical_address, u32 translated_address, bool writable)
+{
+#ifdef _WIN32
+  // Views can only be placed at the 64KB allocation granularity.
+  return false;
+#else
+  if (!is_fastmem_arena_initialized)
+    return false;
+
+  static const bool host_pages_fit = sysconf(_SC_PAGESIZE) <= PAGE_TABLE_PAGE_SIZE;
+  if (!host_pages_fit)
+    return false;
+
+  logical_address &= ~(PAGE_TABLE_PAGE_SIZE - 1);
+  translated_address &= ~(PAGE_TABLE_PAGE_SIZE - 1);
+  u8* base = logical_base + logical_address;
+
+  const auto it = page_table_mapped_entries.find(logical_address);
+  if (it != page_table_mapped_entries.end())
+  {
+    // If the mapping already allows the access, retrying it would only fault again.
+    if (!writable || it->second.writable)
+      return false;
+
+    // The page was mapped read-only to catch the first write, which sets the C bit.
+    Common::UnWriteProtectMemory(base, PAGE_TABLE_PAGE_SIZE, false);
+    it->second.writable = true;
+    return true;
+  }
+
+  const u32 flags = GetFlags();
+  for (const auto& physical_region : physical_regions)
+  {
+    if ((flags & physical_region.flags) != physical_region.flags)
+      continue;
+
+    const u32 offset = translated_address - physical_region.physical_address;
+    if (translated_address < physical_region.physical_address || offset >= physical_region.size)
+      continue;
+
+    void* mapped_pointer =
+        g_arena.CreateView(physical_region.shm_position + offset, PAGE_TABLE_PAGE_SIZE, base);
+    if (!mapped_pointer)
+      return false;
+
+    if (!writable)
+      Common::WriteProtectMemory(mapped_pointer, PAGE_TABLE_PAGE_SIZE, false);
+    page_table_mapped_entries.emplace(logical_address, PageTableView{mapped_pointer, writable});
+    return true;
+  }
+
+  return false;
+#endif
+}
+
+void UnmapPageTablePage(u32 logical_address)
+{
+  const auto it = page_table_mapped_entries.find(logical_address & ~(PAGE_TABLE_PAGE_SIZE - 1));
+  if (it == page_table_mapped_entries.end())
+    return;
+
+  g_arena.ReleaseView(it->second.mapped_pointer, PAGE_TABLE_PAGE_SIZE);
+  page_table_mapped_entries.erase(it);
+}
+
+void ClearPageTableMappings()
+{
+  for (auto& entry : page_table_mapped_entries)
+    g_arena.ReleaseView(entry.second.mapped_pointer, PAGE_TABLE_PAGE_SIZE);
+  page_table_mapped_entries.clear();
+}
+
 void DoState(PointerWrap& p)
 {
   bool wii = SConfig::GetInstance().bWii;
@@ -348,6 +457,8 @@ void ShutdownFastmemArena()
     g_arena.ReleaseView(base, region.size);
   }
 
+  ClearPageTableMappings();
+
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
@@ -68,6 +68,15 @@ void DoState(PointerWrap& p);
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
+// Maps the 4KB page of the logical view containing logical_address to the physical page
+// containing translated_address, for pages translated by the page table. A page which isn't
+// writable is mapped read-only, so the first write to it faults. Returns false if the page can't
+// be mapped, e.g. because it isn't backed by RAM or the host pages are larger, or if it already is
+// mapped with the access allowed.
+bool MapPageTablePage(u32 logical_address, u32 translated_address, bool writable);
+void UnmapPageTablePage(u32 logical_address);
+void ClearPageTableMappings();
+
 void Clear();
 
 // Routines to access physically addressed memory, designed for use by
@@ -19,6 +19,7 @@ struct CachedInterpreter::Instruction
 {
   using CommonCallback = void (*)(UGeckoInstruction);
   using ConditionalCallback = bool (*)(u32);
+  using FusedCallback = void (*)(UGeckoInstruction, UGeckoInstruction);
 
   Instruction() {}
   Instruction(const CommonCallback c, UGeckoInstruction i)
@@ -31,17 +32,30 @@ struct CachedInterpreter::Instruction
   {
   }
 
+  // A fused pair takes two entries, the second one only holding the second instruction.
+  Instruction(const FusedCallback c, UGeckoInstruction i)
+      : fused_callback(c), data(i.hex), type(Type::Fused)
+  {
+  }
+
+  explicit Instruction(UGeckoInstruction i) : data(i.hex), type(Type::Operand) {}
+
+  static FusedCallback GetFusedCallback(UGeckoInstruction first, UGeckoInstruction second);
+
   enum class Type
   {
     Abort,
     Common,
     Conditional,
+    Fused,
+    Operand,
   };
 
   union
   {
     const CommonCallback common_callback;
     const ConditionalCallback conditional_callback;
+    const FusedCallback fused_callback;
   };
 
   u32 data = 0;
@@ -100,6 +114,11 @@ void CachedInterpreter::ExecuteOneBlock()
         return;
       break;
 
+    case Instruction::Type::Fused:
+      code->fused_callback(UGeckoInstruction(code->data), UGeckoInstruction(code[1].data));
+      ++code;
+      break;
+
     default:
       ERROR_LOG(POWERPC, "Unknown CachedInterpreter Instruction: %d", static_cast<int>(code->type));
       break;
@@ -170,6 +189,16 @@ static bool CheckDSI(u32 data)
   return false;
 }
 
+static bool CheckHLEReturn(u32 data)
+{
+  if (NPC == PC)
+    return false;
+
+  PC = NPC;
+  PowerPC::ppcState.downcount -= data;
+  return true;
+}
+
 static bool CheckBreakpoint(u32 data)
 {
   PowerPC::CheckBreakPoints();
@@ -190,12 +219,69 @@ static bool CheckIdle(u32 idle_pc)
   return false;
 }
 
+// Runs two instructions which commonly follow each other through a single call, with the
+// interpreter functions inlined into it.
+template <Interpreter::Instruction first, Interpreter::Instruction second>
+static void Fused(UGeckoInstruction first_inst, UGeckoInstruction second_inst)
+{
+  first(first_inst);
+  second(second_inst);
+}
+
+// The first instruction of a pair must not need any check after it, and must not depend on PC,
+// as it is run after PC was written for the second one.
+CachedInterpreter::Instruction::FusedCallback
+CachedInterpreter::Instruction::GetFusedCallback(UGeckoInstruction first, UGeckoInstruction second)
+{
+  struct FusedPair
+  {
+    Interpreter::Instruction first;
+    Interpreter::Instruction second;
+    FusedCallback callback;
+  };
+  using I = Interpreter;
+  static const FusedPair pairs[] = {
+      {I::cmp, I::bcx, Fused<I::cmp, I::bcx>},
+      {I::cmpi, I::bcx, Fused<I::cmpi, I::bcx>},
+      {I::cmpl, I::bcx, Fused<I::cmpl, I::bcx>},
+      {I::cmpli, I::bcx, Fused<I::cmpli, I::bcx>},
+      {I::rlwinmx, I::rlwinmx, Fused<I::rlwinmx, I::rlwinmx>},
+      {I::rlwinmx, I::cmpi, Fused<I::rlwinmx, I::cmpi>},
+      {I::rlwinmx, I::cmpli, Fused<I::rlwinmx, I::cmpli>},
+      {I::addi, I::lwz, Fused<I::addi, I::lwz>},
+      {I::addi, I::stw, Fused<I::addi, I::stw>},
+      {I::addis, I::lwz, Fused<I::addis, I::lwz>},
+      {I::addis, I::addi, Fused<I::addis, I::addi>},
+      {I::lwz, I::lwz, Fused<I::lwz, I::lwz>},
+      {I::stw, I::stw, Fused<I::stw, I::stw>},
+      {I::lfs, I::lfs, Fused<I::lfs, I::lfs>},
+      {I::stfs, I::stfs, Fused<I::stfs, I::stfs>},
+      {I::lfd, I::lfd, Fused<I::lfd, I::lfd>},
+      {I::stfd, I::stfd, Fused<I::stfd, I::stfd>},
+  };
+
+  const Interpreter::Instruction first_op = PPCTables::GetInterpreterOp(first);
+  const Interpreter::Instruction second_op = PPCTables::GetInterpreterOp(second);
+  for (const FusedPair& pair : pairs)
+  {
+    if (pair.first == first_op && pair.second == second_op)
+      return pair.callback;
+  }
+  return nullptr;
+}
+
 bool CachedInterpreter::HandleFunctionHooking(u32 address)
 {
   return HLE::ReplaceFunctionIfPossible(address, [&](u32 function, HLE::HookType type) {
     m_code.emplace_back(WritePC, address);
     m_code.emplace_back(Interpreter::HLEFunction, function);
 
+    if (type == HLE::HookType::Conditional)
+    {
+      m_code.emplace_back(CheckHLEReturn, js.downcountAmount);
+      return false;
+    }
+
     if (type != HLE::HookType::Replace)
       return false;
 
@@ -205,6 +291,31 @@ bool CachedInterpreter::HandleFunctionHooking(u32 address)
   });
 }
 
+bool CachedInterpreter::IsBreakpoint(const PPCAnalyst::CodeOp& op) const
+{
+  return SConfig::GetInstance().bEnableDebugging &&
+         PowerPC::breakpoints.IsAddressBreakPoint(op.address);
+}
+
+bool CachedInterpreter::CanFuseWithNext(u32 index) const
+{
+  if (index + 1 >= code_block.m_num_instructions)
+    return false;
+
+  const PPCAnalyst::CodeOp& op = m_code_buffer[index];
+  const PPCAnalyst::CodeOp& next = m_code_buffer[index + 1];
+
+  // Nothing may have to be run between the two instructions.
+  if ((op.opinfo->flags & FL_ENDBLOCK) || ((op.opinfo->flags & FL_LOADSTORE) && jo.memcheck))
+    return false;
+  if (next.skip || IsBreakpoint(next))
+    return false;
+  if ((next.opinfo->flags & FL_USE_FPU) && !js.firstFPInstructionFound)
+    return false;
+  return !HLE::ReplaceFunctionIfPossible(
+      next.address, [](u32 function, HLE::HookType type) { return true; });
+}
+
 void CachedInterpreter::Jit(u32 address)
 {
   if (m_code.size() >= CODE_SIZE / sizeof(Instruction) - 0x1000 ||
@@ -246,33 +357,57 @@ void CachedInterpreter::Jit(u32 address)
 
     if (!op.skip)
     {
-      const bool breakpoint = SConfig::GetInstance().bEnableDebugging &&
-                              PowerPC::breakpoints.IsAddressBreakPoint(op.address);
+      const bool breakpoint = IsBreakpoint(op);
       const bool check_fpu = (op.opinfo->flags & FL_USE_FPU) && !js.firstFPInstructionFound;
-      const bool endblock = (op.opinfo->flags & FL_ENDBLOCK) != 0;
-      const bool memcheck = (op.opinfo->flags & FL_LOADSTORE) && jo.memcheck;
-      const bool idle_loop = op.branchIsIdleLoop;
+      bool pc_written = false;
 
       if (breakpoint)
       {
         m_code.emplace_back(WritePC, op.address);
         m_code.emplace_back(CheckBreakpoint, js.downcountAmount);
+        pc_written = true;
       }
 
       if (check_fpu)
       {
-        m_code.emplace_back(WritePC, op.address);
+        if (!pc_written)
+          m_code.emplace_back(WritePC, op.address);
         m_code.emplace_back(CheckFPU, js.downcountAmount);
         js.firstFPInstructionFound = true;
+        pc_written = true;
       }
 
-      if (endblock || memcheck)
-        m_code.emplace_back(WritePC, op.address);
-      m_code.emplace_back(PPCTables::GetInterpreterOp(op.inst), op.inst);
+      // The checks after a fused pair are those of its second instruction, as the first one
+      // doesn't need any.
+      const Instruction::FusedCallback fused =
+          CanFuseWithNext(i) ? Instruction::GetFusedCallback(op.inst, m_code_buffer[i + 1].inst) :
+                               nullptr;
+      const PPCAnalyst::CodeOp& last_op = fused ? m_code_buffer[++i] : op;
+      if (fused)
+      {
+        js.downcountAmount += last_op.opinfo->numCycles;
+        pc_written = false;
+      }
+
+      const bool endblock = (last_op.opinfo->flags & FL_ENDBLOCK) != 0;
+      const bool memcheck = (last_op.opinfo->flags & FL_LOADSTORE) && jo.memcheck;
+      const bool idle_loop = last_op.branchIsIdleLoop;
+
+      if ((endblock || memcheck) && !pc_written)
+        m_code.emplace_back(WritePC, last_op.address);
+      if (fused)
+      {
+        m_code.emplace_back(fused, op.inst);
+        m_code.emplace_back(last_op.inst);
+      }
+      else
+      {
+        m_code.emplace_back(PPCTables::GetInterpreterOp(op.inst), op.inst);
+      }
       if (memcheck)
         m_code.emplace_back(CheckDSI, js.downcountAmount);
       if (idle_loop)
-        m_code.emplace_back(CheckIdle, js.blockStart);
+        m_code.emplace_back(CheckIdle, last_op.branchTo);
       if (endblock)
         m_code.emplace_back(EndBlock, js.downcountAmount);
     }
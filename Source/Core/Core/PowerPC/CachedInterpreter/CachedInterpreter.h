@@ -39,6 +39,9 @@ private:
   void ExecuteOneBlock();
 
   bool HandleFunctionHooking(u32 address);
+  bool IsBreakpoint(const PPCAnalyst::CodeOp& op) const;
+  // Whether the instruction at index and the next one can be run together by a fused callback.
+  bool CanFuseWithNext(u32 index) const;
 
   BlockCache m_block_cache{*this};
   std::vector<Instruction> m_code;
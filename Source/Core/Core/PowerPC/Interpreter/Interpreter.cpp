@@ -4,6 +4,7 @@
 
 #include "Core/PowerPC/Interpreter/Interpreter.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cinttypes>
@@ -103,6 +104,25 @@ void Interpreter::RunTable63(UGeckoInstruction inst)
   m_op_table63[inst.SUBOP10](inst);
 }
 
+Interpreter::Instruction Interpreter::GetInstructionHandler(UGeckoInstruction inst)
+{
+  switch (inst.OPCD)
+  {
+  case 4:
+    return m_op_table4[inst.SUBOP10];
+  case 19:
+    return m_op_table19[inst.SUBOP10];
+  case 31:
+    return m_op_table31[inst.SUBOP10];
+  case 59:
+    return m_op_table59[inst.SUBOP5];
+  case 63:
+    return m_op_table63[inst.SUBOP10];
+  default:
+    return m_op_table[inst.OPCD];
+  }
+}
+
 void Interpreter::Init()
 {
   InitializeInstructionTables();
@@ -143,6 +163,8 @@ bool Interpreter::HandleFunctionHooking(u32 address)
 {
   return HLE::ReplaceFunctionIfPossible(address, [](u32 function, HLE::HookType type) {
     HLEFunction(function);
+    if (type == HLE::HookType::Conditional)
+      return NPC != PC;
     return type != HLE::HookType::Start;
   });
 }
@@ -222,6 +244,100 @@ int Interpreter::SingleStepInner()
   return PPCTables::GetOpInfo(m_prev_inst)->numCycles;
 }
 
+const Interpreter::PredecodedInstruction* Interpreter::GetPredecodedInstruction()
+{
+  // Modified code is only announced through icbi when the instruction cache is enabled, which is
+  // also what the JIT relies on.
+  if (!HID0.ICE)
+  {
+    if (!m_predecoded_pages.empty())
+      ClearCache();
+    return nullptr;
+  }
+
+  const u32 page_key = (PC >> PREDECODED_PAGE_SHIFT) | (MSR.IR << (32 - PREDECODED_PAGE_SHIFT));
+  if (page_key != m_last_predecoded_page_key)
+  {
+    m_last_predecoded_page_key = page_key;
+    m_last_predecoded_page = nullptr;
+
+    // Changes to the BATs clear the cache, but changes to the page table don't, so code which is
+    // translated through the page table always takes the slow path.
+    const PowerPC::TranslateResult translated = PowerPC::JitCache_TranslateAddress(PC);
+    if (translated.valid && translated.from_bat)
+    {
+      auto& page = m_predecoded_pages[translated.address >> PREDECODED_PAGE_SHIFT];
+      if (!page)
+        page = std::make_unique<PredecodedPage>();
+      m_last_predecoded_page = page.get();
+    }
+  }
+
+  if (!m_last_predecoded_page)
+    return nullptr;
+
+  PredecodedInstruction& entry =
+      (*m_last_predecoded_page)[(PC >> 2) % PREDECODED_PAGE_INSTRUCTIONS];
+  if (entry.handler && entry.address == PC)
+    return &entry;
+
+  // Failed fetches are left to SingleStepInner() to raise the exception.
+  const PowerPC::TryReadInstResult result = PowerPC::TryReadInstruction(PC);
+  if (!result.valid || result.hex == 0)
+    return nullptr;
+
+  entry.inst.hex = result.hex;
+  entry.address = PC;
+  entry.handler = GetInstructionHandler(entry.inst);
+  entry.cycles = PPCTables::GetOpInfo(entry.inst)->numCycles;
+  entry.uses_fpu = PPCTables::UsesFPU(entry.inst);
+  entry.use_single_step =
+      HLE::ReplaceFunctionIfPossible(PC, [](u32 function, HLE::HookType type) { return true; });
+  return &entry;
+}
+
+// Same as SingleStepInner(), for instructions which were already decoded.
+int Interpreter::SingleStepPredecoded()
+{
+#ifdef USE_GDBSTUB
+  if (gdb_active())
+    return SingleStepInner();
+#endif
+
+  const PredecodedInstruction* entry = GetPredecodedInstruction();
+  if (!entry || entry->use_single_step || startTrace)
+    return SingleStepInner();
+
+  // The instruction may clear the cache, so nothing must be read from the entry after running it.
+  const Instruction handler = entry->handler;
+  const int cycles = entry->cycles;
+
+  NPC = PC + sizeof(UGeckoInstruction);
+  m_prev_inst = entry->inst;
+
+  if (IsInvalidPairedSingleExecution(m_prev_inst))
+  {
+    GenerateProgramException();
+    CheckExceptions();
+  }
+  else if (!MSR.FP && entry->uses_fpu)
+  {
+    PowerPC::ppcState.Exceptions |= EXCEPTION_FPU_UNAVAILABLE;
+    CheckExceptions();
+  }
+  else
+  {
+    handler(m_prev_inst);
+    if (PowerPC::ppcState.Exceptions & EXCEPTION_DSI)
+    {
+      CheckExceptions();
+    }
+  }
+
+  UpdatePC();
+  return cycles;
+}
+
 void Interpreter::SingleStep()
 {
   // Declare start of new slice
@@ -326,7 +442,7 @@ void Interpreter::Run()
         int cycles = 0;
         while (!m_end_block)
         {
-          cycles += SingleStepInner();
+          cycles += SingleStepPredecoded();
         }
         PowerPC::ppcState.downcount -= cycles;
       }
@@ -355,7 +471,34 @@ void Interpreter::unknown_instruction(UGeckoInstruction inst)
 
 void Interpreter::ClearCache()
 {
-  // Do nothing.
+  m_predecoded_pages.clear();
+  m_last_predecoded_page_key = UINT32_MAX;
+  m_last_predecoded_page = nullptr;
+}
+
+void Interpreter::InvalidateICache(u32 address, u32 size)
+{
+  if (m_predecoded_pages.empty())
+    return;
+
+  const PowerPC::TranslateResult translated = PowerPC::JitCache_TranslateAddress(address);
+  if (!translated.valid)
+    return;
+
+  const u32 start = translated.address & ~3;
+  const u32 end = translated.address + size;
+  for (u32 page_address = start; page_address < end;)
+  {
+    const u32 page_end =
+        std::min(end, ((page_address >> PREDECODED_PAGE_SHIFT) + 1) << PREDECODED_PAGE_SHIFT);
+    const auto it = m_predecoded_pages.find(page_address >> PREDECODED_PAGE_SHIFT);
+    if (it != m_predecoded_pages.end())
+    {
+      for (u32 i = page_address; i < page_end; i += 4)
+        (*it->second)[(i >> 2) % PREDECODED_PAGE_INSTRUCTIONS].handler = nullptr;
+    }
+    page_address = page_end;
+  }
 }
 
 void Interpreter::CheckExceptions()
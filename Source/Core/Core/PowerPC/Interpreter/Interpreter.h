@@ -5,6 +5,8 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <unordered_map>
 
 #include "Common/CommonTypes.h"
 #include "Core/PowerPC/CPUCoreBase.h"
@@ -17,11 +19,16 @@ public:
   void Shutdown() override;
   void SingleStep() override;
   int SingleStepInner();
+  // Same as SingleStepInner(), but runs the instruction from the predecoded cache if possible.
+  int SingleStepPredecoded();
 
   void Run() override;
   void ClearCache() override;
   const char* GetName() const override;
 
+  // Drops the predecoded instructions in the given range of effective addresses.
+  void InvalidateICache(u32 address, u32 size);
+
   static void unknown_instruction(UGeckoInstruction inst);
 
   // Branch Instructions
@@ -282,6 +289,27 @@ public:
   static u32 Helper_Carry(u32 value1, u32 value2);
 
 private:
+  // An instruction as it was fetched and decoded, so that the fast run loop doesn't need to go
+  // through the MMU, the instruction cache and the opcode sub-tables again.
+  struct PredecodedInstruction
+  {
+    // The handler from the opcode sub-table, or nullptr if not decoded yet.
+    Instruction handler;
+    UGeckoInstruction inst;
+    // The effective address it was decoded for, as HLE hooks depend on it.
+    u32 address;
+    int cycles;
+    bool uses_fpu;
+    // Instructions with a HLE hook go through SingleStepInner().
+    bool use_single_step;
+  };
+  static constexpr u32 PREDECODED_PAGE_SHIFT = 12;
+  static constexpr u32 PREDECODED_PAGE_INSTRUCTIONS = (1 << PREDECODED_PAGE_SHIFT) / 4;
+  using PredecodedPage = std::array<PredecodedInstruction, PREDECODED_PAGE_INSTRUCTIONS>;
+
+  const PredecodedInstruction* GetPredecodedInstruction();
+  static Instruction GetInstructionHandler(UGeckoInstruction inst);
+
   void CheckExceptions();
 
   static void InitializeInstructionTables();
@@ -296,6 +324,12 @@ private:
 
   UGeckoInstruction m_prev_inst{};
 
+  // Predecoded instructions, indexed by physical page.
+  std::unordered_map<u32, std::unique_ptr<PredecodedPage>> m_predecoded_pages;
+  // The page of the last instruction, indexed by its effective page and MSR.IR.
+  u32 m_last_predecoded_page_key = UINT32_MAX;
+  PredecodedPage* m_last_predecoded_page = nullptr;
+
   static bool m_end_block;
 
   // TODO: These should really be in the save state, although it's unlikely to matter much.
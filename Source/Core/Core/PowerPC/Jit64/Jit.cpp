@@ -4,9 +4,13 @@
 
 #include "Core/PowerPC/Jit64/Jit.h"
 
+#include <cstddef>
+#include <cstring>
+#include <iterator>
 #include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <disasm.h>
 #include <fmt/format.h>
@@ -233,11 +237,34 @@ bool Jit64::HandleFault(uintptr_t access_address, SContext* ctx)
 
   const auto logical_base_ptr = reinterpret_cast<uintptr_t>(Memory::logical_base);
   if (access_address >= logical_base_ptr && access_address < logical_base_ptr + 0x100010000)
-    return BackPatch(static_cast<u32>(access_address - logical_base_ptr), ctx);
+  {
+    // Accesses past the end of the 4GB view land in the guard space behind it, whose addresses
+    // would wrap around to the start of the view.
+    const u32 em_address = static_cast<u32>(access_address - logical_base_ptr);
+    if (access_address < logical_base_ptr + 0x100000000 && HandlePageTableFault(em_address, ctx))
+      return true;
+    return BackPatch(em_address, ctx);
+  }
 
   return false;
 }
 
+// Pages translated by the page table are only mapped into the logical view once they are accessed,
+// so the first access to each of them faults. Rather than sending the instruction to the slow path
+// for good, map the page and let the access run again.
+bool Jit64::HandlePageTableFault(u32 em_address, SContext* ctx)
+{
+  u8* code_ptr = reinterpret_cast<u8*>(ctx->CTX_PC);
+  if (!IsInSpace(code_ptr))
+    return false;
+
+  const auto it = m_back_patch_info.find(code_ptr);
+  if (it == m_back_patch_info.end())
+    return false;
+
+  return PowerPC::MapPageForFastmem(em_address, !it->second.read);
+}
+
 bool Jit64::BackPatch(u32 emAddress, SContext* ctx)
 {
   u8* codePtr = reinterpret_cast<u8*>(ctx->CTX_PC);
@@ -371,6 +398,7 @@ void Jit64::Init()
   // it'll crash because the farcode functions get cleared on JIT clears.
   m_far_code.Init();
   Clear();
+  ResetCodeRegions();
 
   code_block.m_stats = &js.st;
   code_block.m_gpa = &js.gpa;
@@ -386,9 +414,79 @@ void Jit64::ClearCache()
   m_const_pool.Clear();
   ClearCodeSpace();
   Clear();
+  m_inline_caches.clear();
+  m_gqr_guard_failures.clear();
+  ResetCodeRegions();
   UpdateMemoryOptions();
 }
 
+void Jit64::ResetCodeRegions(size_t size, size_t far_size)
+{
+  u8* const start = GetWritableCodePtr();
+  u8* const far_start = m_far_code.GetWritableCodePtr();
+  if (size == 0)
+    size = GetSpaceLeft() / NUM_CODE_REGIONS;
+  if (far_size == 0)
+    far_size = m_far_code.GetSpaceLeft() / NUM_CODE_REGIONS;
+  for (u32 i = 0; i < NUM_CODE_REGIONS; i++)
+  {
+    CodeRegion& code_region = m_code_regions[i];
+    code_region.start = start + i * size;
+    code_region.end = code_region.start + size;
+    code_region.ptr = code_region.start;
+    code_region.far_start = far_start + i * far_size;
+    code_region.far_end = code_region.far_start + far_size;
+    code_region.far_ptr = code_region.far_start;
+  }
+  m_nursery_region = 0;
+  m_code_region = 0;
+}
+
+void Jit64::SwitchToCodeRegion(bool tenured)
+{
+  // This should be bigger than the biggest block ever, like in CodeBlock::IsAlmostFull.
+  constexpr ptrdiff_t MIN_SPACE_LEFT = 0x10000;
+
+  u32 index = tenured ? TENURED_CODE_REGION : m_nursery_region;
+  const CodeRegion& current = m_code_regions[index];
+  if (current.end - current.ptr < MIN_SPACE_LEFT ||
+      current.far_end - current.far_ptr < MIN_SPACE_LEFT)
+  {
+    if (!tenured)
+    {
+      m_nursery_region = (m_nursery_region + 1) % TENURED_CODE_REGION;
+      index = m_nursery_region;
+    }
+    EvictCodeRegion(index);
+  }
+
+  m_code_region = index;
+  SetCodePtr(m_code_regions[index].ptr);
+  m_far_code.SetCodePtr(m_code_regions[index].far_ptr);
+}
+
+void Jit64::EvictCodeRegion(u32 index)
+{
+  INFO_LOG(POWERPC, "Evicting JIT code region %u", index);
+
+  CodeRegion& code_region = m_code_regions[index];
+  blocks.EraseCodeRegion(index);
+
+  const auto in_region = [&code_region](const u8* ptr) {
+    return (ptr >= code_region.start && ptr < code_region.end) ||
+           (ptr >= code_region.far_start && ptr < code_region.far_end);
+  };
+  for (auto iter = m_back_patch_info.begin(); iter != m_back_patch_info.end();)
+    iter = in_region(iter->first) ? m_back_patch_info.erase(iter) : std::next(iter);
+  for (auto iter = m_exception_handler_at_loc.begin(); iter != m_exception_handler_at_loc.end();)
+    iter = in_region(iter->first) ? m_exception_handler_at_loc.erase(iter) : std::next(iter);
+  for (auto iter = m_inline_caches.begin(); iter != m_inline_caches.end();)
+    iter = in_region(iter->first) ? m_inline_caches.erase(iter) : std::next(iter);
+
+  code_region.ptr = code_region.start;
+  code_region.far_ptr = code_region.far_start;
+}
+
 void Jit64::Shutdown()
 {
   FreeStack();
@@ -514,6 +612,7 @@ bool Jit64::Cleanup()
         Imm32(js.downcountAmount));
     MOV(64, MDisp(RSCRATCH2, offsetof(JitBlock::ProfileData, ticCounter)), R(RSCRATCH));
     ABI_PopRegistersAndAdjustStack({}, 0);
+    did_something = true;
   }
 
   return did_something;
@@ -621,6 +720,127 @@ void Jit64::WriteExitDestInRSCRATCH(bool bl, u32 after)
   }
 }
 
+void Jit64::WriteInlineCachedExitDestInRSCRATCH(bool bl, u32 after)
+{
+  // Without block linking, all exits go through the dispatcher anyway.
+  if (!jo.enableBlocklink || SConfig::GetInstance().bEnableDebugging)
+  {
+    WriteExitDestInRSCRATCH(bl, after);
+    return;
+  }
+
+  if (!m_enable_blr_optimization)
+    bl = false;
+  MOV(32, PPCSTATE(pc), R(RSCRATCH));
+  if (Cleanup())
+    MOV(32, R(RSCRATCH), PPCSTATE(pc));
+
+  if (bl)
+  {
+    MOV(32, R(RSCRATCH2), Imm32(after));
+    PUSH(RSCRATCH2);
+  }
+
+  SUB(32, PPCSTATE(downcount), Imm32(js.downcountAmount));
+
+  // Same timing check as JustWriteExit()
+  FixupBranch after_timing;
+  if (bl)
+  {
+    FixupBranch do_timing = J_CC(CC_LE, true);
+    SwitchToFarCode();
+    SetJumpTarget(do_timing);
+    CALL(asm_routines.do_timing);
+    after_timing = J(true);
+    SwitchToNearCode();
+  }
+  else
+  {
+    J_CC(CC_LE, asm_routines.do_timing);
+  }
+
+  const u8* site = GetCodePtr();
+  InlineCache& cache = m_inline_caches[site];
+  cache.block_address = js.curBlock->effectiveAddress;
+  cache.block_msr = js.curBlock->msrBits;
+  cache.used_slots = 0;
+  cache.call = bl;
+
+  // The exits of the slots are linked like those of other branches once they are used.
+  std::vector<FixupBranch> returns;
+  for (u32 i = 0; i < INLINE_CACHE_SIZE; i++)
+  {
+    CMP(32, R(RSCRATCH), Imm32(INLINE_CACHE_UNUSED_SLOT));
+    cache.destinations[i] = GetWritableCodePtr() - sizeof(u32);
+    DEBUG_ASSERT(std::memcmp(cache.destinations[i], &INLINE_CACHE_UNUSED_SLOT, sizeof(u32)) == 0);
+    FixupBranch next_slot = J_CC(CC_NE);
+    if (jo.profile_blocks)
+      IncrementProfileCounter(&js.curBlock->profile_data.inlineCacheHits, RSCRATCH);
+    cache.exits[i] = GetWritableCodePtr();
+    if (bl)
+    {
+      CALL(asm_routines.dispatcher_no_check);
+      returns.push_back(J(true));
+    }
+    else
+    {
+      JMP(asm_routines.dispatcher_no_check, true);
+    }
+    SetJumpTarget(next_slot);
+  }
+
+  SwitchToFarCode();
+  const u8* miss = GetCodePtr();
+  if (jo.profile_blocks)
+    IncrementProfileCounter(&js.curBlock->profile_data.inlineCacheMisses, RSCRATCH);
+  ABI_PushRegistersAndAdjustStack({}, 0);
+  ABI_CallFunctionPP(UpdateInlineCache, this, site);
+  ABI_PopRegistersAndAdjustStack({}, 0);
+  JMP(asm_routines.dispatcher_no_check, true);
+  SwitchToNearCode();
+
+  if (bl)
+  {
+    CALL(miss);
+    for (FixupBranch& fixup : returns)
+      SetJumpTarget(fixup);
+    SetJumpTarget(after_timing);
+    POP(RSCRATCH);
+    JustWriteExit(after, false, 0);
+  }
+  else
+  {
+    JMP(miss, true);
+  }
+}
+
+void Jit64::UpdateInlineCache(Jit64* jit, const u8* site)
+{
+  const auto iter = jit->m_inline_caches.find(site);
+  if (iter == jit->m_inline_caches.end())
+    return;
+
+  InlineCache& cache = iter->second;
+  if (cache.used_slots == INLINE_CACHE_SIZE)
+    return;
+
+  // The block may have been invalidated while it was running.
+  JitBlock* block = jit->blocks.GetBlockFromStartAddress(cache.block_address, cache.block_msr);
+  if (!block || site < block->normalEntry || site >= block->normalEntry + block->codeSize)
+    return;
+
+  ASSERT_MSG(DYNA_REC,
+             std::memcmp(cache.destinations[cache.used_slots], &INLINE_CACHE_UNUSED_SLOT,
+                         sizeof(u32)) == 0,
+             "Inline cache slot at %p doesn't hold its placeholder",
+             cache.destinations[cache.used_slots]);
+
+  const u32 destination = PC;
+  std::memcpy(cache.destinations[cache.used_slots], &destination, sizeof(destination));
+  jit->blocks.AddBlockExit(*block, {cache.exits[cache.used_slots], destination, false, cache.call});
+  cache.used_slots++;
+}
+
 void Jit64::WriteBLRExit()
 {
   if (!m_enable_blr_optimization)
@@ -634,11 +854,39 @@ void Jit64::WriteBLRExit()
     MOV(32, R(RSCRATCH), PPCSTATE(pc));
   MOV(32, R(RSCRATCH2), Imm32(js.downcountAmount));
   CMP(64, R(RSCRATCH), MDisp(RSP, 8));
-  J_CC(CC_NE, asm_routines.dispatcher_mispredicted_blr);
+  if (jo.profile_blocks)
+  {
+    FixupBranch mispredicted = J_CC(CC_NE, true);
+    SwitchToFarCode();
+    SetJumpTarget(mispredicted);
+    IncrementProfileCounter(&js.curBlock->profile_data.returnMisses, RSCRATCH);
+    JMP(asm_routines.dispatcher_mispredicted_blr, true);
+    SwitchToNearCode();
+    IncrementProfileCounter(&js.curBlock->profile_data.returnHits, RSCRATCH);
+  }
+  else
+  {
+    J_CC(CC_NE, asm_routines.dispatcher_mispredicted_blr);
+  }
   SUB(32, PPCSTATE(downcount), R(RSCRATCH2));
   RET();
 }
 
+void Jit64::OnGQRGuardFailure(Jit64* jit, u32 address)
+{
+  // Recompile the block for the new GQR values, unless they keep changing.
+  if (++jit->m_gqr_guard_failures[address] > MAX_GQR_RESPECIALIZATIONS)
+    JitInterface::CompileExceptionCheck(JitInterface::ExceptionType::PairedQuantize);
+  else
+    jit->blocks.InvalidateICache(address, 4, true);
+}
+
+void Jit64::IncrementProfileCounter(u64* counter, X64Reg scratch)
+{
+  MOV(64, R(scratch), ImmPtr(counter));
+  ADD(64, MatR(scratch), Imm8(1));
+}
+
 void Jit64::WriteRfiExitDestInRSCRATCH()
 {
   MOV(32, PPCSTATE(pc), R(RSCRATCH));
@@ -732,15 +980,12 @@ void Jit64::Jit(u32 em_address)
 #endif
   }
 
-  if (IsAlmostFull() || m_far_code.IsAlmostFull() || trampolines.IsAlmostFull() ||
-      SConfig::GetInstance().bJITNoBlockCache)
+  // Running out of main or far code space only evicts a region of it, see SwitchToCodeRegion().
+  // Trampolines aren't tracked per region, so they still need a full flush.
+  if (trampolines.IsAlmostFull() || SConfig::GetInstance().bJITNoBlockCache)
   {
     if (!SConfig::GetInstance().bJITNoBlockCache)
-    {
-      const auto reason =
-          IsAlmostFull() ? "main" : m_far_code.IsAlmostFull() ? "far" : "trampoline";
-      WARN_LOG(POWERPC, "flushing %s code cache, please report if this happens a lot", reason);
-    }
+      WARN_LOG(POWERPC, "flushing trampoline code cache, please report if this happens a lot");
     ClearCache();
   }
 
@@ -786,8 +1031,13 @@ void Jit64::Jit(u32 em_address)
     return;
   }
 
+  SwitchToCodeRegion(blocks.WasEvicted(em_address));
+
   JitBlock* b = blocks.AllocateBlock(em_address);
+  b->code_region = m_code_region;
   DoJit(em_address, b, nextPC);
+  m_code_regions[m_code_region].ptr = GetWritableCodePtr();
+  m_code_regions[m_code_region].far_ptr = m_far_code.GetWritableCodePtr();
   blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
 }
 
@@ -840,6 +1090,7 @@ u8* Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
   js.carryFlagSet = false;
   js.carryFlagInverted = false;
   js.constantGqr.clear();
+  js.fprIsFinite = BitSet32(0);
 
   // Assume that GQR values don't change often at runtime. Many paired-heavy games use largely float
   // loads and stores,
@@ -855,8 +1106,7 @@ u8* Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
       const u8* target = GetCodePtr();
       MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
       ABI_PushRegistersAndAdjustStack({}, 0);
-      ABI_CallFunctionC(JitInterface::CompileExceptionCheck,
-                        static_cast<u32>(JitInterface::ExceptionType::PairedQuantize));
+      ABI_CallFunctionPC(OnGQRGuardFailure, this, js.blockStart);
       ABI_PopRegistersAndAdjustStack({}, 0);
       JMP(asm_routines.dispatcher_no_check, true);
       SwitchToNearCode();
@@ -1021,6 +1271,7 @@ u8* Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
       }
 
       CompileInstruction(op);
+      UpdateFiniteFPRs(op);
 
       if (jo.memcheck && (opinfo->flags & FL_LOADSTORE))
       {
@@ -1169,6 +1420,20 @@ bool Jit64::HandleFunctionHooking(u32 address)
   return HLE::ReplaceFunctionIfPossible(address, [&](u32 function, HLE::HookType type) {
     HLEFunction(function);
 
+    if (type == HLE::HookType::Conditional)
+    {
+      // The HLE function leaves NPC at the start of the function if the guest code has to run.
+      CMP(32, PPCSTATE(npc), Imm32(address));
+      FixupBranch run_guest_code = J_CC(CC_E, true);
+      const u32 downcount_amount = js.downcountAmount;
+      MOV(32, R(RSCRATCH), PPCSTATE(npc));
+      js.downcountAmount += js.st.numCycles;
+      WriteExitDestInRSCRATCH();
+      js.downcountAmount = downcount_amount;
+      SetJumpTarget(run_guest_code);
+      return false;
+    }
+
     if (type != HLE::HookType::Replace)
       return false;
 
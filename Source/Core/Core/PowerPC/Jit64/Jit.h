@@ -18,6 +18,10 @@
 // ----------
 #pragma once
 
+#include <array>
+#include <map>
+#include <unordered_map>
+
 #include "Common/CommonTypes.h"
 #include "Common/x64ABI.h"
 #include "Common/x64Emitter.h"
@@ -48,6 +52,7 @@ public:
 
   bool HandleFault(uintptr_t access_address, SContext* ctx) override;
   bool HandleStackFault() override;
+  bool HandlePageTableFault(u32 em_address, SContext* ctx);
   bool BackPatch(u32 emAddress, SContext* ctx);
 
   void EnableOptimization();
@@ -80,6 +85,7 @@ public:
   void WriteExit(u32 destination, bool bl = false, u32 after = 0);
   void JustWriteExit(u32 destination, bool bl, u32 after);
   void WriteExitDestInRSCRATCH(bool bl = false, u32 after = 0);
+  void WriteInlineCachedExitDestInRSCRATCH(bool bl = false, u32 after = 0);
   void WriteBLRExit();
   void WriteExceptionExit();
   void WriteExternalExceptionExit();
@@ -113,6 +119,9 @@ public:
   Gen::FixupBranch JumpIfCRFieldBit(int field, int bit, bool jump_if_set = true);
   void SetFPRFIfNeeded(Gen::X64Reg xmm);
 
+  void UpdateFiniteFPRs(const PPCAnalyst::CodeOp& op);
+  // Whether the result of the instruction may be a NaN which has to be fixed up by HandleNaNs.
+  bool NeedsNaNHandling(UGeckoInstruction inst) const;
   void HandleNaNs(UGeckoInstruction inst, Gen::X64Reg xmm_out, Gen::X64Reg xmm_in,
                   Gen::X64Reg clobber = Gen::XMM0);
 
@@ -235,6 +244,58 @@ public:
 
   void eieio(UGeckoInstruction inst);
 
+protected:
+  // Splits the free main and far code space into regions of the given sizes. By default, all of
+  // it is split evenly.
+  void ResetCodeRegions(size_t size = 0, size_t far_size = 0);
+
+  // The main and far code spaces are split into regions which are reused separately. New blocks
+  // are compiled into the nursery regions in turn, and when one fills up, the oldest one is
+  // evicted. Blocks which are compiled again after their region was evicted are still in use, so
+  // they go into the tenured region, which is only evicted when it fills up itself.
+  static constexpr u32 NUM_CODE_REGIONS = 4;
+  static constexpr u32 TENURED_CODE_REGION = NUM_CODE_REGIONS - 1;
+
+  struct CodeRegion
+  {
+    u8* start;
+    u8* end;
+    u8* ptr;
+    u8* far_start;
+    u8* far_end;
+    u8* far_ptr;
+  };
+  std::array<CodeRegion, NUM_CODE_REGIONS> m_code_regions;
+  u32 m_nursery_region;
+  u32 m_code_region;
+
+  // Indirect branches compare their destination with the destinations they had before, and jump
+  // to the blocks of those directly. A miss fills the next unused slot, and once all of them are
+  // used, the other destinations keep going through the dispatcher.
+  static constexpr u32 INLINE_CACHE_SIZE = 4;
+  // Effective addresses are 4-byte aligned, so this never matches. It also doesn't fit in a sign
+  // extended imm8, so the comparisons are emitted with the imm32 that the slots are patched in.
+  static constexpr u32 INLINE_CACHE_UNUSED_SLOT = 0x80000001;
+
+  struct InlineCache
+  {
+    u32 block_address;
+    u32 block_msr;
+    // Where the destination of each slot is kept in its comparison, and the exit it jumps through.
+    std::array<u8*, INLINE_CACHE_SIZE> destinations;
+    std::array<u8*, INLINE_CACHE_SIZE> exits;
+    u32 used_slots;
+    bool call;
+  };
+  // Indexed by the start of the code of the branch.
+  std::map<const u8*, InlineCache> m_inline_caches;
+
+  // Blocks are compiled for the GQR values they first run with. When those change, they are
+  // compiled again for the new values, up to this many times before they read the GQRs at runtime.
+  static constexpr u32 MAX_GQR_RESPECIALIZATIONS = 3;
+  // Indexed by the address of the block.
+  std::unordered_map<u32, u32> m_gqr_guard_failures;
+
 private:
   static void InitializeInstructionTables();
   void CompileInstruction(PPCAnalyst::CodeOp& op);
@@ -244,6 +305,13 @@ private:
   void AllocStack();
   void FreeStack();
 
+  void IncrementProfileCounter(u64* counter, Gen::X64Reg scratch);
+  static void UpdateInlineCache(Jit64* jit, const u8* site);
+  static void OnGQRGuardFailure(Jit64* jit, u32 address);
+
+  void SwitchToCodeRegion(bool tenured);
+  void EvictCodeRegion(u32 index);
+
   JitBlockCache blocks{*this};
   TrampolineCache trampolines{*this};
 
@@ -197,7 +197,7 @@ void Jit64::bcctrx(UGeckoInstruction inst)
     if (inst.LK_3)
       MOV(32, PPCSTATE_LR, Imm32(js.compilerPC + 4));  // LR = PC + 4;
     AND(32, R(RSCRATCH), Imm32(0xFFFFFFFC));
-    WriteExitDestInRSCRATCH(inst.LK_3, js.compilerPC + 4);
+    WriteInlineCachedExitDestInRSCRATCH(inst.LK_3, js.compilerPC + 4);
   }
   else
   {
@@ -219,7 +219,7 @@ void Jit64::bcctrx(UGeckoInstruction inst)
       RCForkGuard fpr_guard = fpr.Fork();
       gpr.Flush();
       fpr.Flush();
-      WriteExitDestInRSCRATCH(inst.LK_3, js.compilerPC + 4);
+      WriteInlineCachedExitDestInRSCRATCH(inst.LK_3, js.compilerPC + 4);
       // Would really like to continue the block here, but it ends. TODO.
     }
     SetJumpTarget(b);
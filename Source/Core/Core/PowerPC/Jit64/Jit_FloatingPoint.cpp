@@ -38,6 +38,69 @@ void Jit64::SetFPRFIfNeeded(X64Reg xmm)
     SetFPRF(xmm);
 }
 
+static bool PreservesFiniteness(UGeckoInstruction inst)
+{
+  if (inst.OPCD != 4 && inst.OPCD != 63)
+    return false;
+
+  // fsel, ps_sel
+  if (inst.SUBOP5 == 23)
+    return true;
+
+  switch (inst.SUBOP10)
+  {
+  case 40:   // fneg, ps_neg
+  case 72:   // fmr, ps_mr
+  case 136:  // fnabs, ps_nabs
+  case 264:  // fabs, ps_abs
+    return true;
+  case 528:  // ps_merge00
+  case 560:  // ps_merge01
+  case 592:  // ps_merge10
+  case 624:  // ps_merge11
+    return inst.OPCD == 4;
+  default:
+    return false;
+  }
+}
+
+// Tracks which FPRs can't hold a NaN or an infinity, so that HandleNaNs can be skipped for them.
+// Values dequantized from integers are finite, and stay so while they are only moved around.
+void Jit64::UpdateFiniteFPRs(const PPCAnalyst::CodeOp& op)
+{
+  if (op.fregOut < 0)
+    return;
+
+  const UGeckoInstruction inst = op.inst;
+  bool finite = false;
+  if (op.opinfo->type == OpType::LoadPS)
+  {
+    const auto it = js.constantGqr.find(inst.OPCD == 4 ? inst.Ix : inst.I);
+    finite = it != js.constantGqr.end() && ((it->second >> 16) & 0x7) >= QUANTIZE_U8;
+  }
+  else if (PreservesFiniteness(inst))
+  {
+    finite = (op.fregsIn & js.fprIsFinite) == op.fregsIn;
+  }
+  js.fprIsFinite[op.fregOut] = finite;
+}
+
+bool Jit64::NeedsNaNHandling(UGeckoInstruction inst) const
+{
+  if (!SConfig::GetInstance().bAccurateNaNs)
+    return false;
+
+  // Apart from division, none of the operations which get here can turn finite inputs into a NaN.
+  if (inst.SUBOP5 == 18)
+    return true;
+  for (u32 i : {inst.FA, inst.FB, inst.FC})
+  {
+    if (js.op->fregsIn[i] && !js.fprIsFinite[i])
+      return true;
+  }
+  return false;
+}
+
 void Jit64::HandleNaNs(UGeckoInstruction inst, X64Reg xmm_out, X64Reg xmm, X64Reg clobber)
 {
   //                      | PowerPC  | x86
@@ -48,7 +111,7 @@ void Jit64::HandleNaNs(UGeckoInstruction inst, X64Reg xmm_out, X64Reg xmm, X64Re
   // Dragon Ball: Revenge of King Piccolo requires generated NaNs
   // to be positive, so we'll have to handle them manually.
 
-  if (!SConfig::GetInstance().bAccurateNaNs)
+  if (!NeedsNaNHandling(inst))
   {
     if (xmm_out != xmm)
       MOVAPD(xmm_out, R(xmm));
@@ -175,7 +238,7 @@ void Jit64::fp_arith(UGeckoInstruction inst)
     packed = false;
 
   bool round_input = single && !js.op->fprIsSingle[inst.FC];
-  bool preserve_inputs = SConfig::GetInstance().bAccurateNaNs;
+  bool preserve_inputs = NeedsNaNHandling(inst);
 
   const auto fp_tri_op = [&](int op1, int op2, bool reversible,
                              void (XEmitter::*avxOp)(X64Reg, X64Reg, const OpArg&),
@@ -254,7 +317,13 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
   // Note that FMA isn't necessarily less correct (it may actually be closer to correct) compared
   // to what the Gekko does here; in deterministic mode, the important thing is multiple Dolphin
   // instances on different computers giving identical results.
-  const bool use_fma = cpu_info.bFMA && !Core::WantsDeterminism();
+  //
+  // The exception is when the product of two single precision inputs is exact in a double, so
+  // rounding only happens once either way. With accurate NaNs, the NaN picked doesn't depend on the
+  // instructions either. This doesn't hold for nmadd, whose negation differs for zero results.
+  const bool deterministic_fma = js.op->fprIsSingle[a] && js.op->fprIsSingle[c] &&
+                                 SConfig::GetInstance().bAccurateNaNs && inst.SUBOP5 != 31;
+  const bool use_fma = cpu_info.bFMA && (!Core::WantsDeterminism() || deterministic_fma);
 
   // For use_fma == true:
   //   Statistics suggests b is a lot less likely to be unbound in practice, so
@@ -278,7 +347,7 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
       Force25BitPrecision(XMM1, R(XMM1), XMM0);
     break;
   default:
-    bool special = inst.SUBOP5 == 30 && (!cpu_info.bFMA || Core::WantsDeterminism());
+    bool special = inst.SUBOP5 == 30 && !use_fma;
     X64Reg tmp1 = special ? XMM0 : XMM1;
     X64Reg tmp2 = special ? XMM1 : XMM0;
     if (single && round_input)
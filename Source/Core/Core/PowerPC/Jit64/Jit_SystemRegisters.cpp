@@ -265,6 +265,16 @@ void Jit64::mtspr(UGeckoInstruction inst)
     FALLBACK_IF(true);
   }
 
+  // A GQR which is set to a constant is known for the rest of the block, so the following paired
+  // loads and stores can be specialized for it without a guard.
+  if (iIndex >= SPR_GQR0 && iIndex < SPR_GQR0 + 8)
+  {
+    if (gpr.IsImm(d))
+      js.constantGqr[iIndex - SPR_GQR0] = gpr.Imm32(d);
+    else
+      js.constantGqr.erase(iIndex - SPR_GQR0);
+  }
+
   // OK, this is easy.
   RCOpArg Rd = gpr.BindOrImm(d, RCMode::Read);
   RegCache::Realize(Rd);
@@ -8,6 +8,7 @@
 #include <map>
 #include <unordered_set>
 
+#include "Common/BitSet.h"
 #include "Common/CommonTypes.h"
 #include "Common/x64Emitter.h"
 #include "Core/ConfigManager.h"
@@ -70,6 +71,8 @@ protected:
 
     bool assumeNoPairedQuantize;
     std::map<u8, u32> constantGqr;
+    // FPRs known to hold neither NaNs nor infinities at this point in the block.
+    BitSet32 fprIsFinite;
     bool firstFPInstructionFound;
     bool isLastInstruction;
     int skipInstructions;
@@ -72,6 +72,7 @@ void JitBaseBlockCache::Clear()
   block_map.clear();
   links_to.clear();
   block_range_map.clear();
+  evicted_addresses.clear();
 
   valid_block.ClearAll();
 
@@ -104,6 +105,7 @@ JitBlock* JitBaseBlockCache::AllocateBlock(u32 em_address)
   b.msrBits = MSR.Hex & JIT_CACHE_MSR_MASK;
   b.linkData.clear();
   b.fast_block_map_index = 0;
+  b.code_region = 0;
   return &b;
 }
 
@@ -216,6 +218,7 @@ void JitBaseBlockCache::InvalidateICache(u32 address, u32 length, bool forced)
       {
         m_jit.js.fifoWriteAddresses.erase(i);
         m_jit.js.pairedQuantizeAddresses.erase(i);
+        evicted_addresses.erase(i);
       }
     }
   }
@@ -270,6 +273,40 @@ void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
   }
 }
 
+void JitBaseBlockCache::EraseCodeRegion(u32 region)
+{
+  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  auto iter = block_map.begin();
+  while (iter != block_map.end())
+  {
+    JitBlock& block = iter->second;
+    if (block.code_region != region)
+    {
+      iter++;
+      continue;
+    }
+
+    for (u32 addr : block.physical_addresses)
+    {
+      auto range = block_range_map.find(addr & range_mask);
+      if (range == block_range_map.end())
+        continue;
+      range->second.erase(&block);
+      if (range->second.empty())
+        block_range_map.erase(range);
+    }
+
+    evicted_addresses.insert(block.effectiveAddress);
+    DestroyBlock(block);
+    iter = block_map.erase(iter);
+  }
+}
+
+bool JitBaseBlockCache::WasEvicted(u32 em_address) const
+{
+  return evicted_addresses.count(em_address) != 0;
+}
+
 u32* JitBaseBlockCache::GetBlockBitSet() const
 {
   return valid_block.m_valid_block.get();
@@ -280,6 +317,13 @@ void JitBaseBlockCache::WriteDestroyBlock(const JitBlock& block)
 }
 
 // Block linker
+void JitBaseBlockCache::AddBlockExit(JitBlock& block, const JitBlock::LinkData& exit)
+{
+  block.linkData.push_back(exit);
+  links_to.emplace(exit.exitAddress, &block);
+  LinkBlockExits(block);
+}
+
 // Make sure to have as many blocks as possible compiled before calling this
 // It's O(N), so it's fast :)
 // Can be faster by doing a queue for blocks to link up, and only process those
@@ -72,11 +72,21 @@ struct JitBlock
     u64 runCount;
     u64 ticStart;
     u64 ticStop;
+    // Returns which went back to the predicted caller, and indirect branches which found their
+    // target in their inline cache, and those which didn't.
+    u64 returnHits;
+    u64 returnMisses;
+    u64 inlineCacheHits;
+    u64 inlineCacheMisses;
   } profile_data = {};
 
   // This tracks the position if this block within the fast block cache.
   // We allow each block to have only one map entry.
   size_t fast_block_map_index;
+
+  // The region of the code space the block was compiled into, for JITs which
+  // reuse parts of their code space separately. See EraseCodeRegion().
+  u32 code_region;
 };
 
 typedef void (*CompiledCode)();
@@ -135,6 +145,9 @@ public:
 
   JitBlock* AllocateBlock(u32 em_address);
   void FinalizeBlock(JitBlock& block, bool block_link, const std::set<u32>& physical_addresses);
+  // Adds an exit to a block which is already finalized, for exits whose destination is only
+  // known once the block runs.
+  void AddBlockExit(JitBlock& block, const JitBlock::LinkData& exit);
 
   // Look for the block in the slow but accurate way.
   // This function shall be used if FastLookupIndexForAddress() failed.
@@ -150,6 +163,13 @@ public:
   void InvalidateICache(u32 address, u32 length, bool forced);
   void ErasePhysicalRange(u32 address, u32 length);
 
+  // Destroys all blocks which were compiled into the given code region, so that the JIT can
+  // reuse it. Their addresses are remembered until the next Clear(), see WasEvicted().
+  void EraseCodeRegion(u32 region);
+  // Whether a block starting at this address was destroyed by EraseCodeRegion(). If it is
+  // compiled again, it was still in use after its region aged out.
+  bool WasEvicted(u32 em_address) const;
+
   u32* GetBlockBitSet() const;
 
 protected:
@@ -183,6 +203,9 @@ private:
   static constexpr u32 BLOCK_RANGE_MAP_ELEMENTS = 0x100;
   std::map<u32, std::set<JitBlock*>> block_range_map;
 
+  // Effective addresses of the blocks destroyed by EraseCodeRegion().
+  std::set<u32> evicted_addresses;
+
   // This bitsets shows which cachelines overlap with any blocks.
   // It is used to provide a fast way to query if no icache invalidation is needed.
   ValidBlockBitSet valid_block;
@@ -22,8 +22,10 @@
 #include "Common/MsgHandler.h"
 
 #include "Core/Core.h"
+#include "Core/HLE/HLE_Native.h"
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/MMU.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
@@ -47,8 +49,12 @@ void SetJit(JitBase* jit)
 }
 void DoState(PointerWrap& p)
 {
-  if (g_jit && p.GetMode() == PointerWrap::MODE_READ)
+  if (p.GetMode() != PointerWrap::MODE_READ)
+    return;
+
+  if (g_jit)
     g_jit->ClearCache();
+  Interpreter::getInstance()->ClearCache();
 }
 CPUCoreBase* InitJitCore(PowerPC::CPUCore core)
 {
@@ -115,6 +121,17 @@ void WriteProfileResults(const std::string& filename)
             name.c_str(), stat.run_count, stat.cost, stat.tick_counter, percent, timePercent,
             (double)stat.tick_counter * 1000.0 / (double)prof_stats.countsPerSec, stat.block_size);
   }
+  fprintf(f.GetHandle(),
+          "\nreturnHits\treturnMisses\tinlineCacheHits\tinlineCacheMisses\n%" PRIu64 "\t%" PRIu64
+          "\t%" PRIu64 "\t%" PRIu64 "\n",
+          prof_stats.return_hits, prof_stats.return_misses, prof_stats.inline_cache_hits,
+          prof_stats.inline_cache_misses);
+  fprintf(f.GetHandle(), "\nhleFunction\thits\tmisses\n");
+  for (auto& stat : prof_stats.hle_function_stats)
+  {
+    fprintf(f.GetHandle(), "%s\t%" PRIu64 "\t%" PRIu64 "\n", stat.name, stat.hits,
+            stat.misses);
+  }
 }
 
 void GetProfileResults(Profiler::ProfileStats* prof_stats)
@@ -125,6 +142,10 @@ void GetProfileResults(Profiler::ProfileStats* prof_stats)
 
   prof_stats->cost_sum = 0;
   prof_stats->timecost_sum = 0;
+  prof_stats->return_hits = 0;
+  prof_stats->return_misses = 0;
+  prof_stats->inline_cache_hits = 0;
+  prof_stats->inline_cache_misses = 0;
   prof_stats->block_stats.clear();
 
   Core::State old_state = Core::GetState();
@@ -142,9 +163,14 @@ void GetProfileResults(Profiler::ProfileStats* prof_stats)
                                            block.codeSize);
     prof_stats->cost_sum += cost;
     prof_stats->timecost_sum += timecost;
+    prof_stats->return_hits += data.returnHits;
+    prof_stats->return_misses += data.returnMisses;
+    prof_stats->inline_cache_hits += data.inlineCacheHits;
+    prof_stats->inline_cache_misses += data.inlineCacheMisses;
   });
 
   sort(prof_stats->block_stats.begin(), prof_stats->block_stats.end());
+  prof_stats->hle_function_stats = HLE_Native::GetStats();
   if (old_state == Core::State::Running)
     Core::SetState(Core::State::Running);
 }
@@ -213,17 +239,20 @@ void ClearCache()
 {
   if (g_jit)
     g_jit->ClearCache();
+  Interpreter::getInstance()->ClearCache();
 }
 void ClearSafe()
 {
   if (g_jit)
     g_jit->GetBlockCache()->Clear();
+  Interpreter::getInstance()->ClearCache();
 }
 
 void InvalidateICache(u32 address, u32 size, bool forced)
 {
   if (g_jit)
     g_jit->GetBlockCache()->InvalidateICache(address, size, forced);
+  Interpreter::getInstance()->InvalidateICache(address, size);
 }
 
 void CompileExceptionCheck(ExceptionType type)
@@ -1049,6 +1049,9 @@ static void UpdateTLBEntry(const XCheckTLBFlag flag, UPTE2 PTE2, const u32 addre
   const int tag = address >> HW_PAGE_INDEX_SHIFT;
   TLBEntry& tlbe = ppcState.tlb[IsOpcodeFlag(flag)][tag & HW_PAGE_INDEX_MASK];
   const int index = tlbe.recent == 0 && tlbe.tag[0] != TLBEntry::INVALID_TAG;
+  // Fastmem mappings of the page table only live as long as their data TLB entry.
+  if (!IsOpcodeFlag(flag) && tlbe.tag[index] != TLBEntry::INVALID_TAG)
+    Memory::UnmapPageTablePage(tlbe.tag[index] << HW_PAGE_INDEX_SHIFT);
   tlbe.recent = index;
   tlbe.paddr[index] = PTE2.RPN << HW_PAGE_INDEX_SHIFT;
   tlbe.pte[index] = PTE2.Hex;
@@ -1060,6 +1063,11 @@ void InvalidateTLBEntry(u32 address)
   const u32 entry_index = (address >> HW_PAGE_INDEX_SHIFT) & HW_PAGE_INDEX_MASK;
 
   TLBEntry& tlbe = ppcState.tlb[0][entry_index];
+  for (u32 tag : tlbe.tag)
+  {
+    if (tag != TLBEntry::INVALID_TAG)
+      Memory::UnmapPageTablePage(tag << HW_PAGE_INDEX_SHIFT);
+  }
   tlbe.tag[0] = TLBEntry::INVALID_TAG;
   tlbe.tag[1] = TLBEntry::INVALID_TAG;
 
@@ -1300,6 +1308,29 @@ static TranslateAddressResult TranslateAddress(u32 address)
   return TranslatePageAddress(address, flag);
 }
 
+bool MapPageForFastmem(u32 address, bool write)
+{
+  if (!MSR.DR || memchecks.OverlapsMemcheck(address & ~(HW_PAGE_SIZE - 1), HW_PAGE_SIZE))
+    return false;
+
+  // Translate the same way the slow path would, which also updates the TLB and the R and C bits.
+  const TranslateAddressResult result = write ? TranslateAddress<XCheckTLBFlag::Write>(address) :
+                                                TranslateAddress<XCheckTLBFlag::Read>(address);
+  if (result.result != TranslateAddressResult::PAGE_TABLE_TRANSLATED)
+    return false;
+
+  // Until the C bit is set, writes have to go through the slow path to set it.
+  const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
+  const TLBEntry& tlbe = ppcState.tlb[0][tag & HW_PAGE_INDEX_MASK];
+  const int index = tlbe.tag[0] == tag ? 0 : 1;
+  if (tlbe.tag[index] != tag)
+    return false;
+
+  UPTE2 PTE2;
+  PTE2.Hex = tlbe.pte[index];
+  return Memory::MapPageTablePage(address, result.address, PTE2.C != 0);
+}
+
 std::optional<u32> GetTranslatedAddress(u32 address)
 {
   auto result = TranslateAddress<XCheckTLBFlag::NoException>(address);
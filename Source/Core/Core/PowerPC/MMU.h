@@ -88,6 +88,11 @@ void InvalidateTLBEntry(u32 address);
 void DBATUpdated();
 void IBATUpdated();
 
+// Called by the JIT when a fastmem access through the logical view faults. If the address is
+// translated by the page table to RAM, maps its page into the view so that the access can be
+// retried, and returns true. Otherwise, the access has to take the slow path.
+bool MapPageForFastmem(u32 address, bool write);
+
 // Result changes based on the BAT registers and MSR.DR.  Returns whether
 // it's safe to optimize a read or write to this address to an unguarded
 // memory access.  Does not consider page tables.
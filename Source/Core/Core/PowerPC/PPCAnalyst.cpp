@@ -5,6 +5,7 @@
 #include "Core/PowerPC/PPCAnalyst.h"
 
 #include <algorithm>
+#include <bitset>
 #include <map>
 #include <queue>
 #include <string>
@@ -674,57 +675,185 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code, const Gekk
   }
 }
 
-bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instructions)
+// Whether the instruction has no effect other than on the GPRs, CR and CA, which IsBusyWaitLoop()
+// tracks. Loads are fine, as MMIO registers and memory written by DMA or interrupt handlers only
+// change when events run.
+static bool IsBusyWaitInstruction(const CodeOp& op)
 {
-  // Very basic algorithm to detect busy wait loops:
-  //   * It loops to itself and does not contain any other branches.
-  //   * It does not write to memory.
-  //   * It only reads from registers it wrote to earlier in the loop, or it
-  //     does not write to these registers.
+  if (op.opinfo->type == OpType::Integer || op.opinfo->type == OpType::Load)
+    return true;
+
+  if (op.inst.OPCD == 31)
+  {
+    switch (op.inst.SUBOP10)
+    {
+    case 83:   // mfmsr
+    case 246:  // dcbtst
+    case 278:  // dcbt
+    case 598:  // sync
+    case 854:  // eieio
+      return true;
+    }
+  }
+  return op.inst.OPCD == 19 && op.inst.SUBOP10 == 150;  // isync
+}
+
+bool PPCAnalyzer::IsBusyWaitLoop(u32 loop_start, u32 branch_address)
+{
+  // Detects loops which can't make progress until an event or interrupt changes what they poll:
+  //   * The loop only reads from registers it wrote to earlier in the loop, or it does not write
+  //     to these registers. The same goes for CR fields and CA. So every iteration does the same.
+  //   * It does not write to memory or system registers, see IsBusyWaitInstruction().
+  //   * Calls to leaf functions which follow these rules are inlined, as many busy loops are
+  //     bl/cmp/bne loops polling DSP or VI registers through a helper like DSPCheckMailFromDSP.
+  //   * Conditional branches may only leave the loop, and unconditional branches may only jump
+  //     forward within it. Loops counting down CTR end by themselves.
   //
-  // Would benefit a lot from basic inlining support - a lot of the most
-  // used busy loops are DSP register interactions, which are bl/cmp/bne
-  // (with the bl target a pure function that follows the above rules). We
-  // don't detect these at the moment.
+  // The code is read from memory rather than taken from the block being analyzed, so the loop
+  // doesn't need to start at the beginning of the block, and calls are inlined whether or not
+  // OPTION_BRANCH_FOLLOW is set.
+  constexpr u32 MAX_LOOP_INSTRUCTIONS = 64;
+
+  if (loop_start > branch_address)
+    return false;
+
+  // SetInstructionStats() also collects register statistics, which are irrelevant here.
+  BlockRegStats gpa{};
+  BlockRegStats fpa{};
+  CodeBlock scratch_block;
+  scratch_block.m_gpa = &gpa;
+  scratch_block.m_fpa = &fpa;
+
   std::bitset<32> write_disallowed_regs;
   std::bitset<32> written_regs;
-  for (size_t i = 0; i <= instructions; ++i)
-  {
-    if (code[i].opinfo->type == OpType::Branch)
+  std::bitset<8> write_disallowed_crs;
+  std::bitset<8> written_crs;
+  bool write_disallowed_ca = false;
+  bool written_ca = false;
+  u32 num_instructions = 0;
+
+  const auto read_instruction = [&](u32 address, CodeOp* op) {
+    if (++num_instructions > MAX_LOOP_INSTRUCTIONS)
+      return false;
+    const auto result = PowerPC::TryReadInstruction(address);
+    if (!result.valid)
+      return false;
+    *op = {};
+    op->inst = result.hex;
+    op->opinfo = PPCTables::GetOpInfo(op->inst);
+    op->address = address;
+    SetInstructionStats(&scratch_block, op, op->opinfo, 0);
+    return true;
+  };
+
+  const auto read_cr = [&](u32 crf) {
+    if (!written_crs[crf])
+      write_disallowed_crs[crf] = true;
+  };
+
+  // Tracks the inputs and outputs of an instruction which isn't a branch.
+  const auto check_instruction = [&](const CodeOp& op) {
+    if (!IsBusyWaitInstruction(op))
+      return false;
+
+    for (int reg : op.regsIn)
+    {
+      if (!written_regs[reg])
+        write_disallowed_regs[reg] = true;
+    }
+    if (op.wantsCA && !written_ca)
+      write_disallowed_ca = true;
+
+    for (int reg : op.regsOut)
+    {
+      if (write_disallowed_regs[reg])
+        return false;
+      written_regs[reg] = true;
+    }
+    if (op.outputCA)
+    {
+      if (write_disallowed_ca)
+        return false;
+      written_ca = true;
+    }
+    const int crf_out = op.outputCR0 ? 0 : (op.opinfo->flags & FL_SET_CRn) ? op.inst.CRFD : -1;
+    if (crf_out >= 0)
+    {
+      if (write_disallowed_crs[crf_out])
+        return false;
+      written_crs[crf_out] = true;
+    }
+    return true;
+  };
+
+  // Inlines a call, which must be to a leaf function without branches other than its return.
+  const auto check_call = [&](u32 function) {
+    CodeOp op;
+    for (u32 address = function;; address += 4)
     {
-      if (code[i].branchUsesCtr)
+      if (!read_instruction(address, &op))
         return false;
-      if (code[i].branchTo == block->m_address && i == instructions)
+      if (op.inst.hex == 0x4e800020)  // blr
         return true;
+      if (op.opinfo->type == OpType::Branch || !check_instruction(op))
+        return false;
     }
-    else if (code[i].opinfo->type != OpType::Integer && code[i].opinfo->type != OpType::Load)
+  };
+
+  CodeOp op;
+  u32 address = loop_start;
+  while (true)
+  {
+    if (!read_instruction(address, &op))
+      return false;
+
+    if (op.opinfo->type != OpType::Branch)
     {
-      // In the future, some subsets of other instruction types might get
-      // supported. Right now, only try loops that have this very
-      // restricted instruction set.
+      if (!check_instruction(op))
+        return false;
+      address += 4;
+      continue;
+    }
+
+    if (op.branchUsesCtr)
       return false;
+
+    const bool conditional = (op.inst.BO & BO_DONT_CHECK_CONDITION) == 0;
+    if (op.inst.OPCD == 16 || op.inst.OPCD == 19)
+    {
+      if (op.inst.OPCD == 19 && op.inst.SUBOP10 != 16 && op.inst.SUBOP10 != 528)
+        return false;  // rfi and CR operations
+      if (conditional)
+        read_cr(op.inst.BI >> 2);
     }
-    else
+
+    if (address == branch_address)
+      return true;
+
+    if (op.inst.OPCD == 18)
     {
-      for (int reg : code[i].regsIn)
+      if (op.inst.LK)
       {
-        if (reg == -1)
-          continue;
-        if (written_regs[reg])
-          continue;
-        write_disallowed_regs[reg] = true;
+        if (!check_call(op.branchTo))
+          return false;
+        address += 4;
       }
-      for (int reg : code[i].regsOut)
+      else
       {
-        if (reg == -1)
-          continue;
-        if (write_disallowed_regs[reg])
+        if (op.branchTo <= address || op.branchTo > branch_address)
           return false;
-        written_regs[reg] = true;
+        address = op.branchTo;
       }
+      continue;
     }
+
+    // Any other branch must be a conditional exit from the loop.
+    if (op.inst.LK || !conditional || (op.inst.OPCD != 16 && op.inst.OPCD != 19))
+      return false;
+    if (op.inst.OPCD == 16 && op.branchTo >= loop_start && op.branchTo <= branch_address)
+      return false;
+    address += 4;
   }
-  return false;
 }
 
 u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std::size_t block_size)
@@ -875,8 +1004,8 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std:
       }
     }
 
-    code[i].branchIsIdleLoop =
-        code[i].branchTo == block->m_address && IsBusyWaitLoop(block, code, i);
+    code[i].branchIsIdleLoop = (inst.OPCD == 16 || inst.OPCD == 18) && !inst.LK &&
+                               IsBusyWaitLoop(code[i].branchTo, code[i].address);
 
     if (follow && numFollows < BRANCH_FOLLOWING_THRESHOLD)
     {
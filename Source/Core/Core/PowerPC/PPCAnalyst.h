@@ -214,7 +214,7 @@ private:
   void ReorderInstructionsCore(u32 instructions, CodeOp* code, bool reverse, ReorderType type);
   void ReorderInstructions(u32 instructions, CodeOp* code);
   void SetInstructionStats(CodeBlock* block, CodeOp* code, const GekkoOPInfo* opinfo, u32 index);
-  bool IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instructions);
+  bool IsBusyWaitLoop(u32 loop_start, u32 branch_address);
 
   // Options
   u32 m_options = 0;
@@ -22,6 +22,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/CPU.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/Host.h"
 #include "Core/PowerPC/CPUCoreBase.h"
@@ -267,6 +268,7 @@ void Reset()
   ppcState.pagetable_base = 0;
   ppcState.pagetable_hashmask = 0;
   ppcState.tlb = {};
+  Memory::ClearPageTableMappings();
 
   ResetRegisters();
   ppcState.iCache.Reset();
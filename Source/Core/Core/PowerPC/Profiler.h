@@ -26,12 +26,25 @@ struct BlockStat
 
   bool operator<(const BlockStat& other) const { return cost > other.cost; }
 };
+struct HLEFunctionStat
+{
+  const char* name;
+  // Calls run natively, and calls which had to run the guest code.
+  u64 hits;
+  u64 misses;
+};
 struct ProfileStats
 {
   std::vector<BlockStat> block_stats;
   u64 cost_sum;
   u64 timecost_sum;
   u64 countsPerSec;
+  // Totals of the branch prediction counters of the blocks.
+  u64 return_hits;
+  u64 return_misses;
+  u64 inline_cache_hits;
+  u64 inline_cache_misses;
+  std::vector<HLEFunctionStat> hle_function_stats;
 };
 
 }  // namespace Profiler
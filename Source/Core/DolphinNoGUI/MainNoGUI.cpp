@@ -5,21 +5,30 @@
 #include "DolphinNoGUI/Platform.h"
 
 #include <OptionParser.h>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdio>
 #include <cstring>
+#include <list>
 #include <signal.h>
 #include <string>
+#include <variant>
 #ifndef _WIN32
 #include <unistd.h>
 #else
 #include <Windows.h>
 #endif
 
+#include "Common/Config/Config.h"
 #include "Common/StringUtil.h"
+#include "Common/Thread.h"
 #include "Core/Analytics.h"
 #include "Core/Boot/Boot.h"
 #include "Core/BootManager.h"
+#include "Core/Config/GraphicsSettings.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/Host.h"
 
@@ -34,6 +43,12 @@
 
 static std::unique_ptr<Platform> s_platform;
 
+// FIFO batch replay statistics. The time is measured from the first presented frame, so that
+// loading the log isn't counted.
+static std::atomic<u32> s_fifo_frames_presented{0};
+static std::chrono::steady_clock::time_point s_fifo_start_time;
+static std::chrono::steady_clock::time_point s_fifo_end_time;
+
 static void signal_handler(int)
 {
   const char message[] = "A signal was received. A second signal will force Dolphin to stop.\n";
@@ -135,6 +150,113 @@ static std::unique_ptr<Platform> GetPlatform(const optparse::Values& options)
   return nullptr;
 }
 
+// Settings which are only changed for this run. SConfig saves these on shutdown, so they are put
+// back before that happens.
+struct SavedRunSettings
+{
+  float emulation_speed;
+  std::string audio_backend;
+  bool loop_fifo_replay;
+  bool dump_frames;
+  bool dump_frames_silent;
+};
+
+static SavedRunSettings SaveRunSettings()
+{
+  const SConfig& config = SConfig::GetInstance();
+  return {config.m_EmulationSpeed, config.sBackend, config.bLoopFifoReplay, config.m_DumpFrames,
+          config.m_DumpFramesSilent};
+}
+
+static void RestoreRunSettings(const SavedRunSettings& settings)
+{
+  SConfig& config = SConfig::GetInstance();
+  config.m_EmulationSpeed = settings.emulation_speed;
+  config.sBackend = settings.audio_backend;
+  config.bLoopFifoReplay = settings.loop_fifo_replay;
+  config.m_DumpFrames = settings.dump_frames;
+  config.m_DumpFramesSilent = settings.dump_frames_silent;
+}
+
+static void SetupFifoBatchReplay()
+{
+  // Replay the log once, without any frame limiting or audio.
+  SConfig& config = SConfig::GetInstance();
+  config.m_EmulationSpeed = 0.0f;
+  config.sBackend = BACKEND_NULLSOUND;
+  config.bLoopFifoReplay = false;
+
+  // Count the frames the GPU presented rather than the ones the FIFO player wrote, which in dual
+  // core mode are only queued for the GPU thread.
+  Core::SetOnFramePresentedCallback([] {
+    const auto now = std::chrono::steady_clock::now();
+    if (s_fifo_frames_presented++ == 0)
+      s_fifo_start_time = now;
+    s_fifo_end_time = now;
+  });
+}
+
+static void ReportFifoBatchReplay()
+{
+  Core::SetOnFramePresentedCallback({});
+
+  // The time is measured from the first presented frame to the last one.
+  const u32 frames = s_fifo_frames_presented.load();
+  const double seconds =
+      std::chrono::duration<double>(s_fifo_end_time - s_fifo_start_time).count();
+  if (frames < 2 || seconds <= 0.0)
+  {
+    fprintf(stderr, "Not enough frames were presented\n");
+    return;
+  }
+
+  fprintf(stdout, "Presented %u frames in %.3f seconds (%.2f FPS)\n", frames, seconds,
+          (frames - 1) / seconds);
+}
+
+static void SetupFrameDumping(const std::string& mode)
+{
+  SConfig& config = SConfig::GetInstance();
+  config.m_DumpFrames = true;
+  config.m_DumpFramesSilent = true;
+
+  Config::SetCurrent(Config::GFX_DUMP_FRAMES_AS_IMAGES, mode == "images");
+  Config::SetCurrent(Config::GFX_DUMP_FRAME_HASHES, mode == "hashes");
+}
+
+// Applies <cpu|gpu|dsp|dvd|all>=<processors> arguments, which pin emulation threads to processors.
+static bool SetupThreadAffinity(const std::list<std::string>& arguments)
+{
+  for (const std::string& argument : arguments)
+  {
+    const size_t separator = argument.find('=');
+    const std::string thread = argument.substr(0, separator);
+    const std::string processors =
+        separator == std::string::npos ? "" : argument.substr(separator + 1);
+    if (thread != "cpu" && thread != "gpu" && thread != "dsp" && thread != "dvd" &&
+        thread != "all")
+    {
+      fprintf(stderr, "Invalid thread: %s\n", argument.c_str());
+      return false;
+    }
+    if (!Common::ParseProcessorList(processors))
+    {
+      fprintf(stderr, "Invalid processor list: %s\n", argument.c_str());
+      return false;
+    }
+
+    if (thread == "cpu" || thread == "all")
+      Config::SetCurrent(Config::MAIN_CPU_THREAD_AFFINITY, processors);
+    if (thread == "gpu" || thread == "all")
+      Config::SetCurrent(Config::MAIN_GPU_THREAD_AFFINITY, processors);
+    if (thread == "dsp" || thread == "all")
+      Config::SetCurrent(Config::MAIN_DSP_THREAD_AFFINITY, processors);
+    if (thread == "dvd" || thread == "all")
+      Config::SetCurrent(Config::MAIN_DVD_THREAD_AFFINITY, processors);
+  }
+  return true;
+}
+
 int main(int argc, char* argv[])
 {
   auto parser = CommandLineParse::CreateParser(CommandLineParse::ParserOptions::OmitGUIOptions);
@@ -156,6 +278,17 @@ int main(int argc, char* argv[])
             "win32"
 #endif
       });
+  parser->add_option("--fifo-batch")
+      .action("store_true")
+      .help("Replay a FIFO log once as fast as possible, then report the frame rate and exit");
+  parser->add_option("--dump-frames")
+      .action("store")
+      .choices({"images", "hashes"})
+      .help("Dump every rendered frame to the Dump/Frames folder, as [%choices]");
+  parser->add_option("--thread-affinity")
+      .action("append")
+      .metavar("<cpu|gpu|dsp|dvd|all>=<processors>")
+      .help("Pin an emulation thread to processors such as 0-3,8, or to a NUMA node with node:N");
 
   optparse::Values& options = CommandLineParse::ParseArguments(parser.get(), argc, argv);
   std::vector<std::string> args = parser->args();
@@ -191,6 +324,13 @@ int main(int argc, char* argv[])
     return 0;
   }
 
+  const bool fifo_batch = static_cast<bool>(options.get("fifo_batch"));
+  if (fifo_batch && (!boot || !std::holds_alternative<BootParameters::DFF>(boot->parameters)))
+  {
+    fprintf(stderr, "--fifo-batch needs a FIFO log (.dff) to replay\n");
+    return 1;
+  }
+
   std::string user_directory;
   if (options.is_set("user"))
     user_directory = static_cast<const char*>(options.get("user"));
@@ -198,6 +338,12 @@ int main(int argc, char* argv[])
   UICommon::SetUserDirectory(user_directory);
   UICommon::Init();
 
+  if (options.is_set("thread_affinity") && !SetupThreadAffinity(options.all("thread_affinity")))
+  {
+    parser->print_help();
+    return 1;
+  }
+
   s_platform = GetPlatform(options);
   if (!s_platform || !s_platform->Init())
   {
@@ -225,6 +371,12 @@ int main(int argc, char* argv[])
 
   DolphinAnalytics::Instance().ReportDolphinStart("nogui");
 
+  const SavedRunSettings saved_settings = SaveRunSettings();
+  if (fifo_batch)
+    SetupFifoBatchReplay();
+  if (options.is_set("dump_frames"))
+    SetupFrameDumping(static_cast<const char*>(options.get("dump_frames")));
+
   if (!BootManager::BootCore(std::move(boot), s_platform->GetWindowSystemInfo()))
   {
     fprintf(stderr, "Could not boot the specified file\n");
@@ -240,6 +392,11 @@ int main(int argc, char* argv[])
 
   Core::Shutdown();
   s_platform.reset();
+
+  if (fifo_batch)
+    ReportFifoBatchReplay();
+
+  RestoreRunSettings(saved_settings);
   UICommon::Shutdown();
 
   return 0;
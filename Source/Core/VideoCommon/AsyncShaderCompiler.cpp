@@ -75,6 +75,9 @@ void AsyncShaderCompiler::WaitUntilCompletion(
   if (!HasPendingWork())
     return;
 
+  // Items which complete during the first second are counted towards the progress.
+  const size_t start_completed_items = m_num_completed_items.load();
+
   // Wait a second before opening a progress dialog.
   // This way, if the operation completes quickly, we don't annoy the user.
   constexpr u32 CHECK_INTERVAL_MS = 1000 / 30;
@@ -86,16 +89,8 @@ void AsyncShaderCompiler::WaitUntilCompletion(
       return;
   }
 
-  // Grab the number of pending items. We use this to work out how many are left.
-  size_t total_items = 0;
-  {
-    // Safe to hold both locks here, since nowhere else does.
-    std::lock_guard<std::mutex> pending_guard(m_pending_work_lock);
-    std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
-    total_items = m_completed_work.size() + m_pending_work.size() + m_busy_workers.load() + 1;
-  }
-
-  // Update progress while the compiles complete.
+  // Update progress while the compiles complete. The callback can queue more work, so the total
+  // is worked out again every time.
   for (;;)
   {
     size_t remaining_items;
@@ -103,10 +98,11 @@ void AsyncShaderCompiler::WaitUntilCompletion(
       std::lock_guard<std::mutex> pending_guard(m_pending_work_lock);
       if (m_pending_work.empty() && !m_busy_workers.load())
         break;
-      remaining_items = m_pending_work.size();
+      remaining_items = m_pending_work.size() + m_busy_workers.load();
     }
 
-    progress_callback(total_items - remaining_items, total_items);
+    const size_t completed_items = m_num_completed_items.load() - start_completed_items;
+    progress_callback(completed_items, completed_items + remaining_items);
     std::this_thread::sleep_for(CHECK_INTERVAL);
   }
 }
@@ -229,6 +225,7 @@ void AsyncShaderCompiler::WorkerThreadRun()
         std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
         m_completed_work.push_back(std::move(item));
       }
+      m_num_completed_items++;
 
       pending_lock.lock();
       m_busy_workers--;
@@ -53,7 +53,8 @@ public:
   // Simpler version without progress updates.
   void WaitUntilCompletion();
 
-  // Calls progress_callback periodically, with completed_items, and total_items.
+  // Calls progress_callback periodically, with completed_items, and total_items. The callback may
+  // retrieve work items, and queue more work, which is then included in the total.
   void WaitUntilCompletion(const std::function<void(size_t, size_t)>& progress_callback);
 
   // Needed because of calling virtual methods in shutdown procedure.
@@ -83,6 +84,7 @@ private:
   std::mutex m_pending_work_lock;
   std::condition_variable m_worker_thread_wake;
   std::atomic_size_t m_busy_workers{0};
+  std::atomic_size_t m_num_completed_items{0};
 
   std::deque<WorkItemPtr> m_completed_work;
   std::mutex m_completed_work_lock;
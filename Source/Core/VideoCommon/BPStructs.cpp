@@ -32,6 +32,7 @@
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoCommon.h"
@@ -87,6 +88,9 @@ static void BPWritten(const BPCmd& bp)
 
   ((u32*)&bpmem)[bp.address] = bp.newvalue;
 
+  if (BPRegisterAffectsPixelShaderUid(bp.address))
+    g_vertex_manager->SetPixelShaderUidChanged();
+
   switch (bp.address)
   {
   case BPMEM_GENMODE:  // Set the Generation Mode
@@ -97,7 +101,10 @@ static void BPWritten(const BPCmd& bp)
              (u32)bpmem.genMode.zfreeze);
 
     if (bp.changes)
+    {
       PixelShaderManager::SetGenModeChanged();
+      g_vertex_manager->SetVertexShaderUidChanged();
+    }
 
     // Only call SetGenerationMode when cull mode changes.
     if (bp.changes & 0xC000)
@@ -1446,6 +1453,30 @@ void GetBPRegInfo(const u8* data, std::string* name, std::string* desc)
   }
 }
 
+bool BPRegisterAffectsPixelShaderUid(u32 address)
+{
+  switch (address)
+  {
+  case BPMEM_GENMODE:
+  case BPMEM_IREF:
+  case BPMEM_ZMODE:
+  case BPMEM_BLENDMODE:
+  case BPMEM_CONSTANTALPHA:
+  case BPMEM_ZCOMPARE:
+  case BPMEM_FOGRANGE:
+  case BPMEM_FOGPARAM3:
+  case BPMEM_ALPHACOMPARE:
+  case BPMEM_ZTEX2:
+    return true;
+
+  default:
+    return (address >= BPMEM_IND_CMD && address < BPMEM_IND_CMD + 16) ||
+           (address >= BPMEM_TREF && address < BPMEM_TREF + 8) ||
+           (address >= BPMEM_TEV_COLOR_ENV && address < BPMEM_TEV_COLOR_ENV + 32) ||
+           (address >= BPMEM_TEV_KSEL && address < BPMEM_TEV_KSEL + 8);
+  }
+}
+
 // Called when loading a saved state.
 void BPReload()
 {
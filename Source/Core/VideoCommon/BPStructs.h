@@ -4,5 +4,10 @@
 
 #pragma once
 
+#include "Common/CommonTypes.h"
+
 void BPInit();
 void BPReload();
+
+// Whether a write to the given BP register can change the result of GetPixelShaderUid.
+bool BPRegisterAffectsPixelShaderUid(u32 address);
@@ -90,7 +90,7 @@ union TVtxDesc
   };
 
   // Easily index into the Position..Tex7Coord fields.
-  u32 GetVertexArrayStatus(int idx) { return (Hex >> (9 + idx * 2)) & 0x3; }
+  u32 GetVertexArrayStatus(int idx) const { return (Hex >> (9 + idx * 2)) & 0x3; }
 };
 
 union UVAT_group0
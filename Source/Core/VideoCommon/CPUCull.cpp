@@ -0,0 +1,108 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/CPUCull.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <xmmintrin.h>
+#endif
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/VideoConfig.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace
+{
+// projection * position matrix, stored as columns so that a vertex is transformed with three
+// multiply-adds of whole columns.
+struct alignas(16) TransformMatrix
+{
+  std::array<float, 16> columns;
+};
+
+TransformMatrix CombineMatrices(const std::array<float, 16>& projection, u32 mtx_idx)
+{
+  const float* world = &xfmem.posMatrices[(mtx_idx & 0x3f) * 4];
+
+  TransformMatrix result;
+  for (int row = 0; row < 4; row++)
+  {
+    const float* proj_row = &projection[row * 4];
+    for (int col = 0; col < 4; col++)
+    {
+      float value = proj_row[0] * world[col] + proj_row[1] * world[4 + col] +
+                    proj_row[2] * world[8 + col];
+      if (col == 3)
+        value += proj_row[3];
+      result.columns[col * 4 + row] = value;
+    }
+  }
+  return result;
+}
+}  // Anonymous namespace
+
+bool CPUCull::TransformVertices(const u8* vertices, u32 count,
+                                const PortableVertexDeclaration& vtx_decl)
+{
+  // Free look and stereoscopy move the geometry after the XF transform.
+  if (g_ActiveConfig.bFreeLook || g_ActiveConfig.stereo_mode != StereoMode::Off)
+    return false;
+  if (!vtx_decl.position.enable || vtx_decl.position.type != VAR_FLOAT)
+    return false;
+
+  m_cull_back = bpmem.genMode.cullmode == GenMode::CULL_BACK;
+  m_cull_front = bpmem.genMode.cullmode == GenMode::CULL_FRONT;
+  m_keep_degenerate = g_ActiveConfig.bWireFrame;
+
+  const std::array<float, 16> projection = VertexShaderManager::GetProjectionMatrix();
+  std::array<TransformMatrix, 64> matrices;
+  u64 valid_matrices = 0;
+
+  if (m_positions.size() < count)
+    m_positions.resize(count);
+
+  const bool has_z = vtx_decl.position.components >= 3;
+  const u32 default_mtx_idx = g_main_cp_state.matrix_index_a.PosNormalMtxIdx;
+  const u8* position_ptr = vertices + vtx_decl.position.offset;
+  const u8* posmtx_ptr = vtx_decl.posmtx.enable ? vertices + vtx_decl.posmtx.offset : nullptr;
+
+  for (u32 i = 0; i < count; i++)
+  {
+    const u32 mtx_idx = (posmtx_ptr ? posmtx_ptr[i * vtx_decl.stride] : default_mtx_idx) & 0x3f;
+    if (!(valid_matrices & (1ULL << mtx_idx)))
+    {
+      matrices[mtx_idx] = CombineMatrices(projection, mtx_idx);
+      valid_matrices |= 1ULL << mtx_idx;
+    }
+    const float* m = matrices[mtx_idx].columns.data();
+
+    float position[3];
+    std::memcpy(position, position_ptr + i * vtx_decl.stride, (has_z ? 3 : 2) * sizeof(float));
+    if (!has_z)
+      position[2] = 0.0f;
+
+#if defined(_M_X86) || defined(_M_X86_64)
+    __m128 out = _mm_load_ps(m + 12);
+    out = _mm_add_ps(out, _mm_mul_ps(_mm_load_ps(m), _mm_set1_ps(position[0])));
+    out = _mm_add_ps(out, _mm_mul_ps(_mm_load_ps(m + 4), _mm_set1_ps(position[1])));
+    out = _mm_add_ps(out, _mm_mul_ps(_mm_load_ps(m + 8), _mm_set1_ps(position[2])));
+    _mm_store_ps(&m_positions[i].x, out);
+#else
+    ClipPosition& out = m_positions[i];
+    out.x = m[0] * position[0] + m[4] * position[1] + m[8] * position[2] + m[12];
+    out.y = m[1] * position[0] + m[5] * position[1] + m[9] * position[2] + m[13];
+    out.z = m[2] * position[0] + m[6] * position[1] + m[10] * position[2] + m[14];
+    out.w = m[3] * position[0] + m[7] * position[1] + m[11] * position[2] + m[15];
+#endif
+  }
+
+  return true;
+}
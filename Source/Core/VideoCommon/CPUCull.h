@@ -0,0 +1,72 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+struct PortableVertexDeclaration;
+
+// Transforms the positions of freshly loaded vertices on the CPU, so that triangles the GPU would
+// throw away anyway (back-facing, zero-area or entirely off-screen) don't take up index buffer
+// space and draw call bandwidth.
+class CPUCull
+{
+public:
+  // Returns false if culling isn't possible in the current state, in which case
+  // IsTriangleVisible must not be called.
+  bool TransformVertices(const u8* vertices, u32 count, const PortableVertexDeclaration& vtx_decl);
+
+  // The indices are relative to the vertices passed to the last TransformVertices call, and are in
+  // the order the index generator emits them.
+  bool IsTriangleVisible(u32 index0, u32 index1, u32 index2) const
+  {
+    const ClipPosition& v0 = m_positions[index0];
+    const ClipPosition& v1 = m_positions[index1];
+    const ClipPosition& v2 = m_positions[index2];
+
+    // Homogeneous clip test against the side planes, so it also holds for vertices behind the
+    // camera. Near/far are left to the GPU, as depth clamping may keep those triangles visible.
+    if ((IsOutside(v0.x, v0.w) && IsOutside(v1.x, v1.w) && IsOutside(v2.x, v2.w)) ||
+        (IsOutside(-v0.x, v0.w) && IsOutside(-v1.x, v1.w) && IsOutside(-v2.x, v2.w)) ||
+        (IsOutside(v0.y, v0.w) && IsOutside(v1.y, v1.w) && IsOutside(v2.y, v2.w)) ||
+        (IsOutside(-v0.y, v0.w) && IsOutside(-v1.y, v1.w) && IsOutside(-v2.y, v2.w)))
+    {
+      return false;
+    }
+
+    // The facing is only meaningful when no clipping against w = 0 is involved.
+    if (v0.w <= 0.0f || v1.w <= 0.0f || v2.w <= 0.0f)
+      return true;
+
+    // Same orientation test as the software renderer's clipper, where the faces GX considers
+    // back-facing end up with a positive normal.
+    const float normal_z_dir = (v0.x * v2.w - v2.x * v0.w) * v1.y +
+                               (v2.x * v0.y - v0.x * v2.y) * v1.w +
+                               (v2.y * v0.w - v0.y * v2.w) * v1.x;
+    if (normal_z_dir == 0.0f)
+      return m_keep_degenerate;
+
+    return normal_z_dir > 0.0f ? !m_cull_back : !m_cull_front;
+  }
+
+private:
+  struct alignas(16) ClipPosition
+  {
+    float x, y, z, w;
+  };
+
+  // Allows for the pixel center and viewport corrections done by the vertex shader.
+  static constexpr float CLIP_SLACK = 1.0f / 64.0f;
+
+  static bool IsOutside(float coord, float w) { return coord > w + CLIP_SLACK * std::fabs(w); }
+
+  std::vector<ClipPosition> m_positions;
+  bool m_cull_front = false;
+  bool m_cull_back = false;
+  bool m_keep_degenerate = false;
+};
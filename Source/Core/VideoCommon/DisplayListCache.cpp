@@ -0,0 +1,196 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/DisplayListCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+#include <xxhash.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace DisplayListCache
+{
+namespace
+{
+// Display lists which haven't been called for this many frames are removed.
+constexpr int DISPLAY_LIST_KILL_THRESHOLD = 64;
+
+// No more vertices are cached once this much converted vertex data is kept. The cache is then
+// emptied on the next cleanup.
+constexpr size_t MAX_CACHED_VERTEX_BYTES = 64 * 1024 * 1024;
+
+struct CachedVertices
+{
+  // Offset of the raw vertex data in the display list.
+  u32 offset;
+  const VertexLoaderBase* loader;
+  int raw_count;
+  int count;
+  std::vector<u8> data;
+
+  // The zfreeze state the vertex loader leaves behind.
+  float position_cache[3][4];
+  u32 position_matrix_index[4];
+};
+
+struct CachedDisplayList
+{
+  u64 hash = 0;
+  int last_used_frame = 0;
+
+  // Sorted by offset.
+  std::vector<CachedVertices> vertices;
+};
+
+std::unordered_map<u64, CachedDisplayList> s_cache;
+size_t s_cached_bytes = 0;
+int s_frame_count = 0;
+
+CachedDisplayList* s_current_list = nullptr;
+const u8* s_current_data = nullptr;
+
+void ClearVertices(CachedDisplayList& list)
+{
+  for (const CachedVertices& vertices : list.vertices)
+    s_cached_bytes -= vertices.data.size();
+  list.vertices.clear();
+}
+
+void Clear()
+{
+  s_cache.clear();
+  s_cached_bytes = 0;
+  s_current_list = nullptr;
+  s_current_data = nullptr;
+}
+}  // Anonymous namespace
+
+void Init()
+{
+  Clear();
+  s_frame_count = 0;
+}
+
+void Shutdown()
+{
+  Clear();
+}
+
+void Cleanup(int frame_count)
+{
+  s_frame_count = frame_count;
+
+  if (!g_ActiveConfig.bDisplayListCache || s_cached_bytes >= MAX_CACHED_VERTEX_BYTES)
+  {
+    Clear();
+  }
+  else
+  {
+    for (auto iter = s_cache.begin(); iter != s_cache.end();)
+    {
+      if (frame_count > iter->second.last_used_frame + DISPLAY_LIST_KILL_THRESHOLD)
+      {
+        ClearVertices(iter->second);
+        iter = s_cache.erase(iter);
+      }
+      else
+      {
+        ++iter;
+      }
+    }
+  }
+
+  SETSTAT(g_stats.num_display_lists_cached, s_cache.size());
+}
+
+void BeginDisplayList(u32 address, const u8* data, u32 size)
+{
+  if (!g_ActiveConfig.bDisplayListCache)
+    return;
+
+  const u64 key = (static_cast<u64>(address) << 32) | size;
+  const u64 hash = XXH64(data, size, 0);
+
+  auto [iter, inserted] = s_cache.try_emplace(key);
+  CachedDisplayList& list = iter->second;
+  if (!inserted && list.hash == hash)
+  {
+    INCSTAT(g_stats.this_frame.num_dlist_cache_hits);
+  }
+  else
+  {
+    // New list, or the game has written something else to the same place.
+    INCSTAT(g_stats.this_frame.num_dlist_cache_misses);
+    ClearVertices(list);
+    list.hash = hash;
+  }
+
+  list.last_used_frame = s_frame_count;
+  s_current_list = &list;
+  s_current_data = data;
+}
+
+void EndDisplayList()
+{
+  s_current_list = nullptr;
+  s_current_data = nullptr;
+}
+
+int RunVertexLoader(VertexLoaderBase* loader, DataReader src, DataReader dst, int count)
+{
+  if (!s_current_list || loader->UsesVertexArrays())
+    return loader->RunVertices(src, dst, count);
+
+  const u32 offset = static_cast<u32>(src.GetPointer() - s_current_data);
+  std::vector<CachedVertices>& cached = s_current_list->vertices;
+  auto iter = std::lower_bound(
+      cached.begin(), cached.end(), offset,
+      [](const CachedVertices& vertices, u32 value) { return vertices.offset < value; });
+  const bool found = iter != cached.end() && iter->offset == offset;
+
+  // The vertex loader only changes along with the vertex format, so it has to be checked.
+  if (found && iter->loader == loader && iter->raw_count == count)
+  {
+    std::memcpy(dst.GetPointer(), iter->data.data(), iter->data.size());
+    std::memcpy(VertexLoaderManager::position_cache, iter->position_cache,
+                sizeof(iter->position_cache));
+    std::memcpy(VertexLoaderManager::position_matrix_index, iter->position_matrix_index,
+                sizeof(iter->position_matrix_index));
+    loader->m_numLoadedVertices += iter->count;
+    return iter->count;
+  }
+
+  const int loaded = loader->RunVertices(src, dst, count);
+  if (s_cached_bytes >= MAX_CACHED_VERTEX_BYTES)
+    return loaded;
+
+  if (found)
+    s_cached_bytes -= iter->data.size();
+  else
+    iter = cached.emplace(iter);
+
+  const u8* const data = dst.GetPointer();
+  iter->offset = offset;
+  iter->loader = loader;
+  iter->raw_count = count;
+  iter->count = loaded;
+  iter->data.assign(data, data + loaded * loader->m_native_vtx_decl.stride);
+  std::memcpy(iter->position_cache, VertexLoaderManager::position_cache,
+              sizeof(iter->position_cache));
+  std::memcpy(iter->position_matrix_index, VertexLoaderManager::position_matrix_index,
+              sizeof(iter->position_matrix_index));
+  s_cached_bytes += iter->data.size();
+  return loaded;
+}
+}  // namespace DisplayListCache
@@ -0,0 +1,35 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+class DataReader;
+class VertexLoaderBase;
+
+// Keeps the converted vertex data of display lists which are called again and again, so that
+// static geometry doesn't go through the vertex loaders every frame. Register loads in the lists
+// are still executed every time, as their effects depend on the state at the time of the call.
+//
+// Entries are looked up by address and size, and checked against a hash of the whole list on
+// every call, like the texture cache does for textures. Only vertices that don't use indexed
+// attributes are cached, as those would also depend on the contents of the vertex arrays.
+namespace DisplayListCache
+{
+void Init();
+void Shutdown();
+
+// Removes the lists that haven't been called for a while. Called once per frame.
+void Cleanup(int frame_count);
+
+// Called around the interpretation of a display list. data is what gets interpreted, which may
+// be a copy of the list in deterministic GPU thread mode.
+void BeginDisplayList(u32 address, const u8* data, u32 size);
+void EndDisplayList();
+
+// Runs the vertex loader, or copies its previous output when the current display list has been
+// converted before with the same vertex loader. Returns the number of vertices written.
+int RunVertexLoader(VertexLoaderBase* loader, DataReader src, DataReader dst, int count);
+}  // namespace DisplayListCache
@@ -4,9 +4,11 @@
 
 #include "VideoCommon/Fifo.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 
+#include "Common/Align.h"
 #include "Common/Assert.h"
 #include "Common/Atomic.h"
 #include "Common/BlockingLoop.h"
@@ -26,15 +28,25 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/PixelEngine.h"
+#include "VideoCommon/StageTimings.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VideoBackendBase.h"
+#include "VideoCommon/VideoConfig.h"
 
 namespace Fifo
 {
 static constexpr u32 FIFO_SIZE = 2 * 1024 * 1024;
 static constexpr int GPU_TIME_SLOT_SIZE = 1000;
 
+// The most FIFO data which is parsed in place in emulated memory at once. Async requests from the
+// CPU thread are only handled in between.
+static constexpr u32 MAX_DIRECT_FIFO_READ = 64 * 1024;
+
+// Keeps pointers written by different threads from sharing a cache line.
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
 static Common::BlockingLoop s_gpu_mainloop;
 
 static Common::Flag s_emu_running_state;
@@ -53,9 +65,9 @@ static CoreTiming::EventType* s_event_sync_gpu;
 // STATE_TO_SAVE
 static u8* s_video_buffer;
 static u8* s_video_buffer_read_ptr;
-static std::atomic<u8*> s_video_buffer_write_ptr;
-static std::atomic<u8*> s_video_buffer_seen_ptr;
-static u8* s_video_buffer_pp_read_ptr;
+alignas(CACHE_LINE_SIZE) static std::atomic<u8*> s_video_buffer_write_ptr;
+alignas(CACHE_LINE_SIZE) static std::atomic<u8*> s_video_buffer_seen_ptr;
+alignas(CACHE_LINE_SIZE) static u8* s_video_buffer_pp_read_ptr;
 // The read_ptr is always owned by the GPU thread.  In normal mode, so is the
 // write_ptr, despite it being atomic.  In deterministic GPU thread mode,
 // things get a bit more complicated:
@@ -242,6 +254,71 @@ static void ReadDataFromFifo(u32 readPtr)
   s_video_buffer_write_ptr += len;
 }
 
+// Returns how much of the FIFO can be parsed in place in emulated memory, rather than copied to the
+// video buffer 32 bytes at a time, or 0 if none of it can.
+static u32 GetDirectFifoReadLength(u32 readPtr)
+{
+  const CommandProcessor::SCPFifoStruct& fifo = CommandProcessor::fifo;
+
+  // A command left over from the previous read has to be completed in the video buffer.
+  if (!g_ActiveConfig.bDirectFifoRead || s_video_buffer_read_ptr != s_video_buffer_write_ptr)
+    return 0;
+
+  // Breakpoints, the low watermark interrupt and the GPU sync act on every 32 bytes the GPU reads.
+  if (fifo.bFF_BPEnable || fifo.bFF_LoWatermarkInt || SConfig::GetInstance().bSyncGPU ||
+      readPtr > fifo.CPEnd)
+  {
+    return 0;
+  }
+
+  // The CPU doesn't write to the FIFO between the read and write pointers, but it can wrap around.
+  const u32 distance = fifo.CPReadWriteDistance;
+  u32 length = std::min({distance, fifo.CPEnd - readPtr + 32, MAX_DIRECT_FIFO_READ});
+
+  // Stop where the high watermark interrupt is cleared, so that the CPU can resume writing.
+  if (fifo.bFF_HiWatermarkInt && distance > fifo.CPHiWatermark)
+    length = std::min(length, Common::AlignUp(distance - fifo.CPHiWatermark, 32));
+
+  length &= ~31u;
+  if (length <= 32)
+    return 0;
+
+  // Only FIFOs in MEM1 are read in place. The opcode decoder may read a few bytes past the end.
+  if ((readPtr & 0x3FFFFFFF) + length + 4 > Memory::REALRAM_SIZE)
+    return 0;
+
+  return length;
+}
+
+// A command which isn't complete yet is copied to the video buffer, to be completed by the next
+// read.
+u32 RunFifoDirect(u32* cycles)
+{
+  const u32 length = GetDirectFifoReadLength(CommandProcessor::fifo.CPReadPointer);
+  if (length == 0)
+    return 0;
+
+  u8* const start = Memory::GetPointer(CommandProcessor::fifo.CPReadPointer);
+  u8* const end = start + length;
+  u8* read_ptr = start;
+  u8* block_end = start;
+  do
+  {
+    u32 block_cycles = 0;
+    block_end += 32;
+    read_ptr = OpcodeDecoder::Run(DataReader(read_ptr, block_end), &block_cycles, false);
+    *cycles += block_cycles;
+  } while (block_end != end && !CommandProcessor::IsInterruptWaiting() &&
+           !PixelEngine::IsTokenFinishEventPending());
+
+  const size_t remaining = block_end - read_ptr;
+  std::memcpy(s_video_buffer, read_ptr, remaining);
+  s_video_buffer_read_ptr = s_video_buffer;
+  s_video_buffer_write_ptr = s_video_buffer + remaining;
+
+  return static_cast<u32>(block_end - start);
+}
+
 // The deterministic_gpu_thread version.
 static void ReadDataFromFifoOnCPU(u32 readPtr)
 {
@@ -297,6 +374,7 @@ void RunGpuLoop()
 
   s_gpu_mainloop.Run(
       [] {
+        StageTimings::ScopedStage stage(StageTimings::Stage::Fifo);
         const SConfig& param = SConfig::GetInstance();
 
         // Run events from the CPU thread.
@@ -333,24 +411,30 @@ void RunGpuLoop()
 
             u32 cyclesExecuted = 0;
             u32 readPtr = fifo.CPReadPointer;
-            ReadDataFromFifo(readPtr);
+            const u32 direct_read_length = RunFifoDirect(&cyclesExecuted);
+            const u32 read_length = direct_read_length != 0 ? direct_read_length : 32;
+            if (direct_read_length == 0)
+              ReadDataFromFifo(readPtr);
 
-            if (readPtr == fifo.CPEnd)
+            if (readPtr + read_length - 32 == fifo.CPEnd)
               readPtr = fifo.CPBase;
             else
-              readPtr += 32;
+              readPtr += read_length;
 
-            ASSERT_MSG(COMMANDPROCESSOR, (s32)fifo.CPReadWriteDistance - 32 >= 0,
+            ASSERT_MSG(COMMANDPROCESSOR, (s32)fifo.CPReadWriteDistance - (s32)read_length >= 0,
                        "Negative fifo.CPReadWriteDistance = %i in FIFO Loop !\nThat can produce "
                        "instability in the game. Please report it.",
-                       fifo.CPReadWriteDistance - 32);
+                       fifo.CPReadWriteDistance - read_length);
 
             u8* write_ptr = s_video_buffer_write_ptr;
-            s_video_buffer_read_ptr = OpcodeDecoder::Run(
-                DataReader(s_video_buffer_read_ptr, write_ptr), &cyclesExecuted, false);
+            if (direct_read_length == 0)
+            {
+              s_video_buffer_read_ptr = OpcodeDecoder::Run(
+                  DataReader(s_video_buffer_read_ptr, write_ptr), &cyclesExecuted, false);
+            }
 
             Common::AtomicStore(fifo.CPReadPointer, readPtr);
-            Common::AtomicAdd(fifo.CPReadWriteDistance, static_cast<u32>(-32));
+            Common::AtomicAdd(fifo.CPReadWriteDistance, static_cast<u32>(-(s32)read_length));
             if ((write_ptr - s_video_buffer_read_ptr) == 0)
               Common::AtomicStore(fifo.SafeCPReadPointer, fifo.CPReadPointer);
 
@@ -45,4 +45,9 @@ void EmulatorState(bool running);
 bool AtBreakpoint();
 void ResetVideoBuffer();
 
+// Parses FIFO data from the CP read pointer in place in emulated memory, 32 bytes at a time like
+// the GPU reads it, until an interrupt for the CPU is pending. Returns how many bytes were read,
+// without moving the read pointer, or 0 if the data has to be copied to the video buffer instead.
+u32 RunFifoDirect(u32* cycles);
+
 }  // namespace Fifo
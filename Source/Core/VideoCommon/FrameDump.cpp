@@ -6,6 +6,7 @@
 #define __STDC_CONSTANT_MACROS 1
 #endif
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 
@@ -54,6 +55,7 @@ static u64 s_last_pts;
 static int s_file_index = 0;
 static int s_savestate_index = 0;
 static int s_last_savestate_index = 0;
+static u32 s_dropped_frames = 0;
 
 static void InitAVCodec()
 {
@@ -88,6 +90,7 @@ bool FrameDump::Start(int w, int h)
   s_height = h;
   s_last_pts = 0;
   s_last_frame_is_valid = s_file_index != 0;
+  s_dropped_frames = 0;
 
   InitAVCodec();
   bool success = CreateVideoFile();
@@ -198,6 +201,11 @@ bool FrameDump::CreateVideoFile()
   if (output_format->flags & AVFMT_GLOBALHEADER)
     s_codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
 
+  // Frame threading delays the output by a few frames, these are written out by
+  // HandleDelayedPackets when the dump is stopped.
+  s_codec_context->thread_count = std::max(g_Config.iDumpEncoderThreads, 0);
+  s_codec_context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
   if (avcodec_open2(s_codec_context, codec, nullptr) < 0)
   {
     ERROR_LOG(VIDEO, "Could not open codec");
@@ -316,6 +324,18 @@ void FrameDump::AddFrame(const u8* data, int width, int height, int stride, cons
   s_sws_context =
       sws_getCachedContext(s_sws_context, width, height, s_pix_fmt, s_width, s_height,
                            s_codec_context->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
+
+#if LIBAVCODEC_VERSION_MAJOR >= 55
+  // The encoder may still hold a reference to the previous frame while its threads work on it.
+  // In that case, this gives us a new buffer instead of overwriting the one being encoded.
+  if (av_frame_make_writable(s_scaled_frame) < 0)
+  {
+    ERROR_LOG(VIDEO, "Could not allocate a frame for encoding");
+    s_dropped_frames++;
+    return;
+  }
+#endif
+
   if (s_sws_context)
   {
     sws_scale(s_sws_context, s_src_frame->data, s_src_frame->linesize, 0, height,
@@ -356,12 +376,20 @@ void FrameDump::AddFrame(const u8* data, int width, int height, int stride, cons
     s_last_pts = pts_in_ticks;
     error = SendFrameAndReceivePacket(s_codec_context, &pkt, s_scaled_frame, &got_packet);
   }
+  else
+  {
+    // Another frame has already been written for this timestamp.
+    s_dropped_frames++;
+  }
   if (!error && got_packet)
   {
     WritePacket(pkt);
   }
   if (error)
+  {
     ERROR_LOG(VIDEO, "Error while encoding video: %d", error);
+    s_dropped_frames++;
+  }
 }
 
 static void HandleDelayedPackets()
@@ -393,8 +421,11 @@ void FrameDump::Stop()
   CloseVideoFile();
   s_file_index = 0;
   s_start_dumping = false;
-  NOTICE_LOG(VIDEO, "Stopping frame dump");
-  OSD::AddMessage("Stopped dumping frames");
+  NOTICE_LOG(VIDEO, "Stopping frame dump, %u frames dropped", s_dropped_frames);
+  if (s_dropped_frames != 0)
+    OSD::AddMessage(fmt::format("Stopped dumping frames ({} dropped)", s_dropped_frames));
+  else
+    OSD::AddMessage("Stopped dumping frames");
 }
 
 void FrameDump::CloseVideoFile()
@@ -8,8 +8,13 @@
 #include <cstddef>
 #include <cstring>
 
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <emmintrin.h>
+#endif
+
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
+#include "VideoCommon/CPUCull.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -17,6 +22,214 @@ namespace
 {
 constexpr u16 s_primitive_restart = UINT16_MAX;
 
+// The indices of long primitives repeat with a fixed period, where each index of the next period is
+// the same index of the previous one moved on by a fixed number of vertices. Such primitives are
+// written in groups of whole periods, a vector at a time.
+template <size_t num_vectors>
+struct IndexPattern
+{
+  static constexpr size_t NUM_INDICES = num_vectors * 8;
+
+  // The indices of the first group, relative to the first vertex of the primitive.
+  std::array<u16, NUM_INDICES> offsets{};
+  // All bits set for primitive restart indices, which don't depend on the vertex.
+  std::array<u16, NUM_INDICES> restart{};
+  // What each index moves on by from one group to the next.
+  std::array<u16, NUM_INDICES> steps{};
+  // The number of vertices, or triangles for fans, that a group covers.
+  u32 group_size = 0;
+};
+
+template <size_t num_vectors>
+u16* WriteIndexGroups(u16* index_ptr, u32 num_groups, u32 index,
+                      const IndexPattern<num_vectors>& pattern)
+{
+  if (num_groups == 0)
+    return index_ptr;
+
+#if defined(_M_X86) || defined(_M_X86_64)
+  const __m128i base = _mm_set1_epi16(static_cast<s16>(index));
+  __m128i indices[num_vectors];
+  __m128i steps[num_vectors];
+  for (size_t i = 0; i < num_vectors; ++i)
+  {
+    const __m128i offsets =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.offsets.data() + i * 8));
+    const __m128i restart =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.restart.data() + i * 8));
+    indices[i] = _mm_or_si128(_mm_add_epi16(offsets, base), restart);
+    steps[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.steps.data() + i * 8));
+  }
+
+  for (u32 group = 0; group < num_groups; ++group)
+  {
+    for (size_t i = 0; i < num_vectors; ++i)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(index_ptr + i * 8), indices[i]);
+      indices[i] = _mm_add_epi16(indices[i], steps[i]);
+    }
+    index_ptr += pattern.NUM_INDICES;
+  }
+#else
+  std::array<u16, IndexPattern<num_vectors>::NUM_INDICES> indices;
+  for (size_t i = 0; i < pattern.NUM_INDICES; ++i)
+    indices[i] = static_cast<u16>(pattern.offsets[i] + index) | pattern.restart[i];
+
+  for (u32 group = 0; group < num_groups; ++group)
+  {
+    std::memcpy(index_ptr, indices.data(), sizeof(indices));
+    for (size_t i = 0; i < pattern.NUM_INDICES; ++i)
+      indices[i] += pattern.steps[i];
+    index_ptr += pattern.NUM_INDICES;
+  }
+#endif
+
+  return index_ptr;
+}
+
+// 0 1 2 3 4 5 ..., which is also what restarted strips, line lists and points are made of.
+constexpr IndexPattern<3> MakeSequencePattern()
+{
+  IndexPattern<3> pattern;
+  pattern.group_size = 24;
+  for (u16 i = 0; i < pattern.NUM_INDICES; ++i)
+  {
+    pattern.offsets[i] = i;
+    pattern.steps[i] = 24;
+  }
+  return pattern;
+}
+
+// Six triangles, each followed by a restart index.
+constexpr IndexPattern<3> MakeRestartListPattern()
+{
+  IndexPattern<3> pattern;
+  pattern.group_size = 18;
+  for (u16 i = 0; i < pattern.NUM_INDICES; ++i)
+  {
+    if (i % 4 == 3)
+    {
+      pattern.restart[i] = s_primitive_restart;
+    }
+    else
+    {
+      pattern.offsets[i] = i / 4 * 3 + i % 4;
+      pattern.steps[i] = 18;
+    }
+  }
+  return pattern;
+}
+
+// Eight triangles, every other one with its winding reversed.
+constexpr IndexPattern<3> MakeStripPattern()
+{
+  IndexPattern<3> pattern;
+  pattern.group_size = 8;
+  for (u16 i = 0; i < pattern.NUM_INDICES; ++i)
+  {
+    const u16 triangle = i / 3;
+    const u16 wind = triangle % 2;
+    const u16 vertex = i % 3 == 0 ? 0 : i % 3 == 1 ? 2 - !wind : 2 - wind;
+    pattern.offsets[i] = triangle + vertex;
+    pattern.steps[i] = 8;
+  }
+  return pattern;
+}
+
+// Eight triangles sharing the center vertex, as 0 1 2, 0 2 3, ...
+constexpr IndexPattern<3> MakeFanPattern()
+{
+  IndexPattern<3> pattern;
+  pattern.group_size = 8;
+  for (u16 i = 0; i < pattern.NUM_INDICES; ++i)
+  {
+    if (i % 3 != 0)
+    {
+      pattern.offsets[i] = i / 3 + i % 3;
+      pattern.steps[i] = 8;
+    }
+  }
+  return pattern;
+}
+
+// Twelve triangles as four restarted strips of three, see AddFan.
+constexpr IndexPattern<3> MakeRestartFanPattern()
+{
+  IndexPattern<3> pattern;
+  pattern.group_size = 12;
+  for (u16 i = 0; i < pattern.NUM_INDICES; ++i)
+  {
+    constexpr std::array<u16, 6> vertices = {1, 2, 0, 3, 4, 0};
+    if (i % 6 == 5)
+    {
+      pattern.restart[i] = s_primitive_restart;
+    }
+    else if (i % 6 != 2)
+    {
+      pattern.offsets[i] = i / 6 * 3 + vertices[i % 6];
+      pattern.steps[i] = 12;
+    }
+  }
+  return pattern;
+}
+
+// Four quads, as two triangles each.
+constexpr IndexPattern<3> MakeQuadsPattern()
+{
+  IndexPattern<3> pattern;
+  pattern.group_size = 16;
+  for (u16 i = 0; i < pattern.NUM_INDICES; ++i)
+  {
+    constexpr std::array<u16, 6> vertices = {0, 1, 2, 0, 2, 3};
+    pattern.offsets[i] = i / 6 * 4 + vertices[i % 6];
+    pattern.steps[i] = 16;
+  }
+  return pattern;
+}
+
+// Eight quads, as restarted strips of four.
+constexpr IndexPattern<5> MakeRestartQuadsPattern()
+{
+  IndexPattern<5> pattern;
+  pattern.group_size = 32;
+  for (u16 i = 0; i < pattern.NUM_INDICES; ++i)
+  {
+    constexpr std::array<u16, 4> vertices = {1, 2, 0, 3};
+    if (i % 5 == 4)
+    {
+      pattern.restart[i] = s_primitive_restart;
+    }
+    else
+    {
+      pattern.offsets[i] = i / 5 * 4 + vertices[i % 5];
+      pattern.steps[i] = 32;
+    }
+  }
+  return pattern;
+}
+
+// Twelve lines, as 0 1, 1 2, ...
+constexpr IndexPattern<3> MakeLineStripPattern()
+{
+  IndexPattern<3> pattern;
+  pattern.group_size = 12;
+  for (u16 i = 0; i < pattern.NUM_INDICES; ++i)
+  {
+    pattern.offsets[i] = i / 2 + i % 2;
+    pattern.steps[i] = 12;
+  }
+  return pattern;
+}
+
+constexpr IndexPattern<3> s_sequence_pattern = MakeSequencePattern();
+constexpr IndexPattern<3> s_restart_list_pattern = MakeRestartListPattern();
+constexpr IndexPattern<3> s_strip_pattern = MakeStripPattern();
+constexpr IndexPattern<3> s_fan_pattern = MakeFanPattern();
+constexpr IndexPattern<3> s_restart_fan_pattern = MakeRestartFanPattern();
+constexpr IndexPattern<3> s_quads_pattern = MakeQuadsPattern();
+constexpr IndexPattern<5> s_restart_quads_pattern = MakeRestartQuadsPattern();
+constexpr IndexPattern<3> s_line_strip_pattern = MakeLineStripPattern();
+
 template <bool pr>
 u16* WriteTriangle(u16* index_ptr, u32 index1, u32 index2, u32 index3)
 {
@@ -31,7 +244,11 @@ u16* WriteTriangle(u16* index_ptr, u32 index1, u32 index2, u32 index3)
 template <bool pr>
 u16* AddList(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 2; i < num_verts; i += 3)
+  constexpr const IndexPattern<3>& pattern = pr ? s_restart_list_pattern : s_sequence_pattern;
+  const u32 num_groups = num_verts / pattern.group_size;
+  index_ptr = WriteIndexGroups(index_ptr, num_groups, index, pattern);
+
+  for (u32 i = num_groups * pattern.group_size + 2; i < num_verts; i += 3)
   {
     index_ptr = WriteTriangle<pr>(index_ptr, index + i - 2, index + i - 1, index + i);
   }
@@ -43,7 +260,10 @@ u16* AddStrip(u16* index_ptr, u32 num_verts, u32 index)
 {
   if constexpr (pr)
   {
-    for (u32 i = 0; i < num_verts; ++i)
+    const u32 num_groups = num_verts / s_sequence_pattern.group_size;
+    index_ptr = WriteIndexGroups(index_ptr, num_groups, index, s_sequence_pattern);
+
+    for (u32 i = num_groups * s_sequence_pattern.group_size; i < num_verts; ++i)
     {
       *index_ptr++ = index + i;
     }
@@ -51,8 +271,12 @@ u16* AddStrip(u16* index_ptr, u32 num_verts, u32 index)
   }
   else
   {
+    // Groups cover an even number of triangles, so the winding is the same after them.
+    const u32 num_groups = num_verts < 2 ? 0 : (num_verts - 2) / s_strip_pattern.group_size;
+    index_ptr = WriteIndexGroups(index_ptr, num_groups, index, s_strip_pattern);
+
     bool wind = false;
-    for (u32 i = 2; i < num_verts; ++i)
+    for (u32 i = num_groups * s_strip_pattern.group_size + 2; i < num_verts; ++i)
     {
       index_ptr = WriteTriangle<pr>(index_ptr, index + i - 2, index + i - !wind, index + i - wind);
 
@@ -88,6 +312,11 @@ u16* AddFan(u16* index_ptr, u32 num_verts, u32 index)
 
   if constexpr (pr)
   {
+    // Each group is four of the strips below.
+    const u32 num_groups = num_verts < 2 ? 0 : (num_verts - 2) / s_restart_fan_pattern.group_size;
+    index_ptr = WriteIndexGroups(index_ptr, num_groups, index, s_restart_fan_pattern);
+    i += num_groups * s_restart_fan_pattern.group_size;
+
     for (; i + 3 <= num_verts; i += 3)
     {
       *index_ptr++ = index + i - 1;
@@ -107,6 +336,12 @@ u16* AddFan(u16* index_ptr, u32 num_verts, u32 index)
       *index_ptr++ = s_primitive_restart;
     }
   }
+  else
+  {
+    const u32 num_groups = num_verts < 2 ? 0 : (num_verts - 2) / s_fan_pattern.group_size;
+    index_ptr = WriteIndexGroups(index_ptr, num_groups, index, s_fan_pattern);
+    i += num_groups * s_fan_pattern.group_size;
+  }
 
   for (; i < num_verts; ++i)
   {
@@ -136,6 +371,19 @@ template <bool pr>
 u16* AddQuads(u16* index_ptr, u32 num_verts, u32 index)
 {
   u32 i = 3;
+  if constexpr (pr)
+  {
+    const u32 num_groups = num_verts / s_restart_quads_pattern.group_size;
+    index_ptr = WriteIndexGroups(index_ptr, num_groups, index, s_restart_quads_pattern);
+    i += num_groups * s_restart_quads_pattern.group_size;
+  }
+  else
+  {
+    const u32 num_groups = num_verts / s_quads_pattern.group_size;
+    index_ptr = WriteIndexGroups(index_ptr, num_groups, index, s_quads_pattern);
+    i += num_groups * s_quads_pattern.group_size;
+  }
+
   for (; i < num_verts; i += 4)
   {
     if constexpr (pr)
@@ -169,9 +417,131 @@ u16* AddQuads_nonstandard(u16* index_ptr, u32 num_verts, u32 index)
   return AddQuads<pr>(index_ptr, num_verts, index);
 }
 
+// The culled variants only write the triangles that pass the CPU cull test. The visibility test
+// takes indices relative to the start of the primitive, as the transformed positions do.
+template <bool pr>
+u16* AddCulledList(u16* index_ptr, u32 num_verts, u32 index, const CPUCull& cull, u32* num_culled)
+{
+  for (u32 i = 2; i < num_verts; i += 3)
+  {
+    if (cull.IsTriangleVisible(i - 2, i - 1, i))
+      index_ptr = WriteTriangle<pr>(index_ptr, index + i - 2, index + i - 1, index + i);
+    else
+      ++*num_culled;
+  }
+  return index_ptr;
+}
+
+// With primitive restart, runs of visible triangles stay strips. A run starting on an odd
+// triangle begins with a degenerate triangle, so that the winding of the rest is unchanged.
+template <bool pr>
+u16* AddCulledStrip(u16* index_ptr, u32 num_verts, u32 index, const CPUCull& cull, u32* num_culled)
+{
+  bool wind = false;
+  bool in_run = false;
+  for (u32 i = 2; i < num_verts; ++i)
+  {
+    const bool visible = cull.IsTriangleVisible(i - 2, i - !wind, i - wind);
+    if (!visible)
+    {
+      ++*num_culled;
+      if (pr && in_run)
+      {
+        *index_ptr++ = s_primitive_restart;
+        in_run = false;
+      }
+    }
+    else if constexpr (pr)
+    {
+      if (!in_run)
+      {
+        if (wind)
+          *index_ptr++ = index + i - 2;
+        *index_ptr++ = index + i - 2;
+        *index_ptr++ = index + i - 1;
+        in_run = true;
+      }
+      *index_ptr++ = index + i;
+    }
+    else
+    {
+      index_ptr = WriteTriangle<pr>(index_ptr, index + i - 2, index + i - !wind, index + i - wind);
+    }
+
+    wind ^= true;
+  }
+
+  if (pr && in_run)
+    *index_ptr++ = s_primitive_restart;
+  return index_ptr;
+}
+
+template <bool pr>
+u16* AddCulledFan(u16* index_ptr, u32 num_verts, u32 index, const CPUCull& cull, u32* num_culled)
+{
+  for (u32 i = 2; i < num_verts; ++i)
+  {
+    if (cull.IsTriangleVisible(0, i - 1, i))
+      index_ptr = WriteTriangle<pr>(index_ptr, index, index + i - 1, index + i);
+    else
+      ++*num_culled;
+  }
+  return index_ptr;
+}
+
+template <bool pr>
+u16* AddCulledQuads(u16* index_ptr, u32 num_verts, u32 index, const CPUCull& cull,
+                    u32* num_culled)
+{
+  u32 i = 3;
+  for (; i < num_verts; i += 4)
+  {
+    const bool first_visible = cull.IsTriangleVisible(i - 3, i - 2, i - 1);
+    const bool second_visible = cull.IsTriangleVisible(i - 3, i - 1, i);
+
+    if (pr && first_visible && second_visible)
+    {
+      *index_ptr++ = index + i - 2;
+      *index_ptr++ = index + i - 1;
+      *index_ptr++ = index + i - 3;
+      *index_ptr++ = index + i - 0;
+      *index_ptr++ = s_primitive_restart;
+      continue;
+    }
+
+    if (first_visible)
+      index_ptr = WriteTriangle<pr>(index_ptr, index + i - 3, index + i - 2, index + i - 1);
+    else
+      ++*num_culled;
+
+    if (second_visible)
+      index_ptr = WriteTriangle<pr>(index_ptr, index + i - 3, index + i - 1, index + i - 0);
+    else
+      ++*num_culled;
+  }
+
+  // three vertices remaining, so render a triangle
+  if (i == num_verts)
+  {
+    if (cull.IsTriangleVisible(num_verts - 3, num_verts - 2, num_verts - 1))
+    {
+      index_ptr = WriteTriangle<pr>(index_ptr, index + num_verts - 3, index + num_verts - 2,
+                                    index + num_verts - 1);
+    }
+    else
+    {
+      ++*num_culled;
+    }
+  }
+  return index_ptr;
+}
+
 u16* AddLineList(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 1; i < num_verts; i += 2)
+  const u32 num_groups = num_verts / s_sequence_pattern.group_size;
+  index_ptr = WriteIndexGroups(index_ptr, num_groups, index, s_sequence_pattern);
+
+  for (u32 i = num_groups * s_sequence_pattern.group_size + 1; i < num_verts; i += 2)
   {
     *index_ptr++ = index + i - 1;
     *index_ptr++ = index + i;
@@ -183,7 +553,10 @@ u16* AddLineList(u16* index_ptr, u32 num_verts, u32 index)
 // so converting them to lists
 u16* AddLineStrip(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 1; i < num_verts; ++i)
+  const u32 num_groups = num_verts < 1 ? 0 : (num_verts - 1) / s_line_strip_pattern.group_size;
+  index_ptr = WriteIndexGroups(index_ptr, num_groups, index, s_line_strip_pattern);
+
+  for (u32 i = num_groups * s_line_strip_pattern.group_size + 1; i < num_verts; ++i)
   {
     *index_ptr++ = index + i - 1;
     *index_ptr++ = index + i;
@@ -193,7 +566,10 @@ u16* AddLineStrip(u16* index_ptr, u32 num_verts, u32 index)
 
 u16* AddPoints(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 0; i != num_verts; ++i)
+  const u32 num_groups = num_verts / s_sequence_pattern.group_size;
+  index_ptr = WriteIndexGroups(index_ptr, num_groups, index, s_sequence_pattern);
+
+  for (u32 i = num_groups * s_sequence_pattern.group_size; i != num_verts; ++i)
   {
     *index_ptr++ = index + i;
   }
@@ -210,6 +586,11 @@ void IndexGenerator::Init()
     m_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLES] = AddList<true>;
     m_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP] = AddStrip<true>;
     m_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_FAN] = AddFan<true>;
+    m_culled_primitive_table[OpcodeDecoder::GX_DRAW_QUADS] = AddCulledQuads<true>;
+    m_culled_primitive_table[OpcodeDecoder::GX_DRAW_QUADS_2] = AddCulledQuads<true>;
+    m_culled_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLES] = AddCulledList<true>;
+    m_culled_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP] = AddCulledStrip<true>;
+    m_culled_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_FAN] = AddCulledFan<true>;
   }
   else
   {
@@ -218,6 +599,11 @@ void IndexGenerator::Init()
     m_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLES] = AddList<false>;
     m_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP] = AddStrip<false>;
     m_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_FAN] = AddFan<false>;
+    m_culled_primitive_table[OpcodeDecoder::GX_DRAW_QUADS] = AddCulledQuads<false>;
+    m_culled_primitive_table[OpcodeDecoder::GX_DRAW_QUADS_2] = AddCulledQuads<false>;
+    m_culled_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLES] = AddCulledList<false>;
+    m_culled_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP] = AddCulledStrip<false>;
+    m_culled_primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_FAN] = AddCulledFan<false>;
   }
   m_primitive_table[OpcodeDecoder::GX_DRAW_LINES] = AddLineList;
   m_primitive_table[OpcodeDecoder::GX_DRAW_LINE_STRIP] = AddLineStrip;
@@ -238,6 +624,31 @@ void IndexGenerator::AddIndices(int primitive, u32 num_vertices)
   m_base_index += num_vertices;
 }
 
+u32 IndexGenerator::AddCulledIndices(int primitive, u32 num_vertices, const CPUCull& cull)
+{
+  // The regular indices are generated first, as culling only pays off when it results in fewer
+  // indices. Restarted strips can need more indices for their visible triangles than for all.
+  u16* const start = m_index_buffer_current;
+  const u32 base_index = m_base_index;
+  AddIndices(primitive, num_vertices);
+
+  // At most 5 indices per triangle, for a single triangle run of a restarted strip.
+  if (m_culled_index_buffer.size() < num_vertices * 5)
+    m_culled_index_buffer.resize(num_vertices * 5);
+
+  u32 num_culled = 0;
+  u16* const culled_end = m_culled_primitive_table[primitive](
+      m_culled_index_buffer.data(), num_vertices, base_index, cull, &num_culled);
+
+  const u32 num_culled_indices = static_cast<u32>(culled_end - m_culled_index_buffer.data());
+  if (num_culled == 0 || num_culled_indices >= static_cast<u32>(m_index_buffer_current - start))
+    return 0;
+
+  std::memcpy(start, m_culled_index_buffer.data(), sizeof(u16) * num_culled_indices);
+  m_index_buffer_current = start + num_culled_indices;
+  return num_culled;
+}
+
 void IndexGenerator::AddExternalIndices(const u16* indices, u32 num_indices, u32 num_vertices)
 {
   std::memcpy(m_index_buffer_current, indices, sizeof(u16) * num_indices);
@@ -245,6 +656,21 @@ void IndexGenerator::AddExternalIndices(const u16* indices, u32 num_indices, u32
   m_base_index += num_vertices;
 }
 
+void IndexGenerator::AddRemappedIndices(int primitive, u32 num_vertices, const u16* remap,
+                                        u32 num_unique_vertices)
+{
+  // The indices are generated relative to the first vertex, which leaves the restart index alone
+  // as there are never more than 65535 vertices.
+  u16* const start = m_index_buffer_current;
+  m_index_buffer_current = m_primitive_table[primitive](start, num_vertices, 0);
+  for (u16* index = start; index != m_index_buffer_current; ++index)
+  {
+    if (*index != 0xFFFF)
+      *index = static_cast<u16>(m_base_index + remap[*index]);
+  }
+  m_base_index += num_unique_vertices;
+}
+
 u32 IndexGenerator::GetRemainingIndices() const
 {
   // -1 is reserved for primitive restart (OGL + DX11)
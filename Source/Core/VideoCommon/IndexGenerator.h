@@ -8,8 +8,12 @@
 #pragma once
 
 #include <array>
+#include <vector>
+
 #include "Common/CommonTypes.h"
 
+class CPUCull;
+
 class IndexGenerator
 {
 public:
@@ -18,8 +22,17 @@ public:
 
   void AddIndices(int primitive, u32 num_vertices);
 
+  // Like AddIndices, but leaves out the triangles rejected by the last CPUCull::TransformVertices.
+  // Returns the number of triangles that were left out.
+  u32 AddCulledIndices(int primitive, u32 num_vertices, const CPUCull& cull);
+
   void AddExternalIndices(const u16* indices, u32 num_indices, u32 num_vertices);
 
+  // Like AddIndices, but with vertex i of the primitive replaced by vertex remap[i] of the
+  // num_unique_vertices that were actually loaded.
+  void AddRemappedIndices(int primitive, u32 num_vertices, const u16* remap,
+                          u32 num_unique_vertices);
+
   // returns numprimitives
   u32 GetNumVerts() const { return m_base_index; }
   u32 GetIndexLen() const { return static_cast<u32>(m_index_buffer_current - m_base_index_ptr); }
@@ -32,4 +45,8 @@ private:
 
   using PrimitiveFunction = u16* (*)(u16*, u32, u32);
   std::array<PrimitiveFunction, 8> m_primitive_table{};
+
+  using CulledPrimitiveFunction = u16* (*)(u16*, u32, u32, const CPUCull&, u32*);
+  std::array<CulledPrimitiveFunction, 8> m_culled_primitive_table{};
+  std::vector<u16> m_culled_index_buffer;
 };
@@ -24,31 +24,34 @@ static void GenerateLightShader(ShaderCode& object, const LightingUidData& uid_d
   {
   case LIGHTATTN_NONE:
   case LIGHTATTN_DIR:
-    object.Write("ldir = normalize(" LIGHT_POS ".xyz - pos.xyz);\n", LIGHT_POS_PARAMS(index));
-    object.Write("attn = 1.0;\n");
-    object.Write("if (length(ldir) == 0.0)\n\t ldir = _norm0;\n");
+    object.Write(FMT_STRING("ldir = normalize(" LIGHT_POS ".xyz - pos.xyz);\n"),
+                 LIGHT_POS_PARAMS(index));
+    object.Write(FMT_STRING("attn = 1.0;\n"));
+    object.Write(FMT_STRING("if (length(ldir) == 0.0)\n\t ldir = _norm0;\n"));
     break;
   case LIGHTATTN_SPEC:
-    object.Write("ldir = normalize(" LIGHT_POS ".xyz - pos.xyz);\n", LIGHT_POS_PARAMS(index));
-    object.Write("attn = (dot(_norm0, ldir) >= 0.0) ? max(0.0, dot(_norm0, " LIGHT_DIR
-                 ".xyz)) : 0.0;\n",
+    object.Write(FMT_STRING("ldir = normalize(" LIGHT_POS ".xyz - pos.xyz);\n"),
+                 LIGHT_POS_PARAMS(index));
+    object.Write(FMT_STRING("attn = (dot(_norm0, ldir) >= 0.0) ? max(0.0, dot(_norm0, " LIGHT_DIR
+                            ".xyz)) : 0.0;\n"),
                  LIGHT_DIR_PARAMS(index));
-    object.Write("cosAttn = " LIGHT_COSATT ".xyz;\n", LIGHT_COSATT_PARAMS(index));
-    object.Write("distAttn = %s(" LIGHT_DISTATT ".xyz);\n",
+    object.Write(FMT_STRING("cosAttn = " LIGHT_COSATT ".xyz;\n"), LIGHT_COSATT_PARAMS(index));
+    object.Write(FMT_STRING("distAttn = {}(" LIGHT_DISTATT ".xyz);\n"),
                  (diffusefunc == LIGHTDIF_NONE) ? "" : "normalize", LIGHT_DISTATT_PARAMS(index));
-    object.Write("attn = max(0.0f, dot(cosAttn, float3(1.0, attn, attn*attn))) / dot(distAttn, "
-                 "float3(1.0, attn, attn*attn));\n");
+    object.Write(FMT_STRING("attn = max(0.0f, dot(cosAttn, float3(1.0, attn, attn*attn))) / "
+                            "dot(distAttn, float3(1.0, attn, attn*attn));\n"));
     break;
   case LIGHTATTN_SPOT:
-    object.Write("ldir = " LIGHT_POS ".xyz - pos.xyz;\n", LIGHT_POS_PARAMS(index));
-    object.Write("dist2 = dot(ldir, ldir);\n"
-                 "dist = sqrt(dist2);\n"
-                 "ldir = ldir / dist;\n"
-                 "attn = max(0.0, dot(ldir, " LIGHT_DIR ".xyz));\n",
+    object.Write(FMT_STRING("ldir = " LIGHT_POS ".xyz - pos.xyz;\n"), LIGHT_POS_PARAMS(index));
+    object.Write(FMT_STRING("dist2 = dot(ldir, ldir);\n"
+                            "dist = sqrt(dist2);\n"
+                            "ldir = ldir / dist;\n"
+                            "attn = max(0.0, dot(ldir, " LIGHT_DIR ".xyz));\n"),
                  LIGHT_DIR_PARAMS(index));
     // attn*attn may overflow
-    object.Write("attn = max(0.0, " LIGHT_COSATT ".x + " LIGHT_COSATT ".y*attn + " LIGHT_COSATT
-                 ".z*attn*attn) / dot(" LIGHT_DISTATT ".xyz, float3(1.0,dist,dist2));\n",
+    object.Write(FMT_STRING("attn = max(0.0, " LIGHT_COSATT ".x + " LIGHT_COSATT ".y*attn + "
+                            LIGHT_COSATT ".z*attn*attn) / dot(" LIGHT_DISTATT
+                            ".xyz, float3(1.0,dist,dist2));\n"),
                  LIGHT_COSATT_PARAMS(index), LIGHT_COSATT_PARAMS(index), LIGHT_COSATT_PARAMS(index),
                  LIGHT_DISTATT_PARAMS(index));
     break;
@@ -57,12 +60,13 @@ static void GenerateLightShader(ShaderCode& object, const LightingUidData& uid_d
   switch (diffusefunc)
   {
   case LIGHTDIF_NONE:
-    object.Write("lacc.%s += int%s(round(attn * float%s(" LIGHT_COL ")));\n", swizzle,
+    object.Write(FMT_STRING("lacc.{} += int{}(round(attn * float{}(" LIGHT_COL ")));\n"), swizzle,
                  swizzle_components, swizzle_components, LIGHT_COL_PARAMS(index, swizzle));
     break;
   case LIGHTDIF_SIGN:
   case LIGHTDIF_CLAMP:
-    object.Write("lacc.%s += int%s(round(attn * %sdot(ldir, _norm0)) * float%s(" LIGHT_COL ")));\n",
+    object.Write(FMT_STRING("lacc.{} += int{}(round(attn * {}dot(ldir, _norm0)) * float{}("
+                            LIGHT_COL ")));\n"),
                  swizzle, swizzle_components, diffusefunc != LIGHTDIF_SIGN ? "max(0.0," : "(",
                  swizzle_components, LIGHT_COL_PARAMS(index, swizzle));
     break;
@@ -70,7 +74,7 @@ static void GenerateLightShader(ShaderCode& object, const LightingUidData& uid_d
     ASSERT(0);
   }
 
-  object.Write("\n");
+  object.Write(FMT_STRING("\n"));
 }
 
 // vertex shader
@@ -83,21 +87,21 @@ void GenerateLightingShaderCode(ShaderCode& object, const LightingUidData& uid_d
 {
   for (unsigned int j = 0; j < NUM_XF_COLOR_CHANNELS; j++)
   {
-    object.Write("{\n");
+    object.Write(FMT_STRING("{{\n"));
 
     bool colormatsource = !!(uid_data.matsource & (1 << j));
     if (colormatsource)  // from vertex
     {
       if (components & (VB_HAS_COL0 << j))
-        object.Write("int4 mat = int4(round(%s%d * 255.0));\n", inColorName, j);
+        object.Write(FMT_STRING("int4 mat = int4(round({}{} * 255.0));\n"), inColorName, j);
       else if (components & VB_HAS_COL0)
-        object.Write("int4 mat = int4(round(%s0 * 255.0));\n", inColorName);
+        object.Write(FMT_STRING("int4 mat = int4(round({}0 * 255.0));\n"), inColorName);
       else
-        object.Write("int4 mat = int4(255, 255, 255, 255);\n");
+        object.Write(FMT_STRING("int4 mat = int4(255, 255, 255, 255);\n"));
     }
     else  // from color
     {
-      object.Write("int4 mat = %s[%d];\n", I_MATERIALS, j + 2);
+      object.Write(FMT_STRING("int4 mat = {}[{}];\n"), I_MATERIALS, j + 2);
     }
 
     if (uid_data.enablelighting & (1 << j))
@@ -105,23 +109,23 @@ void GenerateLightingShaderCode(ShaderCode& object, const LightingUidData& uid_d
       if (uid_data.ambsource & (1 << j))  // from vertex
       {
         if (components & (VB_HAS_COL0 << j))
-          object.Write("lacc = int4(round(%s%d * 255.0));\n", inColorName, j);
+          object.Write(FMT_STRING("lacc = int4(round({}{} * 255.0));\n"), inColorName, j);
         else if (components & VB_HAS_COL0)
-          object.Write("lacc = int4(round(%s0 * 255.0));\n", inColorName);
+          object.Write(FMT_STRING("lacc = int4(round({}0 * 255.0));\n"), inColorName);
         else
           // TODO: this isn't verified. Here we want to read the ambient from the vertex,
           // but the vertex itself has no color. So we don't know which value to read.
           // Returning 1.0 is the same as disabled lightning, so this could be fine
-          object.Write("lacc = int4(255, 255, 255, 255);\n");
+          object.Write(FMT_STRING("lacc = int4(255, 255, 255, 255);\n"));
       }
       else  // from color
       {
-        object.Write("lacc = %s[%d];\n", I_MATERIALS, j);
+        object.Write(FMT_STRING("lacc = {}[{}];\n"), I_MATERIALS, j);
       }
     }
     else
     {
-      object.Write("lacc = int4(255, 255, 255, 255);\n");
+      object.Write(FMT_STRING("lacc = int4(255, 255, 255, 255);\n"));
     }
 
     // check if alpha is different
@@ -131,15 +135,15 @@ void GenerateLightingShaderCode(ShaderCode& object, const LightingUidData& uid_d
       if (alphamatsource)  // from vertex
       {
         if (components & (VB_HAS_COL0 << j))
-          object.Write("mat.w = int(round(%s%d.w * 255.0));\n", inColorName, j);
+          object.Write(FMT_STRING("mat.w = int(round({}{}.w * 255.0));\n"), inColorName, j);
         else if (components & VB_HAS_COL0)
-          object.Write("mat.w = int(round(%s0.w * 255.0));\n", inColorName);
+          object.Write(FMT_STRING("mat.w = int(round({}0.w * 255.0));\n"), inColorName);
         else
-          object.Write("mat.w = 255;\n");
+          object.Write(FMT_STRING("mat.w = 255;\n"));
       }
       else  // from color
       {
-        object.Write("mat.w = %s[%d].w;\n", I_MATERIALS, j + 2);
+        object.Write(FMT_STRING("mat.w = {}[{}].w;\n"), I_MATERIALS, j + 2);
       }
     }
 
@@ -148,21 +152,21 @@ void GenerateLightingShaderCode(ShaderCode& object, const LightingUidData& uid_d
       if (uid_data.ambsource & (1 << (j + 2)))  // from vertex
       {
         if (components & (VB_HAS_COL0 << j))
-          object.Write("lacc.w = int(round(%s%d.w * 255.0));\n", inColorName, j);
+          object.Write(FMT_STRING("lacc.w = int(round({}{}.w * 255.0));\n"), inColorName, j);
         else if (components & VB_HAS_COL0)
-          object.Write("lacc.w = int(round(%s0.w * 255.0));\n", inColorName);
+          object.Write(FMT_STRING("lacc.w = int(round({}0.w * 255.0));\n"), inColorName);
         else
           // TODO: The same for alpha: We want to read from vertex, but the vertex has no color
-          object.Write("lacc.w = 255;\n");
+          object.Write(FMT_STRING("lacc.w = 255;\n"));
       }
       else  // from color
       {
-        object.Write("lacc.w = %s[%d].w;\n", I_MATERIALS, j);
+        object.Write(FMT_STRING("lacc.w = {}[{}].w;\n"), I_MATERIALS, j);
       }
     }
     else
     {
-      object.Write("lacc.w = 255;\n");
+      object.Write(FMT_STRING("lacc.w = 255;\n"));
     }
 
     if (uid_data.enablelighting & (1 << j))  // Color lights
@@ -177,9 +181,10 @@ void GenerateLightingShaderCode(ShaderCode& object, const LightingUidData& uid_d
         if (uid_data.light_mask & (1 << (i + 8 * (j + 2))))
           GenerateLightShader(object, uid_data, i, j + 2, true);
     }
-    object.Write("lacc = clamp(lacc, 0, 255);\n");
-    object.Write("%s%d = float4((mat * (lacc + (lacc >> 7))) >> 8) / 255.0;\n", dest, j);
-    object.Write("}\n");
+    object.Write(FMT_STRING("lacc = clamp(lacc, 0, 255);\n"));
+    object.Write(FMT_STRING("{}{} = float4((mat * (lacc + (lacc >> 7))) >> 8) / 255.0;\n"), dest,
+                 j);
+    object.Write(FMT_STRING("}}\n"));
   }
 }
 
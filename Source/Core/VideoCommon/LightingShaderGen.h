@@ -8,19 +8,19 @@
 
 class ShaderCode;
 
-#define LIGHT_COL "%s[%d].color.%s"
+#define LIGHT_COL "{}[{}].color.{}"
 #define LIGHT_COL_PARAMS(index, swizzle) (I_LIGHTS), (index), (swizzle)
 
-#define LIGHT_COSATT "%s[%d].cosatt"
+#define LIGHT_COSATT "{}[{}].cosatt"
 #define LIGHT_COSATT_PARAMS(index) (I_LIGHTS), (index)
 
-#define LIGHT_DISTATT "%s[%d].distatt"
+#define LIGHT_DISTATT "{}[{}].distatt"
 #define LIGHT_DISTATT_PARAMS(index) (I_LIGHTS), (index)
 
-#define LIGHT_POS "%s[%d].pos"
+#define LIGHT_POS "{}[{}].pos"
 #define LIGHT_POS_PARAMS(index) (I_LIGHTS), (index)
 
-#define LIGHT_DIR "%s[%d].dir"
+#define LIGHT_DIR "{}[{}].dir"
 #define LIGHT_DIR_PARAMS(index) (I_LIGHTS), (index)
 
 /**
@@ -23,7 +23,9 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/DisplayListCache.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/StageTimings.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/XFMemory.h"
@@ -51,7 +53,9 @@ u32 InterpretDisplayList(u32 address, u32 size)
     // temporarily swap dl and non-dl (small "hack" for the stats)
     g_stats.SwapDL();
 
+    DisplayListCache::BeginDisplayList(address, start_address, size);
     Run(DataReader(start_address, start_address + size), &cycles, true);
+    DisplayListCache::EndDisplayList();
     INCSTAT(g_stats.this_frame.num_dlists_called);
 
     // un-swap
@@ -84,6 +88,8 @@ void Init()
 template <bool is_preprocess>
 u8* Run(DataReader src, u32* cycles, bool in_display_list)
 {
+  // The preprocessing of the FIFO runs on the CPU thread.
+  StageTimings::ScopedStage stage(StageTimings::Stage::OpcodeDecoding, !is_preprocess);
   u32 total_cycles = 0;
   u8* opcode_start = nullptr;
 
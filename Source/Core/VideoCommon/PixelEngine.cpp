@@ -6,6 +6,7 @@
 
 #include "VideoCommon/PixelEngine.h"
 
+#include <atomic>
 #include <mutex>
 
 #include "Common/ChunkFile.h"
@@ -102,7 +103,8 @@ static u16 s_token;
 static u16 s_token_pending;
 static bool s_token_interrupt_pending;
 static bool s_finish_interrupt_pending;
-static bool s_event_raised;
+// Read without the lock by the GPU thread, to stop parsing the FIFO in place.
+static std::atomic<bool> s_event_raised;
 
 static bool s_signal_token_interrupt;
 static bool s_signal_finish_interrupt;
@@ -290,6 +292,12 @@ static void RaiseEvent()
   CoreTiming::ScheduleEvent(0, et_SetTokenFinishOnMainThread, 0, from);
 }
 
+// Whether a token or finish raised by the GPU hasn't reached the CPU thread yet.
+bool IsTokenFinishEventPending()
+{
+  return s_event_raised.load();
+}
+
 // SetToken
 // THIS IS EXECUTED FROM VIDEO THREAD
 void SetToken(const u16 token, const bool interrupt)
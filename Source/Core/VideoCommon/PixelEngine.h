@@ -64,6 +64,7 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base);
 // gfx backend support
 void SetToken(const u16 token, const bool interrupt);
 void SetFinish();
+bool IsTokenFinishEventPending();
 UPEAlphaReadReg GetAlphaReadMode();
 
 }  // end of namespace PixelEngine
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cmath>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -24,6 +25,7 @@
 
 #include <fmt/format.h>
 #include <imgui.h>
+#include <xxhash.h>
 
 #include "Common/Assert.h"
 #include "Common/ChunkFile.h"
@@ -59,6 +61,7 @@
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/DisplayListCache.h"
 #include "VideoCommon/FPSCounter.h"
 #include "VideoCommon/FrameDump.h"
 #include "VideoCommon/FramebufferManager.h"
@@ -73,9 +76,11 @@
 #include "VideoCommon/PostProcessing.h"
 #include "VideoCommon/ShaderCache.h"
 #include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/StageTimings.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
@@ -406,8 +411,12 @@ void Renderer::CheckForConfigChanges()
 
   UpdateActiveConfig();
 
+  // Several options end up in the shader UIDs.
+  g_vertex_manager->InvalidateShaderUids();
+
   // Update texture cache settings with any changed options.
   g_texture_cache->OnConfigChanged(g_ActiveConfig);
+  VertexLoaderBase::SetWorkerThreads(g_ActiveConfig.GetVertexLoaderThreads());
 
   // EFB tile cache doesn't need to notify the backend.
   if (old_efb_access_tile_size != g_ActiveConfig.iEFBAccessTileSize)
@@ -1165,6 +1174,8 @@ void Renderer::EndUIFrame()
 
 void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u64 ticks)
 {
+  StageTimings::ScopedStage stage(StageTimings::Stage::Presentation);
+
   const AspectMode suggested = g_ActiveConfig.suggested_aspect_mode;
   if (suggested == AspectMode::Analog || suggested == AspectMode::AnalogWide)
   {
@@ -1260,6 +1271,8 @@ void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u6
         if (IsFrameDumping())
           DumpCurrentFrame(xfb_entry->texture.get(), xfb_rect, ticks);
 
+        StageTimings::EndFrame(m_frame_count);
+
         // Begin new frame
         m_frame_count++;
         g_stats.ResetFrame();
@@ -1283,6 +1296,7 @@ void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u6
       {
         // Remove stale EFB/XFB copies.
         g_texture_cache->Cleanup(m_frame_count);
+        DisplayListCache::Cleanup(m_frame_count);
         Core::Callback_VideoCopiedToXFB(true);
       }
 
@@ -1429,9 +1443,6 @@ void Renderer::FlushFrameDump()
   if (!m_last_frame_exported)
     return;
 
-  // Ensure the previously-queued frame was encoded.
-  FinishFrameData();
-
   // Queue encoding of the last frame dumped.
   std::unique_ptr<AbstractStagingTexture>& rbtex = m_frame_dump_readback_textures[0];
   rbtex->Flush();
@@ -1458,25 +1469,36 @@ void Renderer::ShutdownFrameDumping()
   if (!m_frame_dump_thread_running.IsSet())
     return;
 
-  // Ensure previous frame has been encoded.
+  // Ensure all queued frames have been encoded.
   FinishFrameData();
 
   // Wake thread up, and wait for it to exit.
-  m_frame_dump_thread_running.Clear();
-  m_frame_dump_start.Set();
+  {
+    std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+    m_frame_dump_thread_running.Clear();
+  }
+  m_frame_dump_queued.notify_one();
   if (m_frame_dump_thread.joinable())
     m_frame_dump_thread.join();
   m_frame_dump_render_framebuffer.reset();
   m_frame_dump_render_texture.reset();
   for (auto& tex : m_frame_dump_readback_textures)
     tex.reset();
+  m_frame_dump_free_buffers.clear();
+
+  if (m_frame_dump_stalls > 0)
+  {
+    WARN_LOG(VIDEO, "FrameDump: Rendering waited on the encoder for %u frames",
+             m_frame_dump_stalls);
+    OSD::AddMessage(
+        fmt::format("Frame dumping could not keep up for {} frames", m_frame_dump_stalls));
+    m_frame_dump_stalls = 0;
+  }
 }
 
 void Renderer::DumpFrameData(const u8* data, int w, int h, int stride,
                              const FrameDump::Frame& state)
 {
-  m_frame_dump_config = FrameDumpConfig{data, w, h, stride, state};
-
   if (!m_frame_dump_thread_running.IsSet())
   {
     if (m_frame_dump_thread.joinable())
@@ -1485,24 +1507,57 @@ void Renderer::DumpFrameData(const u8* data, int w, int h, int stride,
     m_frame_dump_thread = std::thread(&Renderer::RunFrameDumps, this);
   }
 
-  // Wake worker thread up.
-  m_frame_dump_start.Set();
-  m_frame_dump_frame_running = true;
+  QueuedFrameDump frame;
+  {
+    std::unique_lock<std::mutex> lk(m_frame_dump_lock);
+    const u32 queue_size = static_cast<u32>(std::max(g_ActiveConfig.iDumpQueueSize, 1));
+    if (m_frame_dump_frames_pending >= queue_size)
+    {
+      m_frame_dump_stalls++;
+      m_frame_dump_processed.wait(
+          lk, [this, queue_size] { return m_frame_dump_frames_pending < queue_size; });
+    }
+
+    if (!m_frame_dump_free_buffers.empty())
+    {
+      frame.buffer = std::move(m_frame_dump_free_buffers.back());
+      m_frame_dump_free_buffers.pop_back();
+    }
+  }
+
+  // The readback texture is reused for the next frame, so the data has to be copied out of it.
+  const int row_size = w * 4;
+  frame.buffer.resize(static_cast<size_t>(row_size) * h);
+  if (stride == row_size)
+  {
+    std::memcpy(frame.buffer.data(), data, frame.buffer.size());
+  }
+  else
+  {
+    for (int y = 0; y < h; y++)
+      std::memcpy(&frame.buffer[static_cast<size_t>(y) * row_size], data + y * stride, row_size);
+  }
+  frame.config = FrameDumpConfig{frame.buffer.data(), w, h, row_size, state};
+
+  {
+    std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+    m_frame_dump_queue.push_back(std::move(frame));
+    m_frame_dump_frames_pending++;
+  }
+  m_frame_dump_queued.notify_one();
 }
 
 void Renderer::FinishFrameData()
 {
-  if (!m_frame_dump_frame_running)
-    return;
-
-  m_frame_dump_done.Wait();
-  m_frame_dump_frame_running = false;
+  std::unique_lock<std::mutex> lk(m_frame_dump_lock);
+  m_frame_dump_processed.wait(lk, [this] { return m_frame_dump_frames_pending == 0; });
 }
 
 void Renderer::RunFrameDumps()
 {
   Common::SetCurrentThreadName("FrameDumping");
-  bool dump_to_ffmpeg = !g_ActiveConfig.bDumpFramesAsImages;
+  const bool dump_hashes = g_ActiveConfig.bDumpFrameHashes;
+  bool dump_to_ffmpeg = !g_ActiveConfig.bDumpFramesAsImages && !dump_hashes;
   bool frame_dump_started = false;
 
 // If Dolphin was compiled without ffmpeg, we only support dumping to images.
@@ -1517,11 +1572,20 @@ void Renderer::RunFrameDumps()
 
   while (true)
   {
-    m_frame_dump_start.Wait();
-    if (!m_frame_dump_thread_running.IsSet())
-      break;
+    QueuedFrameDump frame;
+    {
+      std::unique_lock<std::mutex> lk(m_frame_dump_lock);
+      m_frame_dump_queued.wait(lk, [this] {
+        return !m_frame_dump_queue.empty() || !m_frame_dump_thread_running.IsSet();
+      });
+      if (m_frame_dump_queue.empty())
+        break;
+
+      frame = std::move(m_frame_dump_queue.front());
+      m_frame_dump_queue.pop_front();
+    }
 
-    auto config = m_frame_dump_config;
+    const FrameDumpConfig& config = frame.config;
 
     // Save screenshot
     if (m_screenshot_request.TestAndClear())
@@ -1543,6 +1607,8 @@ void Renderer::RunFrameDumps()
       {
         if (dump_to_ffmpeg)
           frame_dump_started = StartFrameDumpToFFMPEG(config);
+        else if (dump_hashes)
+          frame_dump_started = StartFrameDumpToHashes(config);
         else
           frame_dump_started = StartFrameDumpToImage(config);
 
@@ -1556,12 +1622,19 @@ void Renderer::RunFrameDumps()
       {
         if (dump_to_ffmpeg)
           DumpFrameToFFMPEG(config);
+        else if (dump_hashes)
+          DumpFrameHash(config);
         else
           DumpFrameToImage(config);
       }
     }
 
-    m_frame_dump_done.Set();
+    {
+      std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+      m_frame_dump_free_buffers.push_back(std::move(frame.buffer));
+      m_frame_dump_frames_pending--;
+    }
+    m_frame_dump_processed.notify_all();
   }
 
   if (frame_dump_started)
@@ -1569,6 +1642,8 @@ void Renderer::RunFrameDumps()
     // No additional cleanup is needed when dumping to images.
     if (dump_to_ffmpeg)
       StopFrameDumpToFFMPEG();
+    else if (dump_hashes)
+      m_frame_dump_hash_file.Close();
   }
 }
 
@@ -1638,6 +1713,39 @@ void Renderer::DumpFrameToImage(const FrameDumpConfig& config)
   m_frame_dump_image_counter++;
 }
 
+bool Renderer::StartFrameDumpToHashes(const FrameDumpConfig& config)
+{
+  m_frame_dump_image_counter = 1;
+
+  const std::string filename = File::GetUserPath(D_DUMPFRAMES_IDX) + "framehashes.txt";
+  if (!SConfig::GetInstance().m_DumpFramesSilent && File::Exists(filename))
+  {
+    if (!AskYesNoT("Frame hash list '%s' already exists. Overwrite?", filename.c_str()))
+      return false;
+  }
+
+  File::CreateFullPath(filename);
+  if (!m_frame_dump_hash_file.Open(filename, "w"))
+  {
+    ERROR_LOG(VIDEO, "Could not open %s", filename.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+void Renderer::DumpFrameHash(const FrameDumpConfig& config)
+{
+  // The rows of queued frames are tightly packed, so the hash doesn't depend on the stride of the
+  // readback texture. XXH64 is used as it gives the same result on every host.
+  const u64 hash =
+      XXH64(config.data, static_cast<size_t>(config.stride) * config.height, /* seed = */ 0);
+  const std::string line = fmt::format("{} {}x{} {:016x}\n", m_frame_dump_image_counter,
+                                       config.width, config.height, hash);
+  m_frame_dump_hash_file.WriteBytes(line.data(), line.size());
+  m_frame_dump_image_counter++;
+}
+
 bool Renderer::UseVertexDepthRange() const
 {
   // We can't compute the depth range in the vertex shader if we don't support depth clamp.
@@ -15,6 +15,8 @@
 #pragma once
 
 #include <array>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -25,6 +27,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
+#include "Common/File.h"
 #include "Common/Flag.h"
 #include "Common/MathUtil.h"
 #include "VideoCommon/AsyncShaderCompiler.h"
@@ -343,11 +346,9 @@ private:
 
   // frame dumping
   std::thread m_frame_dump_thread;
-  Common::Event m_frame_dump_start;
-  Common::Event m_frame_dump_done;
   Common::Flag m_frame_dump_thread_running;
   u32 m_frame_dump_image_counter = 0;
-  bool m_frame_dump_frame_running = false;
+  File::IOFile m_frame_dump_hash_file;
   struct FrameDumpConfig
   {
     const u8* data;
@@ -355,7 +356,24 @@ private:
     int height;
     int stride;
     FrameDump::Frame state;
-  } m_frame_dump_config;
+  };
+
+  // Frames waiting for the frame dump thread. Each frame owns a copy of the readback texture, so
+  // the GPU thread only has to wait when the queue is full.
+  struct QueuedFrameDump
+  {
+    FrameDumpConfig config;
+    std::vector<u8> buffer;
+  };
+  std::mutex m_frame_dump_lock;
+  std::condition_variable m_frame_dump_queued;
+  std::condition_variable m_frame_dump_processed;
+  std::deque<QueuedFrameDump> m_frame_dump_queue;
+  std::vector<std::vector<u8>> m_frame_dump_free_buffers;
+  // Frames in the queue, plus the one currently being encoded.
+  u32 m_frame_dump_frames_pending = 0;
+  // Number of times the GPU thread had to wait for a free slot in the queue.
+  u32 m_frame_dump_stalls = 0;
 
   // Texture used for screenshot/frame dumping
   std::unique_ptr<AbstractTexture> m_frame_dump_render_texture;
@@ -379,6 +397,8 @@ private:
   std::string GetFrameDumpNextImageFileName() const;
   bool StartFrameDumpToImage(const FrameDumpConfig& config);
   void DumpFrameToImage(const FrameDumpConfig& config);
+  bool StartFrameDumpToHashes(const FrameDumpConfig& config);
+  void DumpFrameHash(const FrameDumpConfig& config);
   void ShutdownFrameDumping();
 
   bool IsFrameDumping() const;
@@ -393,13 +413,13 @@ private:
   void DumpCurrentFrame(const AbstractTexture* src_texture,
                         const MathUtil::Rectangle<int>& src_rect, u64 ticks);
 
-  // Asynchronously encodes the specified pointer of frame data to the frame dump.
+  // Copies the frame data and queues it to be encoded to the frame dump.
   void DumpFrameData(const u8* data, int w, int h, int stride, const FrameDump::Frame& state);
 
   // Ensures all rendered frames are queued for encoding.
   void FlushFrameDump();
 
-  // Ensures all encoded frames have been written to the output file.
+  // Waits until every queued frame has been written to the output file.
   void FinishFrameData();
 
   std::unique_ptr<NetPlayChatUI> m_netplay_chat_ui;
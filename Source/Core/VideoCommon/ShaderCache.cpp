@@ -114,6 +114,8 @@ const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
   std::optional<AbstractPipelineConfig> pipeline_config = GetGXPipelineConfig(uid);
   if (pipeline_config)
     pipeline = g_renderer->CreatePipeline(*pipeline_config);
+  if (!exists_in_cache)
+    m_gx_pipeline_uid_order.push_back(uid);
   if (g_ActiveConfig.bShaderCache && !exists_in_cache)
     AppendGXPipelineUID(uid);
   return InsertGXPipeline(uid, std::move(pipeline));
@@ -131,6 +133,7 @@ std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const
       return {};
   }
 
+  m_gx_pipeline_uid_order.push_back(uid);
   AppendGXPipelineUID(uid);
   QueuePipelineCompile(uid, COMPILE_PRIORITY_ONDEMAND_PIPELINE);
   return {};
@@ -153,7 +156,7 @@ void ShaderCache::WaitForAsyncCompiler()
 {
   while (m_async_shader_compiler->HasPendingWork() || m_async_shader_compiler->HasCompletedWork())
   {
-    m_async_shader_compiler->WaitUntilCompletion([](size_t completed, size_t total) {
+    m_async_shader_compiler->WaitUntilCompletion([this](size_t completed, size_t total) {
       g_renderer->BeginUIFrame();
 
       const float scale = ImGui::GetIO().DisplayFramebufferScale.x;
@@ -174,6 +177,10 @@ void ShaderCache::WaitForAsyncCompiler()
       ImGui::End();
 
       g_renderer->EndUIFrame();
+
+      // Pipelines which were waiting for their shaders are queued again when retrieved, so keep
+      // retrieving to have the workers compile them alongside the remaining shaders.
+      m_async_shader_compiler->RetrieveWorkItems();
     });
     m_async_shader_compiler->RetrieveWorkItems();
   }
@@ -397,10 +404,20 @@ void ShaderCache::ClearCaches()
 
 void ShaderCache::CompileMissingPipelines()
 {
-  // Queue all uids with a null pipeline for compilation.
+  // Queue all uids with a null pipeline for compilation, in the order they were first used. Work
+  // items with the same priority are compiled in the order they are queued, so the pipelines a game
+  // needs first are ready first.
+  for (const GXPipelineUid& uid : m_gx_pipeline_uid_order)
+  {
+    const auto& entry = m_gx_pipeline_cache[uid];
+    if (!entry.first && !entry.second)
+      QueuePipelineCompile(uid, COMPILE_PRIORITY_SHADERCACHE_PIPELINE);
+  }
+
+  // Followed by any which were never recorded in the UID cache.
   for (auto& it : m_gx_pipeline_cache)
   {
-    if (!it.second.first)
+    if (!it.second.first && !it.second.second)
       QueuePipelineCompile(it.first, COMPILE_PRIORITY_SHADERCACHE_PIPELINE);
   }
   for (auto& it : m_gx_uber_pipeline_cache)
@@ -742,19 +759,16 @@ void ShaderCache::LoadPipelineUIDCache()
       uid_file_valid = file_size == expected_size;
       if (uid_file_valid)
       {
-        for (size_t i = 0; i < uid_count; i++)
+        // Read all of the UIDs at once, rather than one at a time.
+        std::vector<SerializedGXPipelineUid> serialized_uids(uid_count);
+        uid_file_valid =
+            m_gx_pipeline_uid_cache_file.ReadArray(serialized_uids.data(), serialized_uids.size());
+        if (uid_file_valid)
         {
-          SerializedGXPipelineUid serialized_uid;
-          if (m_gx_pipeline_uid_cache_file.ReadBytes(&serialized_uid, sizeof(serialized_uid)))
-          {
-            // This just adds the pipeline to the map, it is compiled later.
+          // This just adds the pipelines to the map, they are compiled later. The file is only
+          // ever appended to, so the UIDs are in the order the pipelines were first used.
+          for (const SerializedGXPipelineUid& serialized_uid : serialized_uids)
             AddSerializedGXPipelineUID(serialized_uid);
-          }
-          else
-          {
-            uid_file_valid = false;
-            break;
-          }
         }
       }
 
@@ -808,6 +822,7 @@ void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
   // Flag it as empty with a null pipeline object, for later compilation.
   auto& entry = m_gx_pipeline_cache[real_uid];
   entry.second = false;
+  m_gx_pipeline_uid_order.push_back(real_uid);
 }
 
 void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
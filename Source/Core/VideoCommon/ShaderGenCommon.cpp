@@ -9,6 +9,27 @@
 #include "Common/FileUtil.h"
 #include "Core/ConfigManager.h"
 
+namespace
+{
+// The largest buffer released by a ShaderCode on this thread, for the next one to write into.
+thread_local std::string s_spare_buffer;
+
+constexpr size_t SHADER_CODE_MIN_CAPACITY = 16384;
+}  // Anonymous namespace
+
+ShaderCode::ShaderCode()
+{
+  m_buffer.swap(s_spare_buffer);
+  m_buffer.clear();
+  m_buffer.reserve(SHADER_CODE_MIN_CAPACITY);
+}
+
+ShaderCode::~ShaderCode()
+{
+  if (m_buffer.capacity() > s_spare_buffer.capacity())
+    m_buffer.swap(s_spare_buffer);
+}
+
 ShaderHostConfig ShaderHostConfig::GetCurrent()
 {
   ShaderHostConfig bits = {};
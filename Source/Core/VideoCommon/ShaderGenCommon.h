@@ -4,7 +4,6 @@
 
 #pragma once
 
-#include <cstdarg>
 #include <cstring>
 #include <iterator>
 #include <map>
@@ -15,7 +14,6 @@
 #include <fmt/format.h>
 
 #include "Common/CommonTypes.h"
-#include "Common/StringUtil.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -37,14 +35,12 @@ class ShaderGeneratorInterface
 public:
   /*
    * Used when the shader generator would write a piece of ShaderCode.
-   * Can be used like printf.
-   * @note In the ShaderCode implementation, this does indeed write the parameter string to an
-   * internal buffer. However, you're free to do whatever you like with the parameter.
+   * Takes fmtlib format strings.
+   * @note In the ShaderCode implementation, this does indeed write the formatted string to an
+   * internal buffer. However, you're free to do whatever you like with the parameters.
    */
-  void Write(const char*, ...)
-#ifdef __GNUC__
-      __attribute__((format(printf, 2, 3)))
-#endif
+  template <typename S, typename... Args>
+  void Write(const S&, Args&&...)
   {
   }
 
@@ -99,28 +95,27 @@ private:
   uid_data data{};
 };
 
+// The buffer is taken over from the last ShaderCode that was destroyed on the same thread, so
+// generating shaders one after another doesn't allocate and grow a new string every time.
 class ShaderCode : public ShaderGeneratorInterface
 {
 public:
-  ShaderCode() { m_buffer.reserve(16384); }
-  const std::string& GetBuffer() const { return m_buffer; }
+  ShaderCode();
+  ~ShaderCode();
+  ShaderCode(const ShaderCode&) = default;
+  ShaderCode(ShaderCode&&) = default;
+  ShaderCode& operator=(const ShaderCode&) = default;
+  ShaderCode& operator=(ShaderCode&&) = default;
 
-  // Deprecated: Writes format strings using traditional printf format strings.
-  void Write(const char* fmt, ...)
-#ifdef __GNUC__
-      __attribute__((format(printf, 2, 3)))
-#endif
-  {
-    va_list arglist;
-    va_start(arglist, fmt);
-    m_buffer += StringFromFormatV(fmt, arglist);
-    va_end(arglist);
-  }
+  const std::string& GetBuffer() const { return m_buffer; }
 
-  // Writes format strings using fmtlib format strings.
-  template <typename... Args>
-  void WriteFmt(std::string_view format, Args&&... args)
+  // Writes format strings using fmtlib format strings. The formatted text is appended to the
+  // buffer directly. Format strings must be wrapped in FMT_STRING so that they are checked
+  // against their arguments at compile time.
+  template <typename S, typename... Args>
+  void Write(const S& format, Args&&... args)
   {
+    static_assert(fmt::is_compile_string<S>::value, "Wrap shader format strings in FMT_STRING");
     fmt::format_to(std::back_inserter(m_buffer), format, std::forward<Args>(args)...);
   }
 
@@ -198,20 +193,20 @@ inline void DefineOutputMember(T& object, APIType api_type, const char* qualifie
                                const char* name, int var_index, const char* semantic = "",
                                int semantic_index = -1)
 {
-  object.Write("\t%s %s %s", qualifier, type, name);
+  object.Write(FMT_STRING("\t{} {} {}"), qualifier, type, name);
 
   if (var_index != -1)
-    object.Write("%d", var_index);
+    object.Write(FMT_STRING("{}"), var_index);
 
   if (api_type == APIType::D3D && strlen(semantic) > 0)
   {
     if (semantic_index != -1)
-      object.Write(" : %s%d", semantic, semantic_index);
+      object.Write(FMT_STRING(" : {}{}"), semantic, semantic_index);
     else
-      object.Write(" : %s", semantic);
+      object.Write(FMT_STRING(" : {}"), semantic);
   }
 
-  object.Write(";\n");
+  object.Write(FMT_STRING(";\n"));
 }
 
 template <class T>
@@ -247,26 +242,26 @@ template <class T>
 inline void AssignVSOutputMembers(T& object, const char* a, const char* b, u32 texgens,
                                   const ShaderHostConfig& host_config)
 {
-  object.Write("\t%s.pos = %s.pos;\n", a, b);
-  object.Write("\t%s.colors_0 = %s.colors_0;\n", a, b);
-  object.Write("\t%s.colors_1 = %s.colors_1;\n", a, b);
+  object.Write(FMT_STRING("\t{}.pos = {}.pos;\n"), a, b);
+  object.Write(FMT_STRING("\t{}.colors_0 = {}.colors_0;\n"), a, b);
+  object.Write(FMT_STRING("\t{}.colors_1 = {}.colors_1;\n"), a, b);
 
   for (unsigned int i = 0; i < texgens; ++i)
-    object.Write("\t%s.tex%d = %s.tex%d;\n", a, i, b, i);
+    object.Write(FMT_STRING("\t{}.tex{} = {}.tex{};\n"), a, i, b, i);
 
   if (!host_config.fast_depth_calc)
-    object.Write("\t%s.clipPos = %s.clipPos;\n", a, b);
+    object.Write(FMT_STRING("\t{}.clipPos = {}.clipPos;\n"), a, b);
 
   if (host_config.per_pixel_lighting)
   {
-    object.Write("\t%s.Normal = %s.Normal;\n", a, b);
-    object.Write("\t%s.WorldPos = %s.WorldPos;\n", a, b);
+    object.Write(FMT_STRING("\t{}.Normal = {}.Normal;\n"), a, b);
+    object.Write(FMT_STRING("\t{}.WorldPos = {}.WorldPos;\n"), a, b);
   }
 
   if (host_config.backend_geometry_shaders)
   {
-    object.Write("\t%s.clipDist0 = %s.clipDist0;\n", a, b);
-    object.Write("\t%s.clipDist1 = %s.clipDist1;\n", a, b);
+    object.Write(FMT_STRING("\t{}.clipDist0 = {}.clipDist0;\n"), a, b);
+    object.Write(FMT_STRING("\t{}.clipDist1 = {}.clipDist1;\n"), a, b);
   }
 }
 
@@ -0,0 +1,160 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/StageTimings.h"
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace StageTimings
+{
+constexpr u32 NUM_STAGES = static_cast<u32>(Stage::NumStages);
+
+// Column names of the CSV file, and counter names of the trace.
+constexpr std::array<const char*, NUM_STAGES> STAGE_NAMES = {
+    "idle", "fifo", "opcode_decoding", "vertex_loading", "texture_loading", "shader_lookup",
+    "backend_submission", "presentation"};
+
+bool g_active = false;
+
+static std::vector<Stage> s_stack;
+static std::array<u64, NUM_STAGES> s_stage_ns;
+static u64 s_last_time;
+static u64 s_frame_start_time;
+static u64 s_start_time;
+
+static std::ofstream s_csv_file;
+static std::ofstream s_trace_file;
+static bool s_trace_has_events;
+
+static u64 GetTimeNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Charges the time since the last change of stage to the current stage.
+static void UpdateCurrentStage(u64 now)
+{
+  const Stage current = s_stack.empty() ? Stage::Idle : s_stack.back();
+  s_stage_ns[static_cast<u32>(current)] += now - s_last_time;
+  s_last_time = now;
+}
+
+void Enter(Stage stage)
+{
+  UpdateCurrentStage(GetTimeNs());
+  s_stack.push_back(stage);
+}
+
+void Leave()
+{
+  UpdateCurrentStage(GetTimeNs());
+  if (!s_stack.empty())
+    s_stack.pop_back();
+}
+
+static void Start(u64 now)
+{
+  const std::string path = File::GetUserPath(D_LOGS_IDX);
+  File::OpenFStream(s_csv_file, path + "gpu_thread_times.csv", std::ios_base::out);
+  File::OpenFStream(s_trace_file, path + "gpu_thread_times.json", std::ios_base::out);
+
+  s_csv_file << "frame,frame_us";
+  for (const char* name : STAGE_NAMES)
+    s_csv_file << ',' << name << "_us";
+  s_csv_file << ",draw_calls,primitives\n";
+
+  // Chrome's trace event format. Each frame is a complete event with a counter event for the time
+  // of each stage, so the trace can be opened in chrome://tracing or Perfetto.
+  s_trace_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  s_trace_has_events = false;
+
+  s_stack.clear();
+  s_stage_ns = {};
+  s_start_time = now;
+  s_frame_start_time = now;
+  s_last_time = now;
+  g_active = true;
+}
+
+void Shutdown()
+{
+  if (s_trace_file.is_open())
+  {
+    s_trace_file << "\n]}\n";
+    s_trace_file.close();
+  }
+  s_csv_file.close();
+  s_stack.clear();
+  g_active = false;
+}
+
+static void WriteTraceEvent(const std::string& event)
+{
+  s_trace_file << (s_trace_has_events ? ",\n" : "\n") << event;
+  s_trace_has_events = true;
+}
+
+static void WriteFrame(u64 frame, u64 now)
+{
+  const auto to_us = [](u64 ns) { return ns / 1000.0; };
+  const double frame_us = to_us(now - s_frame_start_time);
+  const int draw_calls = g_stats.this_frame.num_draw_calls;
+  const int primitives = g_stats.this_frame.num_prims + g_stats.this_frame.num_dl_prims;
+
+  s_csv_file << fmt::format("{},{:.3f}", frame, frame_us);
+  for (u64 stage_ns : s_stage_ns)
+    s_csv_file << fmt::format(",{:.3f}", to_us(stage_ns));
+  s_csv_file << fmt::format(",{},{}\n", draw_calls, primitives);
+
+  const double start_us = to_us(s_frame_start_time - s_start_time);
+  WriteTraceEvent(fmt::format("{{\"name\":\"Frame {}\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                              "\"ts\":{:.3f},\"dur\":{:.3f},"
+                              "\"args\":{{\"draw_calls\":{},\"primitives\":{}}}}}",
+                              frame, start_us, frame_us, draw_calls, primitives));
+
+  std::string counters;
+  for (u32 i = 0; i < NUM_STAGES; ++i)
+  {
+    counters += fmt::format("{}\"{}\":{:.3f}", i == 0 ? "" : ",", STAGE_NAMES[i],
+                            to_us(s_stage_ns[i]));
+  }
+  WriteTraceEvent(fmt::format(
+      "{{\"name\":\"Stage time (us)\",\"ph\":\"C\",\"pid\":1,\"ts\":{:.3f},\"args\":{{{}}}}}",
+      start_us, counters));
+}
+
+void EndFrame(u64 frame)
+{
+  if (g_active != g_ActiveConfig.bLogGPUThreadTimesToFile)
+  {
+    if (g_active)
+      Shutdown();
+    else
+      Start(GetTimeNs());
+    return;
+  }
+  if (!g_active)
+    return;
+
+  const u64 now = GetTimeNs();
+  UpdateCurrentStage(now);
+  WriteFrame(frame, now);
+
+  s_stage_ns = {};
+  s_frame_start_time = now;
+}
+}  // namespace StageTimings
@@ -0,0 +1,61 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+// Splits the time of the thread doing the video work between the stages of the pipeline, and logs
+// it for every frame when LogGPUThreadTimesToFile is enabled. The time of each stage excludes the
+// time of the stages nested inside it.
+
+namespace StageTimings
+{
+enum class Stage : u32
+{
+  // Time outside of all other stages. In dual core mode, this is the GPU thread waiting for work.
+  Idle,
+  // Reading the FIFO and running requests from the CPU thread, apart from the stages below.
+  Fifo,
+  OpcodeDecoding,
+  VertexLoading,
+  TextureLoading,
+  ShaderLookup,
+  BackendSubmission,
+  Presentation,
+  NumStages
+};
+
+extern bool g_active;
+
+void Enter(Stage stage);
+void Leave();
+
+// Finishes the record of the frame that was just presented, and starts or stops timing when the
+// setting changed.
+void EndFrame(u64 frame);
+void Shutdown();
+
+class ScopedStage
+{
+public:
+  // Does nothing if enable is false, for code that is also run outside of the video thread.
+  explicit ScopedStage(Stage stage, bool enable = true) : m_active(enable && g_active)
+  {
+    if (m_active)
+      Enter(stage);
+  }
+  ~ScopedStage()
+  {
+    if (m_active)
+      Leave();
+  }
+
+  ScopedStage(const ScopedStage&) = delete;
+  ScopedStage& operator=(const ScopedStage&) = delete;
+
+private:
+  bool m_active;
+};
+}  // namespace StageTimings
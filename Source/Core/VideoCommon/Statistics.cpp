@@ -70,8 +70,16 @@ void Statistics::Display() const
   draw_statistic("vshaders alive", "%d", num_vertex_shaders_alive);
   draw_statistic("shaders changes", "%d", this_frame.num_shader_changes);
   draw_statistic("dlists called", "%d", this_frame.num_dlists_called);
+  if (g_ActiveConfig.bDisplayListCache)
+  {
+    draw_statistic("dlist cache hits", "%d", this_frame.num_dlist_cache_hits);
+    draw_statistic("dlist cache misses", "%d", this_frame.num_dlist_cache_misses);
+    draw_statistic("dlists cached", "%d", num_display_lists_cached);
+  }
   draw_statistic("Primitive joins", "%d", this_frame.num_primitive_joins);
   draw_statistic("Draw calls", "%d", this_frame.num_draw_calls);
+  if (g_ActiveConfig.bCPUCull)
+    draw_statistic("CPU culled triangles", "%d", this_frame.num_triangles_cpu_culled);
   draw_statistic("Primitives", "%d", this_frame.num_prims);
   draw_statistic("Primitives (DL)", "%d", this_frame.num_dl_prims);
   draw_statistic("XF loads", "%d", this_frame.num_xf_loads);
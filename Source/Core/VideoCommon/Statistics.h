@@ -18,6 +18,7 @@ struct Statistics
   int num_textures_alive;
 
   int num_vertex_loaders;
+  int num_display_lists_cached;
 
   std::array<float, 6> proj;
   std::array<float, 16> gproj;
@@ -41,6 +42,8 @@ struct Statistics
     int num_draw_calls;
 
     int num_dlists_called;
+    int num_dlist_cache_hits;
+    int num_dlist_cache_misses;
 
     int bytes_vertex_streamed;
     int bytes_index_streamed;
@@ -50,6 +53,7 @@ struct Statistics
     int num_triangles_in;
     int num_triangles_rejected;
     int num_triangles_culled;
+    int num_triangles_cpu_culled;
     int num_drawn_objects;
     int rasterized_pixels;
     int num_triangles_drawn;
@@ -92,6 +92,8 @@ TextureCacheBase::TextureCacheBase()
   TexDecoder_SetTexFmtOverlayOptions(backup_config.texfmt_overlay,
                                      backup_config.texfmt_overlay_center);
 
+  m_decode_workers.Reset(g_ActiveConfig.GetTextureDecodeThreads(), "Texture Decoder");
+
   HiresTexture::Init();
 
   Common::SetHash64Function();
@@ -158,6 +160,9 @@ void TextureCacheBase::OnConfigChanged(const VideoConfig& config)
     TexDecoder_SetTexFmtOverlayOptions(config.bTexFmtOverlayEnable, config.bTexFmtOverlayCenter);
   }
 
+  if (config.GetTextureDecodeThreads() != m_decode_workers.GetWorkerCount())
+    m_decode_workers.Reset(config.GetTextureDecodeThreads(), "Texture Decoder");
+
   SetBackupConfig(config);
 }
 
@@ -1540,6 +1545,10 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   // Initialized to null because only software loading uses this buffer
   u8* dst_buffer = nullptr;
 
+  // Levels decoded in software. These are all decoded at once after the mip chain has been walked,
+  // so that they can be decoded in parallel.
+  std::vector<TextureDecodeJob> decode_jobs;
+
   if (!hires_tex)
   {
     if (!decode_on_gpu ||
@@ -1567,21 +1576,12 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
 
       CheckTempSize(total_texture_size);
       dst_buffer = temp;
-      if (!(texformat == TextureFormat::RGBA8 && from_tmem))
-      {
-        TexDecoder_Decode(dst_buffer, src_data, expandedWidth, expandedHeight, texformat, tlut,
-                          tlutfmt);
-      }
-      else
-      {
-        u8* src_data_gb = &texMem[tmem_address_odd];
-        TexDecoder_DecodeRGBA8FromTmem(dst_buffer, src_data, src_data_gb, expandedWidth,
-                                       expandedHeight);
-      }
-
-      entry->texture->Load(0, width, height, expandedWidth, dst_buffer, decoded_texture_size);
+      const u8* src_data_gb = nullptr;
+      if (texformat == TextureFormat::RGBA8 && from_tmem)
+        src_data_gb = &texMem[tmem_address_odd];
 
-      arbitrary_mip_detector.AddLevel(width, height, expandedWidth, dst_buffer);
+      decode_jobs.push_back(
+          {0, width, height, expandedWidth, expandedHeight, src_data, src_data_gb, dst_buffer});
 
       dst_buffer += decoded_texture_size;
     }
@@ -1648,12 +1648,8 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
       {
         // No need to call CheckTempSize here, as the whole buffer is preallocated at the beginning
         const u32 decoded_mip_size = expanded_mip_width * sizeof(u32) * expanded_mip_height;
-        TexDecoder_Decode(dst_buffer, mip_src_data, expanded_mip_width, expanded_mip_height,
-                          texformat, tlut, tlutfmt);
-        entry->texture->Load(level, mip_width, mip_height, expanded_mip_width, dst_buffer,
-                             decoded_mip_size);
-
-        arbitrary_mip_detector.AddLevel(mip_width, mip_height, expanded_mip_width, dst_buffer);
+        decode_jobs.push_back({level, mip_width, mip_height, expanded_mip_width,
+                               expanded_mip_height, mip_src_data, nullptr, dst_buffer});
 
         dst_buffer += decoded_mip_size;
       }
@@ -1662,6 +1658,18 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
     }
   }
 
+  if (!decode_jobs.empty())
+  {
+    DecodeTextureLevels(decode_jobs, texformat, tlut, tlutfmt);
+
+    for (const TextureDecodeJob& job : decode_jobs)
+    {
+      entry->texture->Load(job.level, job.width, job.height, job.expanded_width, job.dst,
+                           job.expanded_width * sizeof(u32) * job.expanded_height);
+      arbitrary_mip_detector.AddLevel(job.width, job.height, job.expanded_width, job.dst);
+    }
+  }
+
   entry->has_arbitrary_mips = hires_tex ? hires_tex->HasArbitraryMipmaps() :
                                           arbitrary_mip_detector.HasArbitraryMipmaps(dst_buffer);
 
@@ -1683,6 +1691,72 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   return entry;
 }
 
+static void DecodeTextureRows(const u8* src, const u8* src_gb, u8* dst, u32 width, u32 first_row,
+                              u32 num_rows, TextureFormat format, const u8* tlut,
+                              TLUTFormat tlutfmt)
+{
+  // Rows of blocks are stored one after another, so a band starting on a block boundary can be
+  // decoded as if it were a texture of its own.
+  dst += first_row * width * sizeof(u32);
+  if (src_gb)
+  {
+    // Each 4x4 block takes 32 bytes in both halves of TMEM.
+    const u32 offset = (first_row / 4) * (width / 4) * 32;
+    TexDecoder_DecodeRGBA8FromTmem(dst, src + offset, src_gb + offset, width, num_rows);
+  }
+  else
+  {
+    src += TexDecoder_GetTextureSizeInBytes(width, first_row, format);
+    TexDecoder_Decode(dst, src, width, num_rows, format, tlut, tlutfmt);
+  }
+}
+
+void TextureCacheBase::DecodeTextureLevels(const std::vector<TextureDecodeJob>& jobs,
+                                           TextureFormat format, const u8* tlut,
+                                           TLUTFormat tlutfmt)
+{
+  // Bands are at least this big, so that handing them over to another thread is worth it.
+  constexpr u32 MIN_TEXELS_PER_BAND = 128 * 128;
+
+  u32 total_texels = 0;
+  for (const TextureDecodeJob& job : jobs)
+    total_texels += job.expanded_width * job.expanded_height;
+
+  // The format overlay is drawn on top of each decoded image, so it needs whole levels.
+  if (m_decode_workers.GetWorkerCount() == 0 || total_texels < MIN_TEXELS_PER_BAND * 2 ||
+      backup_config.texfmt_overlay)
+  {
+    for (const TextureDecodeJob& job : jobs)
+    {
+      DecodeTextureRows(job.src, job.src_gb, job.dst, job.expanded_width, 0, job.expanded_height,
+                        format, tlut, tlutfmt);
+    }
+    return;
+  }
+
+  struct Band
+  {
+    const TextureDecodeJob* job;
+    u32 first_row;
+    u32 num_rows;
+  };
+  std::vector<Band> bands;
+  const u32 block_height = TexDecoder_GetBlockHeightInTexels(format);
+  for (const TextureDecodeJob& job : jobs)
+  {
+    const u32 rows_per_band =
+        Common::AlignUp(std::max(MIN_TEXELS_PER_BAND / job.expanded_width, 1u), block_height);
+    for (u32 row = 0; row < job.expanded_height; row += rows_per_band)
+      bands.push_back({&job, row, std::min(rows_per_band, job.expanded_height - row)});
+  }
+
+  m_decode_workers.ParallelFor(static_cast<u32>(bands.size()), [&](u32 i) {
+    const Band& band = bands[i];
+    DecodeTextureRows(band.job->src, band.job->src_gb, band.job->dst, band.job->expanded_width,
+                      band.first_row, band.num_rows, format, tlut, tlutfmt);
+  });
+}
+
 static void GetDisplayRectForXFBEntry(TextureCacheBase::TCacheEntry* entry, u32 width, u32 height,
                                       MathUtil::Rectangle<int>* display_rect)
 {
@@ -17,6 +17,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
+#include "Common/WorkerPool.h"
 #include "VideoCommon/AbstractTexture.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/TextureConfig.h"
@@ -296,6 +297,25 @@ private:
   void DumpTexture(TCacheEntry* entry, std::string basename, unsigned int level, bool is_arbitrary);
   void CheckTempSize(size_t required_size);
 
+  // A texture level to be decoded on the CPU.
+  struct TextureDecodeJob
+  {
+    u32 level;
+    u32 width;
+    u32 height;
+    u32 expanded_width;
+    u32 expanded_height;
+    const u8* src;
+    // Only set for RGBA8 textures loaded from TMEM, in which case src holds the AR half.
+    const u8* src_gb;
+    u8* dst;
+  };
+
+  // Decodes all the given levels. Large textures are split into bands of rows, which are decoded
+  // in parallel by the texture decoding workers.
+  void DecodeTextureLevels(const std::vector<TextureDecodeJob>& jobs, TextureFormat format,
+                           const u8* tlut, TLUTFormat tlutfmt);
+
   TCacheEntry* AllocateCacheEntry(const TextureConfig& config);
   std::optional<TexPoolEntry> AllocateTexture(const TextureConfig& config);
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
@@ -362,6 +382,9 @@ private:
   // Decoding texture used for GPU texture decoding.
   std::unique_ptr<AbstractTexture> m_decoding_texture;
 
+  // Worker threads helping the GPU thread with decoding large textures on the CPU.
+  Common::WorkerPool m_decode_workers;
+
   // Pool of readback textures used for deferred EFB copies.
   std::vector<std::unique_ptr<AbstractStagingTexture>> m_efb_copy_staging_texture_pool;
 
@@ -740,13 +740,29 @@ void TexDecoder_DecodeTexelRGBA8FromTmem(u8* dst, const u8* src_ar, const u8* sr
 void TexDecoder_DecodeRGBA8FromTmem(u8* dst, const u8* src_ar, const u8* src_gb, int width,
                                     int height)
 {
-  // TODO for someone who cares: Make this less slow!
-  for (int y = 0; y < height; ++y)
+  // Walk the image one 4x4 block at a time, so the block addresses only need to be computed once
+  // per block instead of once per texel.
+  const int width_blocks = (width + 3) / 4;
+  for (int y = 0; y < height; y += 4)
   {
-    for (int x = 0; x < width; ++x)
+    for (int x = 0; x < width; x += 4)
     {
-      TexDecoder_DecodeTexelRGBA8FromTmem(dst, src_ar, src_gb, x, y, width - 1);
-      dst += 4;
+      const int block = (y / 4) * width_blocks + x / 4;
+      const u8* block_ar = src_ar + block * 32;
+      const u8* block_gb = src_gb + block * 32;
+
+      for (int iy = 0; iy < 4 && y + iy < height; iy++)
+      {
+        u8* texel = dst + ((y + iy) * width + x) * 4;
+        for (int ix = 0; ix < 4 && x + ix < width; ix++, texel += 4)
+        {
+          const int offset = (iy * 4 + ix) * 2;
+          texel[0] = block_ar[offset + 1];  // R
+          texel[1] = block_gb[offset];      // G
+          texel[2] = block_gb[offset + 1];  // B
+          texel[3] = block_ar[offset];      // A
+        }
+      }
     }
   }
 }
@@ -8,6 +8,7 @@
 
 #include "Common/CPUDetect.h"
 #include "Common/CommonTypes.h"
+#include "Common/Compiler.h"
 #include "Common/Intrinsics.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
@@ -205,6 +206,135 @@ static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
 }
 #endif
 
+// AVX2 palette helpers. These decode eight 16-bit palette entries at a time, each one held in the
+// low half of a 32-bit lane exactly as it is stored in memory (i.e. not byte-swapped). The upper
+// half of each lane is ignored, which allows feeding them straight from a 32-bit gather.
+template <TLUTFormat tlutfmt>
+FUNCTION_TARGET_AVX2 static inline __m256i DecodePaletteColors_AVX2(__m256i raw)
+{
+  if (tlutfmt == TLUTFormat::IA8)
+  {
+    // The first byte in memory is the alpha, the second one the intensity.
+    const __m256i a = _mm256_slli_epi32(raw, 24);
+    const __m256i i = _mm256_and_si256(_mm256_srli_epi32(raw, 8), _mm256_set1_epi32(0xFF));
+    const __m256i ii = _mm256_or_si256(i, _mm256_slli_epi32(i, 8));
+    return _mm256_or_si256(_mm256_or_si256(ii, _mm256_slli_epi32(i, 16)), a);
+  }
+
+  // Byte-swap each entry, clearing the upper half of the lane in the process.
+  const __m256i kSwap16 =
+      _mm256_setr_epi8(1, 0, -1, -1, 5, 4, -1, -1, 9, 8, -1, -1, 13, 12, -1, -1, 1, 0, -1, -1, 5, 4,
+                       -1, -1, 9, 8, -1, -1, 13, 12, -1, -1);
+  const __m256i val = _mm256_shuffle_epi8(raw, kSwap16);
+  const __m256i kMask_x1f = _mm256_set1_epi32(0x1F);
+  const __m256i kAlpha = _mm256_set1_epi32(0xFF000000);
+
+  if (tlutfmt == TLUTFormat::RGB565)
+  {
+    const __m256i r5 = _mm256_srli_epi32(val, 11);
+    const __m256i g6 = _mm256_and_si256(_mm256_srli_epi32(val, 5), _mm256_set1_epi32(0x3F));
+    const __m256i b5 = _mm256_and_si256(val, kMask_x1f);
+    const __m256i r = _mm256_or_si256(_mm256_slli_epi32(r5, 3), _mm256_srli_epi32(r5, 2));
+    const __m256i g = _mm256_or_si256(_mm256_slli_epi32(g6, 2), _mm256_srli_epi32(g6, 4));
+    const __m256i b = _mm256_or_si256(_mm256_slli_epi32(b5, 3), _mm256_srli_epi32(b5, 2));
+    return _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                           _mm256_or_si256(_mm256_slli_epi32(b, 16), kAlpha));
+  }
+
+  // RGB5A3: the top bit selects between opaque RGB555 and translucent ARGB3444.
+  const __m256i r5 = _mm256_and_si256(_mm256_srli_epi32(val, 10), kMask_x1f);
+  const __m256i g5 = _mm256_and_si256(_mm256_srli_epi32(val, 5), kMask_x1f);
+  const __m256i b5 = _mm256_and_si256(val, kMask_x1f);
+  const __m256i r8 = _mm256_or_si256(_mm256_slli_epi32(r5, 3), _mm256_srli_epi32(r5, 2));
+  const __m256i g8 = _mm256_or_si256(_mm256_slli_epi32(g5, 3), _mm256_srli_epi32(g5, 2));
+  const __m256i b8 = _mm256_or_si256(_mm256_slli_epi32(b5, 3), _mm256_srli_epi32(b5, 2));
+  const __m256i opaque = _mm256_or_si256(_mm256_or_si256(r8, _mm256_slli_epi32(g8, 8)),
+                                         _mm256_or_si256(_mm256_slli_epi32(b8, 16), kAlpha));
+
+  const __m256i kMask_xf = _mm256_set1_epi32(0xF);
+  const __m256i a3 = _mm256_and_si256(_mm256_srli_epi32(val, 12), _mm256_set1_epi32(0x7));
+  const __m256i r4 = _mm256_and_si256(_mm256_srli_epi32(val, 8), kMask_xf);
+  const __m256i g4 = _mm256_and_si256(_mm256_srli_epi32(val, 4), kMask_xf);
+  const __m256i b4 = _mm256_and_si256(val, kMask_xf);
+  const __m256i a = _mm256_or_si256(
+      _mm256_or_si256(_mm256_slli_epi32(a3, 5), _mm256_slli_epi32(a3, 2)), _mm256_srli_epi32(a3, 1));
+  const __m256i rgb4 =
+      _mm256_or_si256(_mm256_or_si256(r4, _mm256_slli_epi32(g4, 8)), _mm256_slli_epi32(b4, 16));
+  const __m256i translucent = _mm256_or_si256(_mm256_or_si256(rgb4, _mm256_slli_epi32(rgb4, 4)),
+                                              _mm256_slli_epi32(a, 24));
+
+  const __m256i is_opaque = _mm256_srai_epi32(_mm256_slli_epi32(val, 16), 31);
+  return _mm256_blendv_epi8(translucent, opaque, is_opaque);
+}
+
+template <TLUTFormat tlutfmt>
+FUNCTION_TARGET_AVX2 static void DecodePalette_AVX2(u32* dst, const u8* tlut, int num_entries)
+{
+  for (int i = 0; i < num_entries; i += 8)
+  {
+    const __m128i raw = _mm_loadu_si128((const __m128i*)(tlut + i * sizeof(u16)));
+    _mm256_store_si256((__m256i*)(dst + i),
+                       DecodePaletteColors_AVX2<tlutfmt>(_mm256_cvtepu16_epi32(raw)));
+  }
+}
+
+// Decodes a C4/C8 palette to RGBA8 up front, so that every texel only needs a single lookup.
+FUNCTION_TARGET_AVX2
+static void DecodePalette_AVX2(u32* dst, const u8* tlut, TLUTFormat tlutfmt, int num_entries)
+{
+  switch (tlutfmt)
+  {
+  case TLUTFormat::IA8:
+    DecodePalette_AVX2<TLUTFormat::IA8>(dst, tlut, num_entries);
+    break;
+  case TLUTFormat::RGB565:
+    DecodePalette_AVX2<TLUTFormat::RGB565>(dst, tlut, num_entries);
+    break;
+  case TLUTFormat::RGB5A3:
+    DecodePalette_AVX2<TLUTFormat::RGB5A3>(dst, tlut, num_entries);
+    break;
+  default:
+    std::fill(dst, dst + num_entries, 0);
+    break;
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C4_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // The whole decoded palette fits in two registers, so lookups are done with permutes instead of
+  // gathers.
+  alignas(32) u32 palette[16];
+  DecodePalette_AVX2(palette, tlut, tlutfmt, 16);
+  const __m256i palette_lo = _mm256_load_si256((const __m256i*)palette);
+  const __m256i palette_hi = _mm256_load_si256((const __m256i*)palette + 1);
+
+  // Each byte holds two texels, with the leftmost one in the high nibble.
+  const __m256i shifts = _mm256_setr_epi32(4, 0, 12, 8, 20, 16, 28, 24);
+  const __m256i kMask_xf = _mm256_set1_epi32(0xF);
+  const __m256i k7 = _mm256_set1_epi32(7);
+
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
+      {
+        u32 val;
+        std::memcpy(&val, src + 4 * xStep, sizeof(u32));
+        const __m256i index =
+            _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(val), shifts), kMask_xf);
+        const __m256i lo = _mm256_permutevar8x32_epi32(palette_lo, index);
+        const __m256i hi = _mm256_permutevar8x32_epi32(palette_hi, index);
+        const __m256i texels = _mm256_blendv_epi8(lo, hi, _mm256_cmpgt_epi32(index, k7));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x), texels);
+      }
+    }
+  }
+}
+
 // JSD 01/06/11:
 // TODO: we really should ensure BOTH the source and destination addresses are aligned to 16-byte
 // boundaries to squeeze out a little more performance. _mm_loadu_si128/_mm_storeu_si128 is slower
@@ -521,6 +651,29 @@ static void TexDecoder_DecodeImpl_I8(u32* dst, const u8* src, int width, int hei
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C8_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  alignas(32) u32 palette[256];
+  DecodePalette_AVX2(palette, tlut, tlutfmt, 256);
+
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
+      {
+        const __m256i index =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + 8 * xStep)));
+        const __m256i texels = _mm256_i32gather_epi32((const int*)palette, index, 4);
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x), texels);
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_C8(u32* dst, const u8* src, int width, int height,
                                      TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                      int Wsteps4, int Wsteps8)
@@ -661,6 +814,60 @@ static void TexDecoder_DecodeImpl_IA8(u32* dst, const u8* src, int width, int he
   }
 }
 
+template <TLUTFormat tlutfmt>
+FUNCTION_TARGET_AVX2 static void DecodeC14X2_AVX2(u32* dst, const u8* src, int width, int height,
+                                                  const u8* tlut, int Wsteps4)
+{
+  // The palette can have up to 16384 entries, so unlike C4/C8 it is not worth decoding it up front.
+  // Entries are gathered as 32-bit values from their 16-bit slots instead. This reads two bytes
+  // past the entry, which is fine since palettes always live in TMEM, well before its end.
+  const __m128i kSwap16 = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+  const __m256i kMask_x3fff = _mm256_set1_epi32(0x3FFF);
+
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      // Two rows of four texels each are decoded at a time.
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        const __m128i indices =
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + 8 * xStep)), kSwap16);
+        const __m256i index = _mm256_and_si256(_mm256_cvtepu16_epi32(indices), kMask_x3fff);
+        const __m256i raw = _mm256_i32gather_epi32((const int*)tlut, index, 2);
+        const __m256i texels = DecodePaletteColors_AVX2<tlutfmt>(raw);
+        _mm_storeu_si128((__m128i*)(dst + (y + iy) * width + x), _mm256_castsi256_si128(texels));
+        _mm_storeu_si128((__m128i*)(dst + (y + iy + 1) * width + x),
+                         _mm256_extracti128_si256(texels, 1));
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C14X2_AVX2(u32* dst, const u8* src, int width, int height,
+                                             TextureFormat texformat, const u8* tlut,
+                                             TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  switch (tlutfmt)
+  {
+  case TLUTFormat::RGB5A3:
+    DecodeC14X2_AVX2<TLUTFormat::RGB5A3>(dst, src, width, height, tlut, Wsteps4);
+    break;
+
+  case TLUTFormat::IA8:
+    DecodeC14X2_AVX2<TLUTFormat::IA8>(dst, src, width, height, tlut, Wsteps4);
+    break;
+
+  case TLUTFormat::RGB565:
+    DecodeC14X2_AVX2<TLUTFormat::RGB565>(dst, src, width, height, tlut, Wsteps4);
+    break;
+
+  default:
+    break;
+  }
+}
+
 static void TexDecoder_DecodeImpl_C14X2(u32* dst, const u8* src, int width, int height,
                                         TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                         int Wsteps4, int Wsteps8)
@@ -1153,6 +1360,204 @@ static void TexDecoder_DecodeImpl_RGBA8(u32* dst, const u8* src, int width, int
   }
 }
 
+// Computes the four-entry color palettes of two consecutive DXT blocks. Entry i of each palette
+// is the color selected by the 2-bit index value i.
+static DOLPHIN_FORCE_INLINE void DecodeDXTPalettes(const __m128i dxt, __m128i* mmcolors0,
+                                              __m128i* mmcolors1)
+{
+  // JSD NOTE: You may see many strange patterns of behavior in the below code, but they
+  // are for performance reasons. Sometimes, calculating what should be obvious hard-coded
+  // constants is faster than loading their values from memory. Unfortunately, there is no
+  // way to inline 128-bit constants from opcodes so they must be loaded from memory. This
+  // seems a little ridiculous to me in that you can't even generate a constant value of 1
+  // without having to load it from memory. So, I stored the minimal constant I could,
+  // 128-bits worth of 1s :). Then I use sequences of shifts to squash it to the appropriate
+  // size and bitpositions that I need.
+  const __m128i allFFs128 = _mm_cmpeq_epi32(_mm_setzero_si128(), _mm_setzero_si128());
+
+  __m128i argb888x4;
+  __m128i c1 = _mm_unpackhi_epi16(dxt, dxt);
+  c1 = _mm_slli_si128(c1, 8);
+  const __m128i c0 =
+      _mm_or_si128(c1, _mm_srli_si128(_mm_slli_si128(_mm_unpacklo_epi16(dxt, dxt), 8), 8));
+
+  // Compare rgb0 to rgb1:
+  // Each 32-bit word will contain either 0xFFFFFFFF or 0x00000000 for true/false.
+  const __m128i c0cmp = _mm_srli_epi32(_mm_slli_epi32(_mm_srli_epi64(c0, 8), 16), 16);
+  const __m128i c0shr = _mm_srli_epi64(c0cmp, 32);
+  const __m128i cmprgb0rgb1 = _mm_cmpgt_epi32(c0cmp, c0shr);
+
+  int cmp0 = _mm_extract_epi16(cmprgb0rgb1, 0);
+  int cmp1 = _mm_extract_epi16(cmprgb0rgb1, 4);
+
+  // green:
+  // NOTE: We start with the larger number of bits (6) firts for G and shift the mask down
+  // 1 bit to get a 5-bit mask later for R and B components.
+  // low6mask == _mm_set_epi32(0x0000FC00, 0x0000FC00, 0x0000FC00, 0x0000FC00)
+  const __m128i low6mask = _mm_slli_epi32(_mm_srli_epi32(allFFs128, 24 + 2), 8 + 2);
+  const __m128i gtmp = _mm_srli_epi32(c0, 3);
+  const __m128i g0 = _mm_and_si128(gtmp, low6mask);
+  // low3mask == _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300)
+  const __m128i g1 = _mm_and_si128(
+      _mm_srli_epi32(gtmp, 6), _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300));
+  argb888x4 = _mm_or_si128(g0, g1);
+  // red:
+  // low5mask == _mm_set_epi32(0x000000F8, 0x000000F8, 0x000000F8, 0x000000F8)
+  const __m128i low5mask = _mm_slli_epi32(_mm_srli_epi32(low6mask, 8 + 3), 3);
+  const __m128i r0 = _mm_and_si128(c0, low5mask);
+  const __m128i r1 = _mm_srli_epi32(r0, 5);
+  argb888x4 = _mm_or_si128(argb888x4, _mm_or_si128(r0, r1));
+  // blue:
+  // _mm_slli_epi32(low5mask, 16) == _mm_set_epi32(0x00F80000, 0x00F80000, 0x00F80000,
+  // 0x00F80000)
+  const __m128i b0 = _mm_and_si128(_mm_srli_epi32(c0, 5), _mm_slli_epi32(low5mask, 16));
+  const __m128i b1 = _mm_srli_epi16(b0, 5);
+  // OR in the fixed alpha component
+  // _mm_slli_epi32( allFFs128, 24 ) == _mm_set_epi32(0xFF000000, 0xFF000000, 0xFF000000,
+  // 0xFF000000)
+  argb888x4 = _mm_or_si128(_mm_or_si128(argb888x4, _mm_slli_epi32(allFFs128, 24)),
+                           _mm_or_si128(b0, b1));
+  // calculate RGB2 and RGB3:
+  const __m128i rgb0 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(2, 2, 0, 0));
+  const __m128i rgb1 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(3, 3, 1, 1));
+  const __m128i rrggbb0 =
+      _mm_and_si128(_mm_unpacklo_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
+  const __m128i rrggbb1 =
+      _mm_and_si128(_mm_unpacklo_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
+  const __m128i rrggbb01 =
+      _mm_and_si128(_mm_unpackhi_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
+  const __m128i rrggbb11 =
+      _mm_and_si128(_mm_unpackhi_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
+
+  __m128i rgb2, rgb3;
+
+  // if (rgb0 > rgb1):
+  if (cmp0 != 0)
+  {
+    // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
+    // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
+    const __m128i rrggbbsum = _mm_add_epi16(rrggbb0, rrggbb1);
+
+    const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb0, 1);
+    const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb0, 2);
+
+    const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb1, 1);
+    const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb1, 2);
+
+    const __m128i rrggbb2 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
+    const __m128i rrggbb3 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
+
+    const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
+    const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
+
+    rgb2 = _mm_and_si128(rgb2dup, _mm_srli_si128(allFFs128, 8));
+    rgb3 = _mm_and_si128(rgb3dup, _mm_srli_si128(allFFs128, 8));
+  }
+  else
+  {
+    // RGB2b = avg(RGB0, RGB1)
+    const __m128i rrggbb21 = _mm_srai_epi16(_mm_add_epi16(rrggbb0, rrggbb1), 1);
+    const __m128i rgb210 = _mm_srli_si128(_mm_packus_epi16(rrggbb21, rrggbb21), 8);
+    rgb2 = rgb210;
+    rgb3 = _mm_and_si128(rgb210, _mm_srli_epi32(allFFs128, 8));
+  }
+
+  // if (rgb0 > rgb1):
+  if (cmp1 != 0)
+  {
+    // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
+    // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
+    const __m128i rrggbbsum = _mm_add_epi16(rrggbb01, rrggbb11);
+
+    const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb01, 1);
+    const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb01, 2);
+
+    const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb11, 1);
+    const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb11, 2);
+
+    const __m128i rrggbb2 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
+    const __m128i rrggbb3 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
+
+    const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
+    const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
+
+    rgb2 = _mm_or_si128(rgb2, _mm_and_si128(rgb2dup, _mm_slli_si128(allFFs128, 8)));
+    rgb3 = _mm_or_si128(rgb3, _mm_and_si128(rgb3dup, _mm_slli_si128(allFFs128, 8)));
+  }
+  else
+  {
+    // RGB2b = avg(RGB0, RGB1)
+    const __m128i rrggbb211 = _mm_srai_epi16(_mm_add_epi16(rrggbb01, rrggbb11), 1);
+    const __m128i rgb211 = _mm_slli_si128(_mm_packus_epi16(rrggbb211, rrggbb211), 8);
+    rgb2 = _mm_or_si128(rgb2, rgb211);
+
+    // _mm_srli_epi32( allFFs128, 8 ) == _mm_set_epi32(0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF,
+    // 0x00FFFFFF)
+    // Make this color fully transparent:
+    rgb3 = _mm_or_si128(rgb3, _mm_and_si128(_mm_and_si128(rgb2, _mm_srli_epi32(allFFs128, 8)),
+                                            _mm_slli_si128(allFFs128, 8)));
+  }
+
+  // Create an array for color lookups for DXT0 so we can use the 2-bit indices:
+  *mmcolors0 = _mm_or_si128(
+      _mm_or_si128(_mm_srli_si128(_mm_slli_si128(argb888x4, 8), 8),
+                   _mm_slli_si128(_mm_srli_si128(_mm_slli_si128(rgb2, 8), 8 + 4), 8)),
+      _mm_slli_si128(_mm_srli_si128(rgb3, 4), 8 + 4));
+
+  // Create an array for color lookups for DXT1 so we can use the 2-bit indices:
+  *mmcolors1 =
+      _mm_or_si128(_mm_or_si128(_mm_srli_si128(argb888x4, 8),
+                                _mm_slli_si128(_mm_srli_si128(rgb2, 8 + 4), 8)),
+                   _mm_slli_si128(_mm_srli_si128(rgb3, 8 + 4), 8 + 4));
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_CMPR_AVX2(u32* dst, const u8* src, int width, int height,
+                                            TextureFormat texformat, const u8* tlut,
+                                            TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Each row of 8 texels spans two DXT blocks. Both palettes are put in a single register, with the
+  // second block's colors in the upper half, so that a whole row is looked up with one permute.
+  const __m256i kShifts = _mm256_setr_epi32(6, 4, 2, 0, 6, 4, 2, 0);
+  const __m256i kBlockOffset = _mm256_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4);
+  const __m256i kMask_x3 = _mm256_set1_epi32(3);
+
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int z = 0, xStep = 2 * yStep; z < 2; ++z, xStep++)
+      {
+        const u8* block = src + sizeof(DXTBlock) * 2 * xStep;
+        const __m128i dxt = _mm_loadu_si128((const __m128i*)block);
+
+        __m128i mmcolors0, mmcolors1;
+        DecodeDXTPalettes(dxt, &mmcolors0, &mmcolors1);
+        const __m256i colors =
+            _mm256_inserti128_si256(_mm256_castsi128_si256(mmcolors0), mmcolors1, 1);
+
+        // The selector bytes of both blocks, one per row, broadcast to their half of the register.
+        const __m256i lines = _mm256_permutevar8x32_epi32(
+            _mm256_castsi128_si256(dxt), _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3));
+
+        u32* dst32 = dst + (y + z * 4) * width + x;
+        for (int row = 0; row < 4; row++)
+        {
+          const __m256i shifts = _mm256_add_epi32(kShifts, _mm256_set1_epi32(row * 8));
+          const __m256i index = _mm256_add_epi32(
+              _mm256_and_si256(_mm256_srlv_epi32(lines, shifts), kMask_x3), kBlockOffset);
+          _mm256_storeu_si256((__m256i*)(dst32 + width * row),
+                              _mm256_permutevar8x32_epi32(colors, index));
+        }
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int height,
                                        TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                        int Wsteps4, int Wsteps8)
@@ -1172,16 +1577,6 @@ static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int h
       // parallelizable at this level, so we do.
       for (int z = 0, xStep = 2 * yStep; z < 2; ++z, xStep++)
       {
-        // JSD NOTE: You may see many strange patterns of behavior in the below code, but they
-        // are for performance reasons. Sometimes, calculating what should be obvious hard-coded
-        // constants is faster than loading their values from memory. Unfortunately, there is no
-        // way to inline 128-bit constants from opcodes so they must be loaded from memory. This
-        // seems a little ridiculous to me in that you can't even generate a constant value of 1
-        // without having to load it from memory. So, I stored the minimal constant I could,
-        // 128-bits worth of 1s :). Then I use sequences of shifts to squash it to the appropriate
-        // size and bitpositions that I need.
-        const __m128i allFFs128 = _mm_cmpeq_epi32(_mm_setzero_si128(), _mm_setzero_si128());
-
         // Load 128 bits, i.e. two DXTBlocks (64-bits each)
         const __m128i dxt = _mm_loadu_si128((__m128i*)(src + sizeof(struct DXTBlock) * 2 * xStep));
 
@@ -1192,144 +1587,8 @@ static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int h
         u32 dxt0sel = dxttmp[1];
         u32 dxt1sel = dxttmp[3];
 
-        __m128i argb888x4;
-        __m128i c1 = _mm_unpackhi_epi16(dxt, dxt);
-        c1 = _mm_slli_si128(c1, 8);
-        const __m128i c0 =
-            _mm_or_si128(c1, _mm_srli_si128(_mm_slli_si128(_mm_unpacklo_epi16(dxt, dxt), 8), 8));
-
-        // Compare rgb0 to rgb1:
-        // Each 32-bit word will contain either 0xFFFFFFFF or 0x00000000 for true/false.
-        const __m128i c0cmp = _mm_srli_epi32(_mm_slli_epi32(_mm_srli_epi64(c0, 8), 16), 16);
-        const __m128i c0shr = _mm_srli_epi64(c0cmp, 32);
-        const __m128i cmprgb0rgb1 = _mm_cmpgt_epi32(c0cmp, c0shr);
-
-        int cmp0 = _mm_extract_epi16(cmprgb0rgb1, 0);
-        int cmp1 = _mm_extract_epi16(cmprgb0rgb1, 4);
-
-        // green:
-        // NOTE: We start with the larger number of bits (6) firts for G and shift the mask down
-        // 1 bit to get a 5-bit mask later for R and B components.
-        // low6mask == _mm_set_epi32(0x0000FC00, 0x0000FC00, 0x0000FC00, 0x0000FC00)
-        const __m128i low6mask = _mm_slli_epi32(_mm_srli_epi32(allFFs128, 24 + 2), 8 + 2);
-        const __m128i gtmp = _mm_srli_epi32(c0, 3);
-        const __m128i g0 = _mm_and_si128(gtmp, low6mask);
-        // low3mask == _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300)
-        const __m128i g1 = _mm_and_si128(
-            _mm_srli_epi32(gtmp, 6), _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300));
-        argb888x4 = _mm_or_si128(g0, g1);
-        // red:
-        // low5mask == _mm_set_epi32(0x000000F8, 0x000000F8, 0x000000F8, 0x000000F8)
-        const __m128i low5mask = _mm_slli_epi32(_mm_srli_epi32(low6mask, 8 + 3), 3);
-        const __m128i r0 = _mm_and_si128(c0, low5mask);
-        const __m128i r1 = _mm_srli_epi32(r0, 5);
-        argb888x4 = _mm_or_si128(argb888x4, _mm_or_si128(r0, r1));
-        // blue:
-        // _mm_slli_epi32(low5mask, 16) == _mm_set_epi32(0x00F80000, 0x00F80000, 0x00F80000,
-        // 0x00F80000)
-        const __m128i b0 = _mm_and_si128(_mm_srli_epi32(c0, 5), _mm_slli_epi32(low5mask, 16));
-        const __m128i b1 = _mm_srli_epi16(b0, 5);
-        // OR in the fixed alpha component
-        // _mm_slli_epi32( allFFs128, 24 ) == _mm_set_epi32(0xFF000000, 0xFF000000, 0xFF000000,
-        // 0xFF000000)
-        argb888x4 = _mm_or_si128(_mm_or_si128(argb888x4, _mm_slli_epi32(allFFs128, 24)),
-                                 _mm_or_si128(b0, b1));
-        // calculate RGB2 and RGB3:
-        const __m128i rgb0 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(2, 2, 0, 0));
-        const __m128i rgb1 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(3, 3, 1, 1));
-        const __m128i rrggbb0 =
-            _mm_and_si128(_mm_unpacklo_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
-        const __m128i rrggbb1 =
-            _mm_and_si128(_mm_unpacklo_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
-        const __m128i rrggbb01 =
-            _mm_and_si128(_mm_unpackhi_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
-        const __m128i rrggbb11 =
-            _mm_and_si128(_mm_unpackhi_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
-
-        __m128i rgb2, rgb3;
-
-        // if (rgb0 > rgb1):
-        if (cmp0 != 0)
-        {
-          // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
-          // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
-          const __m128i rrggbbsum = _mm_add_epi16(rrggbb0, rrggbb1);
-
-          const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb0, 1);
-          const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb0, 2);
-
-          const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb1, 1);
-          const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb1, 2);
-
-          const __m128i rrggbb2 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
-          const __m128i rrggbb3 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
-
-          const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
-          const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
-
-          rgb2 = _mm_and_si128(rgb2dup, _mm_srli_si128(allFFs128, 8));
-          rgb3 = _mm_and_si128(rgb3dup, _mm_srli_si128(allFFs128, 8));
-        }
-        else
-        {
-          // RGB2b = avg(RGB0, RGB1)
-          const __m128i rrggbb21 = _mm_srai_epi16(_mm_add_epi16(rrggbb0, rrggbb1), 1);
-          const __m128i rgb210 = _mm_srli_si128(_mm_packus_epi16(rrggbb21, rrggbb21), 8);
-          rgb2 = rgb210;
-          rgb3 = _mm_and_si128(rgb210, _mm_srli_epi32(allFFs128, 8));
-        }
-
-        // if (rgb0 > rgb1):
-        if (cmp1 != 0)
-        {
-          // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
-          // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
-          const __m128i rrggbbsum = _mm_add_epi16(rrggbb01, rrggbb11);
-
-          const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb01, 1);
-          const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb01, 2);
-
-          const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb11, 1);
-          const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb11, 2);
-
-          const __m128i rrggbb2 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
-          const __m128i rrggbb3 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
-
-          const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
-          const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
-
-          rgb2 = _mm_or_si128(rgb2, _mm_and_si128(rgb2dup, _mm_slli_si128(allFFs128, 8)));
-          rgb3 = _mm_or_si128(rgb3, _mm_and_si128(rgb3dup, _mm_slli_si128(allFFs128, 8)));
-        }
-        else
-        {
-          // RGB2b = avg(RGB0, RGB1)
-          const __m128i rrggbb211 = _mm_srai_epi16(_mm_add_epi16(rrggbb01, rrggbb11), 1);
-          const __m128i rgb211 = _mm_slli_si128(_mm_packus_epi16(rrggbb211, rrggbb211), 8);
-          rgb2 = _mm_or_si128(rgb2, rgb211);
-
-          // _mm_srli_epi32( allFFs128, 8 ) == _mm_set_epi32(0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF,
-          // 0x00FFFFFF)
-          // Make this color fully transparent:
-          rgb3 = _mm_or_si128(rgb3, _mm_and_si128(_mm_and_si128(rgb2, _mm_srli_epi32(allFFs128, 8)),
-                                                  _mm_slli_si128(allFFs128, 8)));
-        }
-
-        // Create an array for color lookups for DXT0 so we can use the 2-bit indices:
-        const __m128i mmcolors0 = _mm_or_si128(
-            _mm_or_si128(_mm_srli_si128(_mm_slli_si128(argb888x4, 8), 8),
-                         _mm_slli_si128(_mm_srli_si128(_mm_slli_si128(rgb2, 8), 8 + 4), 8)),
-            _mm_slli_si128(_mm_srli_si128(rgb3, 4), 8 + 4));
-
-        // Create an array for color lookups for DXT1 so we can use the 2-bit indices:
-        const __m128i mmcolors1 =
-            _mm_or_si128(_mm_or_si128(_mm_srli_si128(argb888x4, 8),
-                                      _mm_slli_si128(_mm_srli_si128(rgb2, 8 + 4), 8)),
-                         _mm_slli_si128(_mm_srli_si128(rgb3, 8 + 4), 8 + 4));
+        __m128i mmcolors0, mmcolors1;
+        DecodeDXTPalettes(dxt, &mmcolors0, &mmcolors1);
 
 // The #ifdef CHECKs here and below are to compare correctness of output against the reference code.
 // Don't use them in a normal build.
@@ -1418,7 +1677,11 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
   switch (texformat)
   {
   case TextureFormat::C4:
-    TexDecoder_DecodeImpl_C4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C4_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
     break;
 
   case TextureFormat::I4:
@@ -1438,7 +1701,11 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::C8:
-    TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
     break;
 
   case TextureFormat::IA4:
@@ -1455,8 +1722,12 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::C14X2:
-    TexDecoder_DecodeImpl_C14X2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
-                                Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C14X2_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                       Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C14X2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                  Wsteps8);
     break;
 
   case TextureFormat::RGB565:
@@ -1483,7 +1754,12 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::CMPR:
-    TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_CMPR_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                      Wsteps8);
+    else
+      TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                 Wsteps8);
     break;
 
   case TextureFormat::XFB:
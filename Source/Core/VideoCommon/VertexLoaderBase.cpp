@@ -16,6 +16,7 @@
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
+#include "Common/WorkerPool.h"
 
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/VertexLoader.h"
@@ -26,6 +27,19 @@
 #include "VideoCommon/VertexLoaderARM64.h"
 #endif
 
+static Common::WorkerPool s_worker_pool;
+
+void VertexLoaderBase::SetWorkerThreads(u32 num_threads)
+{
+  if (s_worker_pool.GetWorkerCount() != num_threads)
+    s_worker_pool.Reset(num_threads, "Vertex Loader");
+}
+
+Common::WorkerPool& VertexLoaderBase::GetWorkerPool()
+{
+  return s_worker_pool;
+}
+
 VertexLoaderBase::VertexLoaderBase(const TVtxDesc& vtx_desc, const VAT& vtx_attr)
     : m_VtxDesc{vtx_desc}, m_vat{vtx_attr}
 {
@@ -73,6 +87,28 @@ void VertexLoaderBase::SetVAT(const VAT& vat)
   m_VtxAttr.texCoord[7].Frac = vat.g2.Tex7Frac;
 };
 
+bool VertexLoaderBase::UsesVertexArrays() const
+{
+  for (int i = 0; i < 12; i++)
+  {
+    // 2 and 3 are 8 and 16 bit indices.
+    if (m_VtxDesc.GetVertexArrayStatus(i) >= 2)
+      return true;
+  }
+  return false;
+}
+
+bool VertexLoaderBase::IsFullyIndexed() const
+{
+  for (int i = 0; i < 12; i++)
+  {
+    // 1 is a direct attribute.
+    if (m_VtxDesc.GetVertexArrayStatus(i) == 1)
+      return false;
+  }
+  return UsesVertexArrays();
+}
+
 std::string VertexLoaderBase::ToString() const
 {
   std::string dest;
@@ -14,6 +14,11 @@
 
 class DataReader;
 
+namespace Common
+{
+class WorkerPool;
+}
+
 class VertexLoaderUID
 {
   std::array<u32, 5> vid;
@@ -63,6 +68,11 @@ public:
   static std::unique_ptr<VertexLoaderBase> CreateVertexLoader(const TVtxDesc& vtx_desc,
                                                               const VAT& vtx_attr);
   virtual ~VertexLoaderBase() {}
+
+  // Sets the number of threads, besides the GPU thread, that loaders may split large batches of
+  // vertices across. Does nothing if the number hasn't changed.
+  static void SetWorkerThreads(u32 num_threads);
+
   virtual int RunVertices(DataReader src, DataReader dst, int count) = 0;
 
   virtual bool IsInitialized() = 0;
@@ -72,6 +82,13 @@ public:
 
   virtual std::string GetName() const = 0;
 
+  // Whether any attribute is indexed, making the output depend on the vertex arrays.
+  bool UsesVertexArrays() const;
+
+  // Whether every attribute apart from the matrix indices is indexed, so that a raw vertex is
+  // nothing but the indices of its attributes.
+  bool IsFullyIndexed() const;
+
   // per loader public state
   int m_VertexSize = 0;  // number of bytes of a raw GC vertex
   PortableVertexDeclaration m_native_vtx_decl{};
@@ -85,6 +102,8 @@ protected:
   VertexLoaderBase(const TVtxDesc& vtx_desc, const VAT& vtx_attr);
   void SetVAT(const VAT& vat);
 
+  static Common::WorkerPool& GetWorkerPool();
+
   // GC vertex format
   TVtxAttr m_VtxAttr;  // VAT decoded into easy format
   TVtxDesc m_VtxDesc;  // Not really used currently - or well it is, but could be easily avoided.
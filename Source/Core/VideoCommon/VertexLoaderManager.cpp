@@ -5,6 +5,7 @@
 #include "VideoCommon/VertexLoaderManager.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -15,18 +16,22 @@
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/MathUtil.h"
 #include "Core/HW/Memmap.h"
 
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/DisplayListCache.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/StageTimings.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 
 namespace VertexLoaderManager
 {
@@ -249,6 +254,98 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
   return loader;
 }
 
+// Draws with fewer vertices than this aren't deduplicated, as there is little to gain. The loaded
+// vertices need room for the last three vertices of the draw after them as well.
+constexpr int DEDUPLICATION_MIN_VERTICES = 32;
+
+// The distinct raw vertices of the current draw, which vertex of those each of its vertices is, and
+// a hash table of indices into the distinct vertices plus one.
+static std::vector<u8> s_unique_vertices;
+static std::vector<u16> s_vertex_remap;
+static std::vector<u16> s_unique_vertex_table;
+
+static u32 HashRawVertex(const u8* vertex, u32 size)
+{
+  constexpr u64 MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+  u64 hash = size;
+  for (; size >= sizeof(u64); size -= sizeof(u64), vertex += sizeof(u64))
+  {
+    u64 value;
+    std::memcpy(&value, vertex, sizeof(u64));
+    hash = (hash ^ value) * MULTIPLIER;
+  }
+  if (size != 0)
+  {
+    u64 value = 0;
+    std::memcpy(&value, vertex, size);
+    hash = (hash ^ value) * MULTIPLIER;
+  }
+  return static_cast<u32>(hash >> 32);
+}
+
+// Finds the distinct vertices of a draw whose attributes are all indexed, by the indices of their
+// attributes. Returns the number of distinct vertices, or 0 if too few vertices repeat for loading
+// only the distinct ones to pay off.
+static u32 FindUniqueVertices(const u8* src, u32 count, u32 vertex_size)
+{
+  const u32 table_mask = MathUtil::NextPowerOf2(count * 2) - 1;
+  s_unique_vertex_table.assign(table_mask + 1, 0);
+  s_unique_vertices.resize(count * vertex_size);
+  s_vertex_remap.resize(count);
+
+  const u32 max_unique_vertices = count - count / 4;
+  u32 num_unique_vertices = 0;
+  for (u32 i = 0; i < count; ++i)
+  {
+    const u8* const vertex = src + i * vertex_size;
+    u32 slot = HashRawVertex(vertex, vertex_size) & table_mask;
+    while (true)
+    {
+      const u16 entry = s_unique_vertex_table[slot];
+      if (entry == 0)
+      {
+        if (num_unique_vertices == max_unique_vertices)
+          return 0;
+
+        std::memcpy(&s_unique_vertices[num_unique_vertices * vertex_size], vertex, vertex_size);
+        s_vertex_remap[i] = static_cast<u16>(num_unique_vertices);
+        s_unique_vertex_table[slot] = static_cast<u16>(++num_unique_vertices);
+        break;
+      }
+      if (std::memcmp(&s_unique_vertices[(entry - 1) * vertex_size], vertex, vertex_size) == 0)
+      {
+        s_vertex_remap[i] = entry - 1;
+        break;
+      }
+      slot = (slot + 1) & table_mask;
+    }
+  }
+  return num_unique_vertices;
+}
+
+// Loads the distinct vertices found by FindUniqueVertices. Returns false if the loader skipped any
+// of them, which breaks the remapping, so the draw has to be loaded normally instead.
+static bool RunUniqueVertices(VertexLoaderBase* loader, DataReader src, DataReader dst, u32 count,
+                              u32 num_unique_vertices)
+{
+  const u32 vertex_size = loader->m_VertexSize;
+  u8* const unique_vertices = s_unique_vertices.data();
+  const DataReader unique_src(unique_vertices, unique_vertices + num_unique_vertices * vertex_size);
+  if (loader->RunVertices(unique_src, dst, num_unique_vertices) !=
+      static_cast<int>(num_unique_vertices))
+  {
+    return false;
+  }
+
+  // The zfreeze state has to come from the last vertices of the draw, not from the last distinct
+  // ones. Those are loaded again into the unused space after the distinct vertices.
+  const u32 stride = loader->m_native_vtx_decl.stride;
+  src.Skip((count - 3) * vertex_size);
+  dst.Skip(num_unique_vertices * stride);
+  loader->RunVertices(src, dst, 3);
+  return true;
+}
+
 int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess)
 {
   if (!count)
@@ -269,6 +366,11 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   {
     g_vertex_manager->Flush();
   }
+  if (loader->m_native_components != g_current_components)
+  {
+    g_vertex_manager->SetVertexShaderUidChanged();
+    g_vertex_manager->SetPixelShaderUidChanged();
+  }
   s_current_vtx_fmt = loader->m_native_vertex_format;
   g_current_components = loader->m_native_components;
   VertexShaderManager::SetVertexFormat(loader->m_native_components);
@@ -281,10 +383,30 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   DataReader dst = g_vertex_manager->PrepareForAdditionalData(
       primitive, count, loader->m_native_vtx_decl.stride, cullall);
 
-  count = loader->RunVertices(src, dst, count);
+  // Making room for the vertices may have flushed the previous ones, which is counted separately.
+  StageTimings::ScopedStage stage(StageTimings::Stage::VertexLoading);
 
-  g_vertex_manager->AddIndices(primitive, count);
-  g_vertex_manager->FlushData(count, loader->m_native_vtx_decl.stride);
+  // Vertices with the same attribute indices are the same vertex, so with every attribute indexed,
+  // each distinct vertex only has to be loaded and uploaded once.
+  u32 num_unique_vertices = 0;
+  if (g_ActiveConfig.bVertexDeduplication && count >= DEDUPLICATION_MIN_VERTICES &&
+      loader->IsFullyIndexed())
+  {
+    num_unique_vertices = FindUniqueVertices(src.GetPointer(), count, loader->m_VertexSize);
+  }
+  if (num_unique_vertices != 0 && RunUniqueVertices(loader, src, dst, count, num_unique_vertices))
+  {
+    g_vertex_manager->AddRemappedIndices(primitive, count, s_vertex_remap.data(),
+                                         num_unique_vertices);
+    g_vertex_manager->FlushData(num_unique_vertices, loader->m_native_vtx_decl.stride);
+  }
+  else
+  {
+    count = DisplayListCache::RunVertexLoader(loader, src, dst, count);
+
+    g_vertex_manager->AddIndices(primitive, count, loader->m_native_vtx_decl);
+    g_vertex_manager->FlushData(count, loader->m_native_vtx_decl.stride);
+  }
 
   ADDSTAT(g_stats.this_frame.num_prims, count);
   INCSTAT(g_stats.this_frame.num_primitive_joins);
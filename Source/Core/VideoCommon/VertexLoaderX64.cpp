@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <string>
 
@@ -11,6 +13,7 @@
 #include "Common/CommonTypes.h"
 #include "Common/Intrinsics.h"
 #include "Common/JitRegister.h"
+#include "Common/WorkerPool.h"
 #include "Common/x64ABI.h"
 #include "Common/x64Emitter.h"
 #include "VideoCommon/DataReader.h"
@@ -555,9 +558,89 @@ void VertexLoaderX64::GenerateVertexLoader()
   m_native_vtx_decl.stride = m_dst_ofs;
 }
 
+int VertexLoaderX64::RunLoader(const u8* src, u8* dst, u32 count) const
+{
+  return ((int (*)(const u8*, u8*, int, const void*))region)(src, dst, static_cast<int>(count),
+                                                             memory_base_ptr);
+}
+
 int VertexLoaderX64::RunVertices(DataReader src, DataReader dst, int count)
 {
   m_numLoadedVertices += count;
-  return ((int (*)(u8*, u8*, int, const void*))region)(src.GetPointer(), dst.GetPointer(), count,
-                                                       memory_base_ptr);
+
+  Common::WorkerPool& workers = GetWorkerPool();
+  const u32 stride = static_cast<u32>(m_native_vtx_decl.stride);
+  if (count < static_cast<int>(PARALLEL_MIN_VERTICES) || workers.GetWorkerCount() == 0 ||
+      stride > MAX_SCRATCH_VERTEX_SIZE)
+  {
+    return RunLoader(src.GetPointer(), dst.GetPointer(), count);
+  }
+
+  // Vertices whose position is indexed with 0xFFFF are skipped, so each chunk writes to where its
+  // output would start if nothing was skipped, and the chunks are compacted afterwards. The store
+  // of the last attribute of a vertex may write a few bytes past its end, which would clobber the
+  // first vertex of the next chunk while it is being written, so that vertex goes to a scratch
+  // buffer instead.
+  struct Chunk
+  {
+    u32 first_vertex;
+    u32 num_vertices;
+    u32 num_scratch;
+    u32 num_in_place;
+    std::array<u8, MAX_SCRATCH_VERTEX_SIZE + 16> scratch;
+  };
+  const u32 num_chunks =
+      std::min({workers.GetWorkerCount() + 1, static_cast<u32>(count) / PARALLEL_MIN_CHUNK_SIZE,
+                MAX_PARALLEL_CHUNKS});
+  const u32 chunk_size = static_cast<u32>(count) / num_chunks;
+  std::array<Chunk, MAX_PARALLEL_CHUNKS> chunks;
+  for (u32 i = 0; i < num_chunks; ++i)
+  {
+    chunks[i].first_vertex = i * chunk_size;
+    chunks[i].num_vertices = i + 1 < num_chunks ? chunk_size : count - i * chunk_size;
+    chunks[i].num_scratch = 0;
+  }
+
+  const u8* const src_base = src.GetPointer();
+  u8* const dst_base = dst.GetPointer();
+  const auto load_chunk = [&](u32 i) {
+    Chunk& chunk = chunks[i];
+    const u8* chunk_src = src_base + chunk.first_vertex * m_VertexSize;
+    u8* chunk_dst = dst_base + chunk.first_vertex * stride;
+    if (i != 0)
+    {
+      chunk.num_scratch = RunLoader(chunk_src, chunk.scratch.data(), 1);
+      chunk_src += m_VertexSize;
+      chunk_dst += stride;
+      chunk.first_vertex++;
+      chunk.num_vertices--;
+    }
+    chunk.num_in_place = RunLoader(chunk_src, chunk_dst, chunk.num_vertices);
+  };
+
+  // The loader saves the positions of the last vertices it loads for zfreeze, so the last chunk
+  // runs on its own once the others are done. Nothing else writes to the buffer by then, so all of
+  // it can be loaded in place.
+  const u32 last = num_chunks - 1;
+  workers.ParallelFor(last, load_chunk);
+  Chunk& last_chunk = chunks[last];
+  last_chunk.num_in_place =
+      RunLoader(src_base + last_chunk.first_vertex * m_VertexSize,
+                dst_base + last_chunk.first_vertex * stride, last_chunk.num_vertices);
+
+  u8* out = dst_base + chunks[0].num_in_place * stride;
+  for (u32 i = 1; i < num_chunks; ++i)
+  {
+    const Chunk& chunk = chunks[i];
+    if (chunk.num_scratch != 0)
+    {
+      std::memcpy(out, chunk.scratch.data(), stride);
+      out += stride;
+    }
+    const u8* in_place = dst_base + chunk.first_vertex * stride;
+    if (out != in_place)
+      std::memmove(out, in_place, chunk.num_in_place * stride);
+    out += chunk.num_in_place * stride;
+  }
+  return static_cast<int>((out - dst_base) / stride);
 }
@@ -19,6 +19,15 @@ protected:
   int RunVertices(DataReader src, DataReader dst, int count) override;
 
 private:
+  // Batches of at least this many vertices are split across the vertex loader worker threads, in
+  // chunks of at least PARALLEL_MIN_CHUNK_SIZE vertices.
+  static constexpr u32 PARALLEL_MIN_VERTICES = 4096;
+  static constexpr u32 PARALLEL_MIN_CHUNK_SIZE = 1024;
+  static constexpr u32 MAX_PARALLEL_CHUNKS = 16;
+  static constexpr u32 MAX_SCRATCH_VERTEX_SIZE = 256;
+
+  int RunLoader(const u8* src, u8* dst, u32 count) const;
+
   u32 m_src_ofs = 0;
   u32 m_dst_ofs = 0;
   Gen::FixupBranch m_skip_vertex;
@@ -28,6 +28,7 @@
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/SamplerCommon.h"
+#include "VideoCommon/StageTimings.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
@@ -97,11 +98,29 @@ u32 VertexManagerBase::GetRemainingSize() const
   return static_cast<u32>(m_end_buffer_pointer - m_cur_buffer_pointer);
 }
 
-void VertexManagerBase::AddIndices(int primitive, u32 num_vertices)
+void VertexManagerBase::AddIndices(int primitive, u32 num_vertices,
+                                   const PortableVertexDeclaration& vtx_decl)
 {
+  // The vertices were just loaded at the current buffer pointer, so they can be culled on the CPU
+  // before their indices are written. Lines and points are never culled.
+  if (g_ActiveConfig.bCPUCull && !m_cull_all && primitive < OpcodeDecoder::GX_DRAW_LINES &&
+      m_cpu_cull.TransformVertices(m_cur_buffer_pointer, num_vertices, vtx_decl))
+  {
+    const u32 num_culled = m_index_generator.AddCulledIndices(primitive, num_vertices, m_cpu_cull);
+    ADDSTAT(g_stats.this_frame.num_triangles_cpu_culled, num_culled);
+    return;
+  }
+
   m_index_generator.AddIndices(primitive, num_vertices);
 }
 
+void VertexManagerBase::AddRemappedIndices(int primitive, u32 num_vertices, const u16* remap,
+                                           u32 num_unique_vertices)
+{
+  // CPU culling works on the vertices in draw order, so deduplicated draws are never culled.
+  m_index_generator.AddRemappedIndices(primitive, num_vertices, remap, num_unique_vertices);
+}
+
 DataReader VertexManagerBase::PrepareForAdditionalData(int primitive, u32 count, u32 stride,
                                                        bool cullall)
 {
@@ -122,6 +141,7 @@ DataReader VertexManagerBase::PrepareForAdditionalData(int primitive, u32 count,
     // Have to update the rasterization state for point/line cull modes.
     m_current_primitive_type = new_primitive_type;
     SetRasterizationStateChanged();
+    SetGeometryShaderUidChanged();
   }
 
   // Check for size in buffer, if the buffer gets full, call Flush()
@@ -343,6 +363,7 @@ void VertexManagerBase::Flush()
     return;
 
   m_is_flushed = true;
+  StageTimings::ScopedStage stage(StageTimings::Stage::BackendSubmission);
 
 #if defined(_DEBUG) || defined(DEBUGFAST)
   PRIM_LOG("frame%d:\n texgen=%u, numchan=%u, dualtex=%u, ztex=%u, cole=%u, alpe=%u, ze=%u",
@@ -428,7 +449,10 @@ void VertexManagerBase::Flush()
     // Texture loading can cause palettes to be applied (-> uniforms -> draws).
     // Palette application does not use vertices, only a full-screen quad, so this is okay.
     // Same with GPU texture decoding, which uses compute shaders.
-    LoadTextures();
+    {
+      StageTimings::ScopedStage texture_stage(StageTimings::Stage::TextureLoading);
+      LoadTextures();
+    }
 
     // Now we can upload uniforms, as nothing else will override them.
     GeometryShaderManager::SetConstants();
@@ -436,8 +460,11 @@ void VertexManagerBase::Flush()
     UploadUniforms();
 
     // Update the pipeline, or compile one if needed.
-    UpdatePipelineConfig();
-    UpdatePipelineObject();
+    {
+      StageTimings::ScopedStage shader_stage(StageTimings::Stage::ShaderLookup);
+      UpdatePipelineConfig();
+      UpdatePipelineObject();
+    }
     if (m_current_pipeline_object)
     {
       g_renderer->SetPipeline(m_current_pipeline_object);
@@ -472,6 +499,9 @@ void VertexManagerBase::DoState(PointerWrap& p)
     // Flush old vertex data before loading state.
     Flush();
 
+    // The registers the shader UIDs are generated from are about to be replaced.
+    InvalidateShaderUids();
+
     // Clear all caches that touch RAM
     // (? these don't appear to touch any emulation state that gets saved. moved to on load only.)
     VertexLoaderManager::MarkAllDirty();
@@ -555,28 +585,51 @@ void VertexManagerBase::UpdatePipelineConfig()
     m_pipeline_config_changed = true;
   }
 
-  VertexShaderUid vs_uid = GetVertexShaderUid();
-  if (vs_uid != m_current_pipeline_config.vs_uid)
+  // The bounding box can also be disabled from the CPU thread, so it isn't tracked by BP writes.
+  const bool bbox_enabled = BoundingBox::IsEnabled();
+  if (bbox_enabled != m_bbox_enabled)
   {
-    m_current_pipeline_config.vs_uid = vs_uid;
-    m_current_uber_pipeline_config.vs_uid = UberShader::GetVertexShaderUid();
-    m_pipeline_config_changed = true;
+    m_bbox_enabled = bbox_enabled;
+    m_pixel_shader_uid_changed = true;
   }
 
-  PixelShaderUid ps_uid = GetPixelShaderUid();
-  if (ps_uid != m_current_pipeline_config.ps_uid)
+  if (m_vertex_shader_uid_changed)
   {
-    m_current_pipeline_config.ps_uid = ps_uid;
-    m_current_uber_pipeline_config.ps_uid = UberShader::GetPixelShaderUid();
-    m_pipeline_config_changed = true;
+    m_vertex_shader_uid_changed = false;
+
+    VertexShaderUid vs_uid = GetVertexShaderUid();
+    if (vs_uid != m_current_pipeline_config.vs_uid)
+    {
+      m_current_pipeline_config.vs_uid = vs_uid;
+      m_current_uber_pipeline_config.vs_uid = UberShader::GetVertexShaderUid();
+      m_pipeline_config_changed = true;
+    }
   }
 
-  GeometryShaderUid gs_uid = GetGeometryShaderUid(GetCurrentPrimitiveType());
-  if (gs_uid != m_current_pipeline_config.gs_uid)
+  if (m_pixel_shader_uid_changed)
   {
-    m_current_pipeline_config.gs_uid = gs_uid;
-    m_current_uber_pipeline_config.gs_uid = gs_uid;
-    m_pipeline_config_changed = true;
+    m_pixel_shader_uid_changed = false;
+
+    PixelShaderUid ps_uid = GetPixelShaderUid();
+    if (ps_uid != m_current_pipeline_config.ps_uid)
+    {
+      m_current_pipeline_config.ps_uid = ps_uid;
+      m_current_uber_pipeline_config.ps_uid = UberShader::GetPixelShaderUid();
+      m_pipeline_config_changed = true;
+    }
+  }
+
+  if (m_geometry_shader_uid_changed)
+  {
+    m_geometry_shader_uid_changed = false;
+
+    GeometryShaderUid gs_uid = GetGeometryShaderUid(GetCurrentPrimitiveType());
+    if (gs_uid != m_current_pipeline_config.gs_uid)
+    {
+      m_current_pipeline_config.gs_uid = gs_uid;
+      m_current_uber_pipeline_config.gs_uid = gs_uid;
+      m_pipeline_config_changed = true;
+    }
   }
 
   if (m_rasterization_state_changed)
@@ -9,6 +9,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
+#include "VideoCommon/CPUCull.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/RenderState.h"
 #include "VideoCommon/ShaderCache.h"
@@ -66,7 +67,9 @@ public:
   virtual bool Initialize();
 
   PrimitiveType GetCurrentPrimitiveType() const { return m_current_primitive_type; }
-  void AddIndices(int primitive, u32 num_vertices);
+  void AddIndices(int primitive, u32 num_vertices, const PortableVertexDeclaration& vtx_decl);
+  void AddRemappedIndices(int primitive, u32 num_vertices, const u16* remap,
+                          u32 num_unique_vertices);
   DataReader PrepareForAdditionalData(int primitive, u32 count, u32 stride, bool cullall);
   void FlushData(u32 count, u32 stride);
 
@@ -80,6 +83,17 @@ public:
   void SetRasterizationStateChanged() { m_rasterization_state_changed = true; }
   void SetDepthStateChanged() { m_depth_state_changed = true; }
   void SetBlendingStateChanged() { m_blending_state_changed = true; }
+
+  // Shader UIDs are only generated again when one of the registers they depend on is written.
+  void SetVertexShaderUidChanged() { m_vertex_shader_uid_changed = true; }
+  void SetPixelShaderUidChanged() { m_pixel_shader_uid_changed = true; }
+  void SetGeometryShaderUidChanged() { m_geometry_shader_uid_changed = true; }
+  void InvalidateShaderUids()
+  {
+    m_vertex_shader_uid_changed = true;
+    m_pixel_shader_uid_changed = true;
+    m_geometry_shader_uid_changed = true;
+  }
   void InvalidatePipelineObject()
   {
     m_current_pipeline_object = nullptr;
@@ -159,9 +173,14 @@ protected:
   bool m_rasterization_state_changed = true;
   bool m_depth_state_changed = true;
   bool m_blending_state_changed = true;
+  bool m_vertex_shader_uid_changed = true;
+  bool m_pixel_shader_uid_changed = true;
+  bool m_geometry_shader_uid_changed = true;
+  bool m_bbox_enabled = false;
   bool m_cull_all = false;
 
   IndexGenerator m_index_generator;
+  CPUCull m_cpu_cull;
 
 private:
   // Minimum number of draws per command buffer when attempting to preempt a readback operation.
@@ -353,52 +353,12 @@ void VertexShaderManager::SetConstants()
     switch (xfmem.projection.type)
     {
     case GX_PERSPECTIVE:
-      g_fProjectionMatrix[0] = rawProjection[0] * g_ActiveConfig.fAspectRatioHackW;
-      g_fProjectionMatrix[1] = 0.0f;
-      g_fProjectionMatrix[2] = rawProjection[1] * g_ActiveConfig.fAspectRatioHackW;
-      g_fProjectionMatrix[3] = 0.0f;
-
-      g_fProjectionMatrix[4] = 0.0f;
-      g_fProjectionMatrix[5] = rawProjection[2] * g_ActiveConfig.fAspectRatioHackH;
-      g_fProjectionMatrix[6] = rawProjection[3] * g_ActiveConfig.fAspectRatioHackH;
-      g_fProjectionMatrix[7] = 0.0f;
-
-      g_fProjectionMatrix[8] = 0.0f;
-      g_fProjectionMatrix[9] = 0.0f;
-      g_fProjectionMatrix[10] = rawProjection[4];
-      g_fProjectionMatrix[11] = rawProjection[5];
-
-      g_fProjectionMatrix[12] = 0.0f;
-      g_fProjectionMatrix[13] = 0.0f;
-
-      g_fProjectionMatrix[14] = -1.0f;
-      g_fProjectionMatrix[15] = 0.0f;
-
+      g_fProjectionMatrix = GetProjectionMatrix();
       g_stats.gproj = g_fProjectionMatrix;
       break;
 
     case GX_ORTHOGRAPHIC:
-      g_fProjectionMatrix[0] = rawProjection[0];
-      g_fProjectionMatrix[1] = 0.0f;
-      g_fProjectionMatrix[2] = 0.0f;
-      g_fProjectionMatrix[3] = rawProjection[1];
-
-      g_fProjectionMatrix[4] = 0.0f;
-      g_fProjectionMatrix[5] = rawProjection[2];
-      g_fProjectionMatrix[6] = 0.0f;
-      g_fProjectionMatrix[7] = rawProjection[3];
-
-      g_fProjectionMatrix[8] = 0.0f;
-      g_fProjectionMatrix[9] = 0.0f;
-      g_fProjectionMatrix[10] = rawProjection[4];
-      g_fProjectionMatrix[11] = rawProjection[5];
-
-      g_fProjectionMatrix[12] = 0.0f;
-      g_fProjectionMatrix[13] = 0.0f;
-
-      g_fProjectionMatrix[14] = 0.0f;
-      g_fProjectionMatrix[15] = 1.0f;
-
+      g_fProjectionMatrix = GetProjectionMatrix();
       g_stats.g2proj = g_fProjectionMatrix;
       g_stats.proj = rawProjection;
       break;
@@ -646,6 +606,67 @@ void VertexShaderManager::SetLightingConfigChanged()
   bLightingConfigChanged = true;
 }
 
+std::array<float, 16> VertexShaderManager::GetProjectionMatrix()
+{
+  const auto& rawProjection = xfmem.projection.rawProjection;
+  std::array<float, 16> projection;
+
+  switch (xfmem.projection.type)
+  {
+  case GX_PERSPECTIVE:
+    projection[0] = rawProjection[0] * g_ActiveConfig.fAspectRatioHackW;
+    projection[1] = 0.0f;
+    projection[2] = rawProjection[1] * g_ActiveConfig.fAspectRatioHackW;
+    projection[3] = 0.0f;
+
+    projection[4] = 0.0f;
+    projection[5] = rawProjection[2] * g_ActiveConfig.fAspectRatioHackH;
+    projection[6] = rawProjection[3] * g_ActiveConfig.fAspectRatioHackH;
+    projection[7] = 0.0f;
+
+    projection[8] = 0.0f;
+    projection[9] = 0.0f;
+    projection[10] = rawProjection[4];
+    projection[11] = rawProjection[5];
+
+    projection[12] = 0.0f;
+    projection[13] = 0.0f;
+
+    projection[14] = -1.0f;
+    projection[15] = 0.0f;
+    break;
+
+  case GX_ORTHOGRAPHIC:
+    projection[0] = rawProjection[0];
+    projection[1] = 0.0f;
+    projection[2] = 0.0f;
+    projection[3] = rawProjection[1];
+
+    projection[4] = 0.0f;
+    projection[5] = rawProjection[2];
+    projection[6] = 0.0f;
+    projection[7] = rawProjection[3];
+
+    projection[8] = 0.0f;
+    projection[9] = 0.0f;
+    projection[10] = rawProjection[4];
+    projection[11] = rawProjection[5];
+
+    projection[12] = 0.0f;
+    projection[13] = 0.0f;
+
+    projection[14] = 0.0f;
+    projection[15] = 1.0f;
+    break;
+
+  default:
+    // Keep the last valid projection, like SetConstants does.
+    return g_fProjectionMatrix;
+  }
+
+  return projection;
+}
+
 void VertexShaderManager::TransformToClipSpace(const float* data, float* out, u32 MtxIdx)
 {
   const float* world_matrix = &xfmem.posMatrices[(MtxIdx & 0x3f) * 4];
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 
 #include "Common/CommonTypes.h"
@@ -37,6 +38,10 @@ public:
   static void SetTexMatrixInfoChanged(int index);
   static void SetLightingConfigChanged();
 
+  // Builds the projection matrix from the current XF state, without free look or viewport
+  // correction applied. Unlike g_fProjectionMatrix, this doesn't wait for SetConstants.
+  static std::array<float, 16> GetProjectionMatrix();
+
   // data: 3 floats representing the X, Y and Z vertex model coordinates and the posmatrix index.
   // out:  4 floats which will be initialized with the corresponding clip space coordinates
   // NOTE: g_fProjectionMatrix must be up to date when this is called
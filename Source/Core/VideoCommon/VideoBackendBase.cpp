@@ -41,6 +41,7 @@
 #include "VideoCommon/BPStructs.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/DisplayListCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
@@ -48,7 +49,9 @@
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/StageTimings.h"
 #include "VideoCommon/TextureCacheBase.h"
+#include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
@@ -290,18 +293,23 @@ void VideoBackendBase::InitializeShared()
   PixelEngine::Init();
   BPInit();
   VertexLoaderManager::Init();
+  DisplayListCache::Init();
   VertexShaderManager::Init();
   GeometryShaderManager::Init();
   PixelShaderManager::Init();
 
   g_Config.VerifyValidity();
   UpdateActiveConfig();
+  VertexLoaderBase::SetWorkerThreads(g_ActiveConfig.GetVertexLoaderThreads());
 }
 
 void VideoBackendBase::ShutdownShared()
 {
   m_initialized = false;
 
+  DisplayListCache::Shutdown();
   VertexLoaderManager::Clear();
+  VertexLoaderBase::SetWorkerThreads(0);
+  StageTimings::Shutdown();
   Fifo::Shutdown();
 }
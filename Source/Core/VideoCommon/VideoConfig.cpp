@@ -82,6 +82,7 @@ void VideoConfig::Refresh()
   bShowNetPlayPing = Config::Get(Config::GFX_SHOW_NETPLAY_PING);
   bShowNetPlayMessages = Config::Get(Config::GFX_SHOW_NETPLAY_MESSAGES);
   bLogRenderTimeToFile = Config::Get(Config::GFX_LOG_RENDER_TIME_TO_FILE);
+  bLogGPUThreadTimesToFile = Config::Get(Config::GFX_LOG_GPU_THREAD_TIMES_TO_FILE);
   bOverlayStats = Config::Get(Config::GFX_OVERLAY_STATS);
   bOverlayProjStats = Config::Get(Config::GFX_OVERLAY_PROJ_STATS);
   bDumpTextures = Config::Get(Config::GFX_DUMP_TEXTURES);
@@ -90,6 +91,7 @@ void VideoConfig::Refresh()
   bDumpEFBTarget = Config::Get(Config::GFX_DUMP_EFB_TARGET);
   bDumpXFBTarget = Config::Get(Config::GFX_DUMP_XFB_TARGET);
   bDumpFramesAsImages = Config::Get(Config::GFX_DUMP_FRAMES_AS_IMAGES);
+  bDumpFrameHashes = Config::Get(Config::GFX_DUMP_FRAME_HASHES);
   bFreeLook = Config::Get(Config::GFX_FREE_LOOK);
   bUseFFV1 = Config::Get(Config::GFX_USE_FFV1);
   sDumpFormat = Config::Get(Config::GFX_DUMP_FORMAT);
@@ -97,6 +99,8 @@ void VideoConfig::Refresh()
   sDumpEncoder = Config::Get(Config::GFX_DUMP_ENCODER);
   sDumpPath = Config::Get(Config::GFX_DUMP_PATH);
   iBitrateKbps = Config::Get(Config::GFX_BITRATE_KBPS);
+  iDumpEncoderThreads = Config::Get(Config::GFX_DUMP_ENCODER_THREADS);
+  iDumpQueueSize = Config::Get(Config::GFX_DUMP_QUEUE_SIZE);
   bInternalResolutionFrameDumps = Config::Get(Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS);
   bEnableGPUTextureDecoding = Config::Get(Config::GFX_ENABLE_GPU_TEXTURE_DECODING);
   bEnablePixelLighting = Config::Get(Config::GFX_ENABLE_PIXEL_LIGHTING);
@@ -117,6 +121,12 @@ void VideoConfig::Refresh()
   iShaderCompilationMode = Config::Get(Config::GFX_SHADER_COMPILATION_MODE);
   iShaderCompilerThreads = Config::Get(Config::GFX_SHADER_COMPILER_THREADS);
   iShaderPrecompilerThreads = Config::Get(Config::GFX_SHADER_PRECOMPILER_THREADS);
+  iTextureDecodeThreads = Config::Get(Config::GFX_TEXTURE_DECODE_THREADS);
+  iVertexLoaderThreads = Config::Get(Config::GFX_VERTEX_LOADER_THREADS);
+  bCPUCull = Config::Get(Config::GFX_CPU_CULL);
+  bDisplayListCache = Config::Get(Config::GFX_DISPLAY_LIST_CACHE);
+  bDirectFifoRead = Config::Get(Config::GFX_DIRECT_FIFO_READ);
+  bVertexDeduplication = Config::Get(Config::GFX_VERTEX_DEDUPLICATION);
 
   bZComploc = Config::Get(Config::GFX_SW_ZCOMPLOC);
   bZFreeze = Config::Get(Config::GFX_SW_ZFREEZE);
@@ -222,3 +232,22 @@ u32 VideoConfig::GetShaderPrecompilerThreads() const
   else
     return GetNumAutoShaderCompilerThreads();
 }
+
+u32 VideoConfig::GetTextureDecodeThreads() const
+{
+  if (iTextureDecodeThreads >= 0)
+    return static_cast<u32>(iTextureDecodeThreads);
+
+  // Automatic number. The GPU thread takes part in decoding as well, and the emulated CPU thread
+  // needs a core of its own, so we use clamp(cpus - 3, 0, 3).
+  return static_cast<u32>(std::min(std::max(cpu_info.num_cores - 3, 0), 3));
+}
+
+u32 VideoConfig::GetVertexLoaderThreads() const
+{
+  if (iVertexLoaderThreads >= 0)
+    return static_cast<u32>(iVertexLoaderThreads);
+
+  // Same reasoning as for texture decoding. The two never run at the same time.
+  return static_cast<u32>(std::min(std::max(cpu_info.num_cores - 3, 0), 3));
+}
@@ -88,6 +88,7 @@ struct VideoConfig final
   bool bTexFmtOverlayEnable;
   bool bTexFmtOverlayCenter;
   bool bLogRenderTimeToFile;
+  bool bLogGPUThreadTimesToFile;
 
   // Render
   bool bWireFrame;
@@ -100,6 +101,8 @@ struct VideoConfig final
   bool bDumpEFBTarget;
   bool bDumpXFBTarget;
   bool bDumpFramesAsImages;
+  // Write a hash of every dumped frame to a text file, instead of encoding the frames.
+  bool bDumpFrameHashes;
   bool bUseFFV1;
   std::string sDumpCodec;
   std::string sDumpEncoder;
@@ -110,6 +113,10 @@ struct VideoConfig final
   bool bBorderlessFullscreen;
   bool bEnableGPUTextureDecoding;
   int iBitrateKbps;
+  // Number of threads used by the video encoder. 0 lets FFmpeg pick.
+  int iDumpEncoderThreads;
+  // Number of read back frames which can be waiting to be encoded before the GPU thread stalls.
+  int iDumpQueueSize;
 
   // Hacks
   bool bEFBAccessEnable;
@@ -176,6 +183,29 @@ struct VideoConfig final
   int iShaderCompilerThreads;
   int iShaderPrecompilerThreads;
 
+  // Number of worker threads used to decode large textures, in addition to the GPU thread.
+  // 0 decodes everything on the GPU thread.
+  // -1 uses an automatic number based on the CPU threads.
+  int iTextureDecodeThreads;
+
+  // Number of worker threads used to convert the vertices of large draws, in addition to the GPU
+  // thread.
+  // 0 converts everything on the GPU thread.
+  // -1 uses an automatic number based on the CPU threads.
+  int iVertexLoaderThreads;
+
+  // Drops back-facing, zero-area and off-screen triangles on the CPU before they are uploaded.
+  bool bCPUCull;
+
+  // Reuses the converted vertices of display lists that are called again unchanged.
+  bool bDisplayListCache;
+
+  // Parses the FIFO in place in emulated memory in dual core mode, instead of copying it first.
+  bool bDirectFifoRead;
+
+  // Converts each distinct vertex of a fully indexed draw once, and draws it with real indices.
+  bool bVertexDeduplication;
+
   // Static config per API
   // TODO: Move this out of VideoConfig
   struct
@@ -239,6 +269,8 @@ struct VideoConfig final
   bool UsingUberShaders() const;
   u32 GetShaderCompilerThreads() const;
   u32 GetShaderPrecompilerThreads() const;
+  u32 GetTextureDecodeThreads() const;
+  u32 GetVertexLoaderThreads() const;
 };
 
 extern VideoConfig g_Config;
@@ -57,6 +57,8 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
       if (xfmem.numChan.numColorChans != (newValue & 3))
         g_vertex_manager->Flush();
       VertexShaderManager::SetLightingConfigChanged();
+      g_vertex_manager->SetVertexShaderUidChanged();
+      g_vertex_manager->SetPixelShaderUidChanged();
       break;
 
     case XFMEM_SETCHAN0_AMBCOLOR:  // Channel Ambient Color
@@ -90,12 +92,15 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
       if (((u32*)&xfmem)[address] != (newValue & 0x7fff))
         g_vertex_manager->Flush();
       VertexShaderManager::SetLightingConfigChanged();
+      g_vertex_manager->SetVertexShaderUidChanged();
+      g_vertex_manager->SetPixelShaderUidChanged();
       break;
 
     case XFMEM_DUALTEX:
       if (xfmem.dualTexTrans.enabled != (newValue & 1))
         g_vertex_manager->Flush();
       VertexShaderManager::SetTexMatrixInfoChanged(-1);
+      g_vertex_manager->SetVertexShaderUidChanged();
       break;
 
     case XFMEM_SETMATRIXINDA:
@@ -136,6 +141,9 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     case XFMEM_SETNUMTEXGENS:  // GXSetNumTexGens
       if (xfmem.numTexGen.numTexGens != (newValue & 15))
         g_vertex_manager->Flush();
+      g_vertex_manager->SetVertexShaderUidChanged();
+      g_vertex_manager->SetPixelShaderUidChanged();
+      g_vertex_manager->SetGeometryShaderUidChanged();
       break;
 
     case XFMEM_SETTEXMTXINFO:
@@ -148,6 +156,8 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     case XFMEM_SETTEXMTXINFO + 7:
       g_vertex_manager->Flush();
       VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETTEXMTXINFO);
+      g_vertex_manager->SetVertexShaderUidChanged();
+      g_vertex_manager->SetPixelShaderUidChanged();
 
       nextAddress = XFMEM_SETTEXMTXINFO + 8;
       break;
@@ -162,6 +172,7 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     case XFMEM_SETPOSMTXINFO + 7:
       g_vertex_manager->Flush();
       VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETPOSMTXINFO);
+      g_vertex_manager->SetVertexShaderUidChanged();
 
       nextAddress = XFMEM_SETPOSMTXINFO + 8;
       break;
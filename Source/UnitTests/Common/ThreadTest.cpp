@@ -0,0 +1,83 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <optional>
+#include <vector>
+
+#if defined __linux__ && !defined ANDROID
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Thread.h"
+
+#if defined __linux__ && !defined ANDROID
+static std::vector<u32> GetCurrentThreadAffinity()
+{
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+
+  std::vector<u32> processors;
+  for (u32 processor = 0; processor < CPU_SETSIZE; ++processor)
+  {
+    if (CPU_ISSET(processor, &cpu_set))
+      processors.push_back(processor);
+  }
+  return processors;
+}
+#endif
+
+TEST(Thread, ParseProcessorList)
+{
+  EXPECT_EQ(std::vector<u32>({0, 1, 2, 3, 8}), Common::ParseProcessorList("0-3,8"));
+  EXPECT_EQ(std::vector<u32>({5}), Common::ParseProcessorList(" 5 "));
+
+  EXPECT_FALSE(Common::ParseProcessorList(""));
+  EXPECT_FALSE(Common::ParseProcessorList("3-1"));
+  EXPECT_FALSE(Common::ParseProcessorList("a"));
+  EXPECT_FALSE(Common::ParseProcessorList("-3"));
+  EXPECT_FALSE(Common::ParseProcessorList("1,,2"));
+  EXPECT_FALSE(Common::ParseProcessorList("node:"));
+}
+
+TEST(Thread, ProcessorNode)
+{
+#if defined __linux__ && !defined ANDROID
+  // The nodes are only listed by kernels built with NUMA support, which always have a node 0.
+  if (File::IsDirectory("/sys/devices/system/node/node0"))
+  {
+    const std::optional<std::vector<u32>> processors = Common::ParseProcessorList("node:0");
+    ASSERT_TRUE(processors);
+    for (u32 processor : *processors)
+      EXPECT_EQ(std::optional<u32>(0), Common::GetProcessorNode(processor));
+  }
+#endif
+
+  EXPECT_FALSE(Common::ParseProcessorList("node:64"));
+  EXPECT_FALSE(Common::ParseProcessorList("node:a"));
+  EXPECT_FALSE(Common::GetProcessorNode(0xffffffff));
+}
+
+TEST(Thread, SetCurrentThreadAffinity)
+{
+#if defined __linux__ && !defined ANDROID
+  const std::vector<u32> original = GetCurrentThreadAffinity();
+
+  ASSERT_TRUE(Common::SetCurrentThreadAffinity(std::vector<u32>{0}));
+  EXPECT_EQ(std::vector<u32>({0}), GetCurrentThreadAffinity());
+  EXPECT_EQ(0, sched_getcpu());
+
+  EXPECT_FALSE(Common::SetCurrentThreadAffinity(std::vector<u32>{CPU_SETSIZE}));
+
+  ASSERT_TRUE(Common::SetCurrentThreadAffinity(original));
+  EXPECT_EQ(original, GetCurrentThreadAffinity());
+#elif defined __APPLE__
+  EXPECT_FALSE(Common::SetCurrentThreadAffinity(std::vector<u32>{0}));
+#endif
+}
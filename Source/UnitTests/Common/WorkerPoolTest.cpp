@@ -0,0 +1,40 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/WorkerPool.h"
+
+TEST(WorkerPool, RunsEveryIndexOnce)
+{
+  for (u32 num_workers : {0, 1, 4})
+  {
+    Common::WorkerPool pool(num_workers, "WorkerPoolTest");
+    EXPECT_EQ(num_workers, pool.GetWorkerCount());
+
+    for (u32 count : {0, 1, 7, 1000})
+    {
+      std::vector<std::atomic<int>> calls(count);
+      pool.ParallelFor(count, [&](u32 i) { calls[i]++; });
+      for (u32 i = 0; i < count; i++)
+        EXPECT_EQ(1, calls[i].load()) << "index " << i << " of " << count;
+    }
+  }
+}
+
+TEST(WorkerPool, Reset)
+{
+  Common::WorkerPool pool(2, "WorkerPoolTest");
+  std::atomic<u32> sum{0};
+  for (u32 num_workers : {3, 0, 2})
+  {
+    pool.Reset(num_workers, "WorkerPoolTest");
+    EXPECT_EQ(num_workers, pool.GetWorkerCount());
+    pool.ParallelFor(100, [&](u32 i) { sum += i; });
+  }
+  EXPECT_EQ(3u * 4950u, sum.load());
+}
@@ -0,0 +1,250 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Core/FifoPlayer/FifoDataFile.h"
+
+class FifoDataFileTest : public testing::Test
+{
+protected:
+  FifoDataFileTest() : m_temp_dir{File::CreateTempDir()} {}
+  ~FifoDataFileTest() override { File::DeleteDirRecursively(m_temp_dir); }
+
+  std::string GetPath() const { return m_temp_dir + "/test.dff"; }
+
+private:
+  std::string m_temp_dir;
+};
+
+static FifoFrameInfo MakeFrame(u32 index)
+{
+  FifoFrameInfo frame;
+  frame.fifoStart = 0x1000 * index;
+  frame.fifoEnd = frame.fifoStart + 0x100;
+  for (u32 i = 0; i < 0x100 + index; i++)
+    frame.fifoData.push_back(static_cast<u8>(i * 7 + index));
+
+  // Every frame updates the same texture, and some vertex data of its own.
+  MemoryUpdate texture;
+  texture.fifoPosition = 0x10;
+  texture.address = 0x80100000;
+  texture.data.assign(64 * 1024, 0x5A);
+  texture.type = MemoryUpdate::TEXTURE_MAP;
+  frame.memoryUpdates.push_back(texture);
+
+  MemoryUpdate vertices;
+  vertices.fifoPosition = 0x20;
+  vertices.address = 0x80200000 + index * 0x100;
+  vertices.data.assign(0x100, static_cast<u8>(index));
+  vertices.type = MemoryUpdate::VERTEX_STREAM;
+  frame.memoryUpdates.push_back(vertices);
+
+  MemoryUpdate empty;
+  empty.fifoPosition = 0x30;
+  empty.address = 0x80300000;
+  empty.type = MemoryUpdate::XF_DATA;
+  frame.memoryUpdates.push_back(empty);
+
+  return frame;
+}
+
+static void ExpectSameFrames(const FifoDataFile& expected_file, const FifoDataFile& file)
+{
+  ASSERT_EQ(expected_file.GetFrameCount(), file.GetFrameCount());
+  for (u32 i = 0; i < file.GetFrameCount(); i++)
+  {
+    const std::shared_ptr<const FifoFrameInfo> expected = expected_file.GetFrame(i);
+    const std::shared_ptr<const FifoFrameInfo> frame = file.GetFrame(i);
+    EXPECT_EQ(expected->fifoStart, frame->fifoStart);
+    EXPECT_EQ(expected->fifoEnd, frame->fifoEnd);
+    EXPECT_EQ(expected->fifoData, frame->fifoData);
+    ASSERT_EQ(expected->memoryUpdates.size(), frame->memoryUpdates.size());
+    for (size_t j = 0; j < frame->memoryUpdates.size(); j++)
+    {
+      EXPECT_EQ(expected->memoryUpdates[j].fifoPosition, frame->memoryUpdates[j].fifoPosition);
+      EXPECT_EQ(expected->memoryUpdates[j].address, frame->memoryUpdates[j].address);
+      EXPECT_EQ(expected->memoryUpdates[j].type, frame->memoryUpdates[j].type);
+      EXPECT_EQ(expected->memoryUpdates[j].data, frame->memoryUpdates[j].data);
+    }
+  }
+}
+
+#pragma pack(push, 1)
+
+// The uncompressed layout of versions 1 to 4.
+struct LegacyFileHeader
+{
+  u32 fileId;
+  u32 file_version;
+  u32 min_loader_version;
+  u64 bpMemOffset;
+  u32 bpMemSize;
+  u64 cpMemOffset;
+  u32 cpMemSize;
+  u64 xfMemOffset;
+  u32 xfMemSize;
+  u64 xfRegsOffset;
+  u32 xfRegsSize;
+  u64 frameListOffset;
+  u32 frameCount;
+  u32 flags;
+  u64 texMemOffset;
+  u32 texMemSize;
+  u8 reserved[40];
+};
+static_assert(sizeof(LegacyFileHeader) == 128);
+
+struct LegacyFileFrameInfo
+{
+  u64 fifoDataOffset;
+  u32 fifoDataSize;
+  u32 fifoStart;
+  u32 fifoEnd;
+  u64 memoryUpdatesOffset;
+  u32 numMemoryUpdates;
+  u8 reserved[32];
+};
+static_assert(sizeof(LegacyFileFrameInfo) == 64);
+
+struct LegacyFileMemoryUpdate
+{
+  u32 fifoPosition;
+  u32 address;
+  u64 dataOffset;
+  u32 dataSize;
+  u8 type;
+  u8 reserved[3];
+};
+static_assert(sizeof(LegacyFileMemoryUpdate) == 24);
+
+#pragma pack(pop)
+
+template <typename T>
+static u64 Append(std::vector<u8>& data, const T* values, size_t count)
+{
+  const u64 offset = data.size();
+  const u8* bytes = reinterpret_cast<const u8*>(values);
+  data.insert(data.end(), bytes, bytes + count * sizeof(T));
+  return offset;
+}
+
+// Writes a file like the versions of Dolphin which saved the given version did.
+static bool SaveLegacy(FifoDataFile& file, u32 version, const std::string& path)
+{
+  std::vector<u8> data(sizeof(LegacyFileHeader) +
+                       file.GetFrameCount() * sizeof(LegacyFileFrameInfo));
+
+  LegacyFileHeader header = {};
+  header.fileId = 0x0d01f1f0;
+  header.file_version = version;
+  header.min_loader_version = 1;
+  header.bpMemOffset = Append(data, file.GetBPMem(), FifoDataFile::BP_MEM_SIZE);
+  header.bpMemSize = FifoDataFile::BP_MEM_SIZE;
+  header.cpMemOffset = Append(data, file.GetCPMem(), FifoDataFile::CP_MEM_SIZE);
+  header.cpMemSize = FifoDataFile::CP_MEM_SIZE;
+  header.xfMemOffset = Append(data, file.GetXFMem(), FifoDataFile::XF_MEM_SIZE);
+  header.xfMemSize = FifoDataFile::XF_MEM_SIZE;
+  header.xfRegsOffset = Append(data, file.GetXFRegs(), FifoDataFile::XF_REGS_SIZE);
+  header.xfRegsSize = FifoDataFile::XF_REGS_SIZE;
+  if (version >= 4)
+  {
+    header.texMemOffset = Append(data, file.GetTexMem(), FifoDataFile::TEX_MEM_SIZE);
+    header.texMemSize = FifoDataFile::TEX_MEM_SIZE;
+  }
+  header.frameListOffset = sizeof(LegacyFileHeader);
+  header.frameCount = file.GetFrameCount();
+  header.flags = file.GetIsWii() ? 1 : 0;
+  std::memcpy(data.data(), &header, sizeof(header));
+
+  for (u32 i = 0; i < file.GetFrameCount(); i++)
+  {
+    const std::shared_ptr<const FifoFrameInfo> frame = file.GetFrame(i);
+
+    std::vector<LegacyFileMemoryUpdate> updates;
+    for (const MemoryUpdate& update : frame->memoryUpdates)
+    {
+      LegacyFileMemoryUpdate file_update = {};
+      file_update.fifoPosition = update.fifoPosition;
+      file_update.address = update.address;
+      file_update.dataOffset = Append(data, update.data.data(), update.data.size());
+      file_update.dataSize = static_cast<u32>(update.data.size());
+      file_update.type = static_cast<u8>(update.type);
+      updates.push_back(file_update);
+    }
+
+    LegacyFileFrameInfo frame_info = {};
+    frame_info.fifoDataOffset = Append(data, frame->fifoData.data(), frame->fifoData.size());
+    frame_info.fifoDataSize = static_cast<u32>(frame->fifoData.size());
+    frame_info.fifoStart = frame->fifoStart;
+    frame_info.fifoEnd = frame->fifoEnd;
+    frame_info.memoryUpdatesOffset = Append(data, updates.data(), updates.size());
+    frame_info.numMemoryUpdates = static_cast<u32>(updates.size());
+    std::memcpy(&data[header.frameListOffset + i * sizeof(LegacyFileFrameInfo)], &frame_info,
+                sizeof(frame_info));
+  }
+
+  File::IOFile out(path, "wb");
+  return out.WriteBytes(data.data(), data.size());
+}
+
+TEST_F(FifoDataFileTest, SaveAndLoad)
+{
+  // More frames than are kept in memory at once.
+  constexpr u32 NUM_FRAMES = 40;
+
+  FifoDataFile file;
+  file.SetIsWii(true);
+  file.GetBPMem()[0x10] = 0x12345678;
+  file.GetTexMem()[0x1234] = 0x56;
+  for (u32 i = 0; i < NUM_FRAMES; i++)
+    file.AddFrame(MakeFrame(i));
+  ASSERT_TRUE(file.Save(GetPath()));
+
+  // The shared texture is only written once.
+  EXPECT_LT(File::GetSize(GetPath()), 2u * 1024 * 1024);
+
+  const std::unique_ptr<FifoDataFile> loaded = FifoDataFile::Load(GetPath(), false);
+  ASSERT_TRUE(loaded);
+  EXPECT_TRUE(loaded->GetIsWii());
+  EXPECT_EQ(0x12345678u, loaded->GetBPMem()[0x10]);
+  EXPECT_EQ(0x56u, loaded->GetTexMem()[0x1234]);
+  ASSERT_EQ(NUM_FRAMES, loaded->GetFrameCount());
+
+  // Go through the frames twice, so that evicted frames are read again.
+  for (u32 pass = 0; pass < 2; pass++)
+    ExpectSameFrames(file, *loaded);
+}
+
+TEST_F(FifoDataFileTest, LoadUncompressedVersions)
+{
+  FifoDataFile file;
+  file.SetIsWii(true);
+  file.GetBPMem()[0x10] = 0x12345678;
+  file.GetTexMem()[0x1234] = 0x56;
+  for (u32 i = 0; i < 20; i++)
+    file.AddFrame(MakeFrame(i));
+
+  for (u32 version = 1; version <= 4; version++)
+  {
+    ASSERT_TRUE(SaveLegacy(file, version, GetPath()));
+
+    const std::unique_ptr<FifoDataFile> loaded = FifoDataFile::Load(GetPath(), false);
+    ASSERT_TRUE(loaded);
+    EXPECT_TRUE(loaded->GetIsWii());
+    EXPECT_EQ(version < 2, loaded->HasBrokenEFBCopies());
+    EXPECT_EQ(0x12345678u, loaded->GetBPMem()[0x10]);
+    // Texture memory was only saved since version 4.
+    EXPECT_EQ(version >= 4 ? 0x56u : 0u, loaded->GetTexMem()[0x1234]);
+    ExpectSameFrames(file, *loaded);
+  }
+}
@@ -0,0 +1,352 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HLE/HLE_Native.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// Cache lines holding a block each, which the DC*Range functions are pointed at.
+constexpr u32 LINES_ADDRESS = 0x00003000;
+constexpr u32 NUM_LINES = 8;
+constexpr u32 FUNCTION_ADDRESS = 0x00004000;
+constexpr u32 RETURN_ADDRESS = 0x00005000;
+
+constexpr u32 INSTRUCTION_B_SELF = 0x48000000;
+constexpr u32 INSTRUCTION_SC = 0x44000002;
+constexpr u32 INSTRUCTION_BLR = 0x4e800020;
+
+// DCFlushRange as the SDK has it, with the system call which ends it at SC_ADDRESS.
+const std::vector<u32> s_dc_flush_range = {
+    0x28040000,  // cmplwi r4, 0
+    0x4c810020,  // blelr
+    0x546506ff,  // clrlwi. r5, r3, 27
+    0x41820008,  // beq +8
+    0x38840020,  // addi r4, r4, 0x20
+    0x3884001f,  // addi r4, r4, 0x1f
+    0x5484d97e,  // srwi r4, r4, 5
+    0x7c8903a6,  // mtctr r4
+    0x7c0018ac,  // dcbf 0, r3
+    0x38630020,  // addi r3, r3, 0x20
+    0x4200fff8,  // bdnz -8
+    INSTRUCTION_SC,
+    INSTRUCTION_BLR,
+};
+constexpr u32 SC_ADDRESS = FUNCTION_ADDRESS + 11 * 4;
+
+// Data BATs mapping:
+// - 0x80000000 to the start of physical memory, for 256MB of which MEM1 only fills the first 24MB.
+// - 0xA0000000 and the 128KB page after it to MEM1 pages which aren't contiguous.
+// - 0xC0000000 to MMIO, for 128KB.
+constexpr std::array<u32, 8> DBATS = {
+    0x80001fff, 0x00000002, 0xa0000003, 0x00200002,
+    0xa0020003, 0x00100002, 0xc0000003, 0x0c000002,
+};
+
+u64 GetHits(const char* name)
+{
+  for (const Profiler::HLEFunctionStat& stat : HLE_Native::GetStats())
+  {
+    if (std::strcmp(stat.name, name) == 0)
+      return stat.hits;
+  }
+  return 0;
+}
+
+u64 GetMisses(const char* name)
+{
+  for (const Profiler::HLEFunctionStat& stat : HLE_Native::GetStats())
+  {
+    if (std::strcmp(stat.name, name) == 0)
+      return stat.misses;
+  }
+  return 0;
+}
+}  // namespace
+
+class HLENativeTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    PowerPC::Init(PowerPC::CPUCore::Interpreter);
+    CoreTiming::Init();
+    for (ExpansionInterface::TEXIDevices& device : SConfig::GetInstance().m_EXIDevice)
+      device = ExpansionInterface::EXIDEVICE_NONE;
+    ExpansionInterface::Init();  // Needs to be initialized before Memory
+    Memory::Init();
+
+    m_jit.Init();
+    JitInterface::SetJit(&m_jit);
+
+    for (u32 i = 0; i < DBATS.size(); i++)
+      PowerPC::ppcState.spr[SPR_DBAT0U + i] = DBATS[i];
+    PowerPC::DBATUpdated();
+    MSR.DR = 1;
+
+    HLE_Native::ResetStats();
+  }
+
+  void TearDown() override
+  {
+    JitInterface::SetJit(nullptr);
+    m_jit.Shutdown();
+    Memory::Shutdown();
+    ExpansionInterface::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  static void WriteCode(u32 address, const std::vector<u32>& code)
+  {
+    for (u32 inst : code)
+    {
+      Memory::Write_U32(inst, address);
+      address += 4;
+    }
+  }
+
+  // Sets up a call of the function at FUNCTION_ADDRESS, the way HLE::Execute does.
+  static void Call(u32 r3, u32 r4, u32 r5 = 0)
+  {
+    GPR(3) = r3;
+    GPR(4) = r4;
+    GPR(5) = r5;
+    LR = RETURN_ADDRESS;
+    PC = NPC = FUNCTION_ADDRESS;
+  }
+
+  // Compiles a block at the start of every cache line from LINES_ADDRESS.
+  void CompileLines()
+  {
+    m_jit.ClearCache();
+    for (u32 i = 0; i < NUM_LINES; i++)
+    {
+      PC = LINES_ADDRESS + i * 32;
+      Memory::Write_U32(INSTRUCTION_B_SELF, PC);
+      m_jit.Jit(PC);
+    }
+  }
+
+  // Returns which of the blocks from CompileLines are still there.
+  std::vector<bool> GetCompiledLines()
+  {
+    std::vector<bool> lines;
+    for (u32 i = 0; i < NUM_LINES; i++)
+    {
+      lines.push_back(m_jit.GetBlockCache()->GetBlockFromStartAddress(LINES_ADDRESS + i * 32,
+                                                                      MSR.Hex) != nullptr);
+    }
+    return lines;
+  }
+
+  std::string m_profile_path;
+  CachedInterpreter m_jit;
+};
+
+TEST_F(HLENativeTest, BATPagePointer)
+{
+  EXPECT_EQ(Memory::m_pRAM + 0x1000, HLE_Native::GetBATPagePointer(0x80001000));
+  EXPECT_EQ(Memory::m_pRAM + 0x17ffffc, HLE_Native::GetBATPagePointer(0x817ffffc));
+  EXPECT_EQ(Memory::m_pRAM + 0x200010, HLE_Native::GetBATPagePointer(0xa0000010));
+  EXPECT_EQ(Memory::m_pRAM + 0x100000, HLE_Native::GetBATPagePointer(0xa0020000));
+
+  // Past the end of MEM1, MMIO, and addresses which no BAT maps.
+  EXPECT_EQ(nullptr, HLE_Native::GetBATPagePointer(0x81800000));
+  EXPECT_EQ(nullptr, HLE_Native::GetBATPagePointer(0xc0000000));
+  EXPECT_EQ(nullptr, HLE_Native::GetBATPagePointer(0xa0040000));
+  EXPECT_EQ(nullptr, HLE_Native::GetBATPagePointer(0x00001000));
+
+  // Without data translation, accesses don't go through the BATs.
+  MSR.DR = 0;
+  EXPECT_EQ(nullptr, HLE_Native::GetBATPagePointer(0x80001000));
+}
+
+TEST_F(HLENativeTest, RAMPointerCrossesPagesOnlyIfContiguous)
+{
+  EXPECT_EQ(Memory::m_pRAM, HLE_Native::GetRAMPointer(0x80000000, Memory::REALRAM_SIZE));
+  EXPECT_EQ(Memory::m_pRAM + 0x1fff0, HLE_Native::GetRAMPointer(0x8001fff0, 0x20));
+
+  // The page at 0xa0020000 doesn't follow the one before it in MEM1.
+  EXPECT_EQ(Memory::m_pRAM + 0x21fff0, HLE_Native::GetRAMPointer(0xa001fff0, 0x10));
+  EXPECT_EQ(nullptr, HLE_Native::GetRAMPointer(0xa001fff0, 0x11));
+  EXPECT_EQ(Memory::m_pRAM + 0x100000, HLE_Native::GetRAMPointer(0xa0020000, 0x20000));
+
+  // Ranges running into pages which aren't RAM, or wrapping around the address space.
+  EXPECT_EQ(nullptr, HLE_Native::GetRAMPointer(0xa0020000, 0x20001));
+  EXPECT_EQ(nullptr, HLE_Native::GetRAMPointer(0x817ffff0, 0x11));
+  EXPECT_EQ(nullptr, HLE_Native::GetRAMPointer(0x80000000, 0xffffffff));
+  EXPECT_EQ(nullptr, HLE_Native::GetRAMPointer(0xfffffff0, 0x20));
+}
+
+TEST_F(HLENativeTest, MemcpyRunsGuestCodeUnlessRangesAreRAM)
+{
+  std::vector<u8> source(0x100);
+  for (size_t i = 0; i < source.size(); i++)
+    source[i] = static_cast<u8>(i);
+  Memory::CopyToEmu(0x1000, source.data(), source.size());
+
+  Call(0x80002000, 0x80001000, 0x100);
+  HLE_Native::Memcpy();
+  EXPECT_EQ(RETURN_ADDRESS, NPC);
+  EXPECT_EQ(0, std::memcmp(source.data(), Memory::m_pRAM + 0x2000, source.size()));
+
+  // Nothing is accessed when there is nothing to copy.
+  Call(0xc0000000, 0x00000000, 0);
+  HLE_Native::Memcpy();
+  EXPECT_EQ(RETURN_ADDRESS, NPC);
+  EXPECT_EQ(2u, GetHits("memcpy"));
+
+  // Overlapping ranges, MMIO, pages which aren't contiguous, and unmapped pages.
+  for (const auto& [dst, src] : std::vector<std::pair<u32, u32>>{{0x80001080, 0x80001000},
+                                                                 {0x80000f80, 0x80001000},
+                                                                 {0xc0000000, 0x80001000},
+                                                                 {0x80001000, 0xa001ff80},
+                                                                 {0x80001000, 0xa003ff80}})
+  {
+    Memory::Write_U32(0x12345678, 0x1080);
+    Call(dst, src, 0x100);
+    HLE_Native::Memcpy();
+    EXPECT_EQ(FUNCTION_ADDRESS, NPC) << std::hex << dst << " " << src;
+    EXPECT_EQ(0x12345678u, Memory::Read_U32(0x1080));
+  }
+  EXPECT_EQ(5u, GetMisses("memcpy"));
+  EXPECT_EQ(2u, GetHits("memcpy"));
+}
+
+TEST_F(HLENativeTest, FillMemRunsGuestCodeUnlessRangeIsRAM)
+{
+  Call(0x80002001, 0x1a5, 0xff);
+  HLE_Native::FillMem();
+  EXPECT_EQ(RETURN_ADDRESS, NPC);
+  EXPECT_EQ(0u, Memory::Read_U8(0x2000));
+  EXPECT_EQ(0xa5u, Memory::Read_U8(0x2001));
+  EXPECT_EQ(0xa5u, Memory::Read_U8(0x20ff));
+  EXPECT_EQ(0u, Memory::Read_U8(0x2100));
+
+  Call(0xa001ff80, 0xa5, 0x100);
+  HLE_Native::FillMem();
+  EXPECT_EQ(FUNCTION_ADDRESS, NPC);
+  EXPECT_EQ(0u, Memory::Read_U8(0x21ff80));
+
+  EXPECT_EQ(1u, GetHits("__fill_mem"));
+  EXPECT_EQ(1u, GetMisses("__fill_mem"));
+}
+
+// Runs the guest DCFlushRange with the interpreter and the native one for ranges with either end
+// aligned or not, and checks that the same cache lines are invalidated.
+TEST_F(HLENativeTest, CacheRangeInvalidatesLinesLikeGuestCode)
+{
+  WriteCode(FUNCTION_ADDRESS, s_dc_flush_range);
+  for (const auto& [offset, size] : std::vector<std::pair<u32, u32>>{
+           {0, 1}, {0, 0x20}, {0, 0x21}, {0, 0x60}, {4, 0x1c}, {4, 0x20}, {0x10, 0x10}, {0x1f, 1}})
+  {
+    const u32 address = LINES_ADDRESS + 32 + offset;
+
+    CompileLines();
+    Call(address, size);
+    for (int i = 0; i < 100 && PC != SC_ADDRESS && PC != RETURN_ADDRESS; i++)
+      Interpreter::getInstance()->SingleStepInner();
+    EXPECT_EQ(SC_ADDRESS, PC);
+    const std::vector<bool> expected = GetCompiledLines();
+
+    CompileLines();
+    Call(address, size);
+    HLE_Native::DCFlushRange();
+    EXPECT_EQ(SC_ADDRESS, NPC);
+    EXPECT_EQ(expected, GetCompiledLines()) << std::hex << offset << " " << size;
+    EXPECT_TRUE(expected[0]);
+  }
+  EXPECT_EQ(8u, GetHits("DCFlushRange"));
+}
+
+TEST_F(HLENativeTest, CacheRangeContinuesAtSystemCall)
+{
+  // The scan for the system call stops at the end of the function.
+  std::vector<u32> code = s_dc_flush_range;
+  code.back() = INSTRUCTION_SC;
+  code[code.size() - 2] = INSTRUCTION_BLR;
+  WriteCode(FUNCTION_ADDRESS, code);
+  CompileLines();
+  Call(LINES_ADDRESS, 0x20);
+  HLE_Native::DCStoreRange();
+  EXPECT_EQ(RETURN_ADDRESS, NPC);
+  EXPECT_FALSE(GetCompiledLines()[0]);
+
+  WriteCode(FUNCTION_ADDRESS, s_dc_flush_range);
+  Call(LINES_ADDRESS, 0x20);
+  HLE_Native::DCStoreRange();
+  EXPECT_EQ(SC_ADDRESS, NPC);
+
+  // With nothing to do, the guest code returns before the system call.
+  Call(LINES_ADDRESS, 0);
+  HLE_Native::DCStoreRange();
+  EXPECT_EQ(RETURN_ADDRESS, NPC);
+
+  EXPECT_EQ(3u, GetHits("DCStoreRange"));
+}
+
+TEST_F(HLENativeTest, CacheRangeRunsGuestCodeWhenItWouldLoopForever)
+{
+  // The line count wraps around to 0, which the guest code's bdnz loop takes as 2^32 lines.
+  WriteCode(FUNCTION_ADDRESS, s_dc_flush_range);
+  CompileLines();
+  Call(LINES_ADDRESS, 0xffffffe1);
+  HLE_Native::DCFlushRange();
+  EXPECT_EQ(FUNCTION_ADDRESS, NPC);
+  EXPECT_TRUE(GetCompiledLines()[0]);
+  EXPECT_EQ(1u, GetMisses("DCFlushRange"));
+}
+
+TEST_F(HLENativeTest, DCInvalidateRangeRunsGuestCodeInUserMode)
+{
+  WriteCode(FUNCTION_ADDRESS, s_dc_flush_range);
+  CompileLines();
+
+  // dcbi raises a program exception in user mode.
+  MSR.PR = 1;
+  Call(LINES_ADDRESS, 0x20);
+  HLE_Native::DCInvalidateRange();
+  EXPECT_EQ(FUNCTION_ADDRESS, NPC);
+  EXPECT_TRUE(GetCompiledLines()[0]);
+  EXPECT_EQ(1u, GetMisses("DCInvalidateRange"));
+
+  MSR.PR = 0;
+  CompileLines();
+  Call(LINES_ADDRESS, 0x20);
+  HLE_Native::DCInvalidateRange();
+  EXPECT_EQ(SC_ADDRESS, NPC);
+  EXPECT_FALSE(GetCompiledLines()[0]);
+  EXPECT_TRUE(GetCompiledLines()[1]);
+  EXPECT_EQ(1u, GetHits("DCInvalidateRange"));
+}
@@ -0,0 +1,236 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr u32 CODE_ADDRESS = 0x00003000;
+constexpr u32 DATA_ADDRESS = 0x00000100;
+constexpr u32 DATA_SIZE = 0x100;
+constexpr u32 FPU_UNAVAILABLE_VECTOR = 0x00000800;
+
+// A single block made only of pairs which are run by fused callbacks, ending with a conditional
+// branch to either END_TAKEN or END_NOT_TAKEN.
+const std::vector<u32> s_fused_code = {
+    0x38600100,  // li r3, 0x100
+    0x80830000,  // lwz r4, 0(r3)
+    0x5485103a,  // rlwinm r5, r4, 2, 0, 29
+    0x54a6c23e,  // rlwinm r6, r5, 24, 8, 31
+    0x54c7063f,  // rlwinm. r7, r6, 0, 24, 31
+    0x28870040,  // cmplwi cr1, r7, 0x40
+    0x3d000001,  // lis r8, 1
+    0x3908fffc,  // addi r8, r8, -4
+    0x39230010,  // addi r9, r3, 0x10
+    0x90890000,  // stw r4, 0(r9)
+    0x90a30014,  // stw r5, 0x14(r3)
+    0x90c30018,  // stw r6, 0x18(r3)
+    0xc0230020,  // lfs f1, 0x20(r3)
+    0xc0430024,  // lfs f2, 0x24(r3)
+    0xd0230028,  // stfs f1, 0x28(r3)
+    0xd043002c,  // stfs f2, 0x2c(r3)
+    0xc8630030,  // lfd f3, 0x30(r3)
+    0xc8830038,  // lfd f4, 0x38(r3)
+    0xd8630040,  // stfd f3, 0x40(r3)
+    0xd8830048,  // stfd f4, 0x48(r3)
+    0x3d400000,  // lis r10, 0
+    0x816a0104,  // lwz r11, 0x104(r10)
+    0x7c045840,  // cmplw r4, r11
+    0x41820008,  // beq +8
+    0x39800001,  // li r12, 1
+    0x48000000,  // b 0
+};
+constexpr u32 END_NOT_TAKEN = CODE_ADDRESS + 24 * 4;
+constexpr u32 END_TAKEN = CODE_ADDRESS + 25 * 4;
+
+struct CPUState
+{
+  std::array<u32, 32> gpr;
+  std::array<u64, 64> ps;
+  std::array<u64, 8> cr;
+  std::array<u8, DATA_SIZE> data;
+  u32 pc;
+  u32 msr;
+  u32 xer;
+  u32 fpscr;
+  u32 srr0;
+  u32 exceptions;
+  int cycles;
+
+  bool operator==(const CPUState& other) const
+  {
+    return gpr == other.gpr && ps == other.ps && cr == other.cr && data == other.data &&
+           pc == other.pc && msr == other.msr && xer == other.xer && fpscr == other.fpscr &&
+           srr0 == other.srr0 && exceptions == other.exceptions && cycles == other.cycles;
+  }
+};
+
+CPUState GetCPUState(int cycles)
+{
+  CPUState state;
+  for (size_t i = 0; i < state.gpr.size(); i++)
+    state.gpr[i] = PowerPC::ppcState.gpr[i];
+  for (size_t i = 0; i < 32; i++)
+  {
+    state.ps[i * 2] = PowerPC::ppcState.ps[i].PS0AsU64();
+    state.ps[i * 2 + 1] = PowerPC::ppcState.ps[i].PS1AsU64();
+  }
+  for (size_t i = 0; i < state.cr.size(); i++)
+    state.cr[i] = PowerPC::ppcState.cr.fields[i];
+  Memory::CopyFromEmu(state.data.data(), DATA_ADDRESS, DATA_SIZE);
+  state.pc = PC;
+  state.msr = MSR.Hex;
+  state.xer = PowerPC::GetXER().Hex;
+  state.fpscr = FPSCR.Hex;
+  state.srr0 = SRR0;
+  state.exceptions = PowerPC::ppcState.Exceptions;
+  state.cycles = cycles;
+  return state;
+}
+}  // namespace
+
+class CachedInterpreterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    PowerPC::Init(PowerPC::CPUCore::Interpreter);
+    CoreTiming::Init();
+    for (ExpansionInterface::TEXIDevices& device : SConfig::GetInstance().m_EXIDevice)
+      device = ExpansionInterface::EXIDEVICE_NONE;
+    ExpansionInterface::Init();  // Needs to be initialized before Memory
+    Memory::Init();
+
+    m_jit.Init();
+
+    for (u32 i = 0; i < DATA_SIZE; i += 4)
+      Memory::Write_U32(0x3fc00000 + i * 0x1111, DATA_ADDRESS + i);
+  }
+
+  void TearDown() override
+  {
+    m_jit.Shutdown();
+    Memory::Shutdown();
+    ExpansionInterface::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  static void WriteCode(u32 address, const std::vector<u32>& code)
+  {
+    for (u32 inst : code)
+    {
+      Memory::Write_U32(inst, address);
+      address += 4;
+    }
+  }
+
+  // Runs blocks until PC reaches end_pc, and returns the state with the cycles taken off the
+  // downcount.
+  CPUState RunCachedInterpreter(u32 end_pc)
+  {
+    int cycles = 0;
+    for (int i = 0; i < 100 && PC != end_pc; i++)
+    {
+      if (!m_jit.GetBlockCache()->GetBlockFromStartAddress(PC, MSR.Hex))
+        m_jit.Jit(PC);
+      m_jit.SingleStep();
+      cycles += CoreTiming::g.slice_length - PowerPC::ppcState.downcount;
+    }
+    EXPECT_EQ(end_pc, PC);
+    return GetCPUState(cycles);
+  }
+
+  // Same as above, one instruction at a time.
+  static CPUState RunInterpreter(u32 end_pc)
+  {
+    int cycles = 0;
+    for (int i = 0; i < 1000 && PC != end_pc; i++)
+      cycles += Interpreter::getInstance()->SingleStepInner();
+    EXPECT_EQ(end_pc, PC);
+    return GetCPUState(cycles);
+  }
+
+  // Checks that running the code through fused callbacks gives the same registers, memory, PC and
+  // downcount as running every instruction on its own.
+  void ExpectSameExecution(u32 end_pc)
+  {
+    const PowerPC::PowerPCState initial_state = PowerPC::ppcState;
+    const std::vector<u8> initial_memory(Memory::m_pRAM, Memory::m_pRAM + Memory::REALRAM_SIZE);
+
+    const CPUState expected = RunInterpreter(end_pc);
+
+    PowerPC::ppcState = initial_state;
+    std::copy(initial_memory.begin(), initial_memory.end(), Memory::m_pRAM);
+    EXPECT_TRUE(expected == RunCachedInterpreter(end_pc));
+  }
+
+  std::string m_profile_path;
+  CachedInterpreter m_jit;
+};
+
+TEST_F(CachedInterpreterTest, FusedPairsMatchInterpreter)
+{
+  WriteCode(CODE_ADDRESS, s_fused_code);
+  MSR.FP = 1;
+  PC = CODE_ADDRESS;
+  ExpectSameExecution(END_NOT_TAKEN);
+
+  // With both words equal, the fused cmplw/beq pair takes the branch.
+  Memory::Write_U32(Memory::Read_U32(DATA_ADDRESS), DATA_ADDRESS + 4);
+  PC = CODE_ADDRESS;
+  ExpectSameExecution(END_TAKEN);
+  EXPECT_EQ(0x3fc00000u, GPR(11));
+}
+
+TEST_F(CachedInterpreterTest, FusedPairRaisesFPUnavailable)
+{
+  // The FPU check is in front of the lfs pair, and the exception is raised at its first load with
+  // the cycles up to that load.
+  WriteCode(CODE_ADDRESS, s_fused_code);
+  MSR.FP = 0;
+  PC = CODE_ADDRESS;
+  ExpectSameExecution(FPU_UNAVAILABLE_VECTOR);
+  EXPECT_EQ(CODE_ADDRESS + 12 * 4, SRR0);
+}
+
+TEST_F(CachedInterpreterTest, FusedBranchLoops)
+{
+  WriteCode(CODE_ADDRESS, {
+                              0x38600000,  // li r3, 0
+                              0x38630001,  // addi r3, r3, 1
+                              0x2c03000a,  // cmpwi r3, 10
+                              0x4082fff8,  // bne -8
+                              0x48000000,  // b 0
+                          });
+  PC = CODE_ADDRESS;
+  ExpectSameExecution(CODE_ADDRESS + 16);
+  EXPECT_EQ(10u, GPR(3));
+}
@@ -0,0 +1,223 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+constexpr u32 CODE_ADDRESS = 0x00003000;
+constexpr u32 DATA_ADDRESS = 0x00000100;
+
+// Integer, load/store, floating point and branch instructions, with and without updating CR.
+const std::vector<u32> s_code = {
+    0x38600005,  // li r3, 5
+    0x38830007,  // addi r4, r3, 7
+    0x7ca321d6,  // mullw r5, r3, r4
+    0x7cc51851,  // subf. r6, r5, r3
+    0x30e6ffff,  // addic r7, r6, -1
+    0x7d073914,  // adde r8, r7, r7
+    0x54a92036,  // rlwinm r9, r5, 4, 0, 27
+    0x90a00100,  // stw r5, 0x100(0)
+    0x81400100,  // lwz r10, 0x100(0)
+    0xc8200108,  // lfd f1, 0x108(0)
+    0xfc41082a,  // fadd f2, f1, f1
+    0xfc620072,  // fmul f3, f2, f1
+    0x7c895000,  // cmpw cr1, r9, r10
+    0x7d600026,  // mfcr r11
+    0x48000008,  // b +8
+    0x38600063,  // li r3, 99
+    0x48000009,  // bl +8
+    0x60000000,  // nop
+    0x48000000,  // b 0
+};
+
+struct CPUState
+{
+  std::array<u32, 32> gpr;
+  std::array<u64, 64> ps;
+  std::array<u64, 8> cr;
+  u32 pc;
+  u32 msr;
+  u32 xer;
+  u32 fpscr;
+  u32 lr;
+  u32 srr0;
+  u32 exceptions;
+  int cycles;
+
+  bool operator==(const CPUState& other) const
+  {
+    return gpr == other.gpr && ps == other.ps && cr == other.cr && pc == other.pc &&
+           msr == other.msr && xer == other.xer && fpscr == other.fpscr && lr == other.lr &&
+           srr0 == other.srr0 && exceptions == other.exceptions && cycles == other.cycles;
+  }
+};
+
+CPUState GetCPUState(int cycles)
+{
+  CPUState state;
+  for (size_t i = 0; i < state.gpr.size(); i++)
+    state.gpr[i] = PowerPC::ppcState.gpr[i];
+  for (size_t i = 0; i < 32; i++)
+  {
+    state.ps[i * 2] = PowerPC::ppcState.ps[i].PS0AsU64();
+    state.ps[i * 2 + 1] = PowerPC::ppcState.ps[i].PS1AsU64();
+  }
+  for (size_t i = 0; i < state.cr.size(); i++)
+    state.cr[i] = PowerPC::ppcState.cr.fields[i];
+  state.pc = PC;
+  state.msr = MSR.Hex;
+  state.xer = PowerPC::GetXER().Hex;
+  state.fpscr = FPSCR.Hex;
+  state.lr = LR;
+  state.srr0 = SRR0;
+  state.exceptions = PowerPC::ppcState.Exceptions;
+  state.cycles = cycles;
+  return state;
+}
+}  // namespace
+
+class InterpreterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    PowerPC::Init(PowerPC::CPUCore::Interpreter);
+    CoreTiming::Init();
+    for (ExpansionInterface::TEXIDevices& device : SConfig::GetInstance().m_EXIDevice)
+      device = ExpansionInterface::EXIDEVICE_NONE;
+    ExpansionInterface::Init();  // Needs to be initialized before Memory
+    Memory::Init();
+
+    // Instructions are only predecoded while the instruction cache is enabled.
+    HID0.ICE = 1;
+    PowerPC::ppcState.iCache.Reset();
+  }
+
+  void TearDown() override
+  {
+    Memory::Shutdown();
+    ExpansionInterface::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  static void WriteCode(u32 address, const std::vector<u32>& code)
+  {
+    for (u32 inst : code)
+    {
+      Memory::Write_U32(inst, address);
+      address += 4;
+    }
+  }
+
+  // Runs the code from the start with both ways of stepping, and compares the state after every
+  // instruction.
+  static void ExpectSameExecution(size_t steps)
+  {
+    const PowerPC::PowerPCState initial_state = PowerPC::ppcState;
+    const std::vector<u8> initial_memory(Memory::m_pRAM, Memory::m_pRAM + Memory::REALRAM_SIZE);
+    Interpreter* const interpreter = Interpreter::getInstance();
+
+    std::vector<CPUState> expected;
+    int cycles = 0;
+    for (size_t i = 0; i < steps; i++)
+    {
+      cycles += interpreter->SingleStepInner();
+      expected.push_back(GetCPUState(cycles));
+    }
+
+    // Runs twice, once decoding the instructions and once from the predecoded cache.
+    for (int pass = 0; pass < 2; pass++)
+    {
+      PowerPC::ppcState = initial_state;
+      std::copy(initial_memory.begin(), initial_memory.end(), Memory::m_pRAM);
+      cycles = 0;
+      for (size_t i = 0; i < steps; i++)
+      {
+        cycles += interpreter->SingleStepPredecoded();
+        EXPECT_TRUE(expected[i] == GetCPUState(cycles)) << "pass " << pass << ", step " << i;
+      }
+    }
+  }
+
+  std::string m_profile_path;
+};
+
+TEST_F(InterpreterTest, PredecodedMatchesSingleStep)
+{
+  WriteCode(CODE_ADDRESS, s_code);
+  Memory::Write_U64(0x3ff8000000000000, DATA_ADDRESS + 8);  // 1.5
+  MSR.FP = 1;
+  PC = CODE_ADDRESS;
+
+  ExpectSameExecution(s_code.size() + 2);
+  EXPECT_EQ(CODE_ADDRESS + (s_code.size() - 1) * 4, PC);
+}
+
+TEST_F(InterpreterTest, PredecodedRaisesFPUnavailable)
+{
+  WriteCode(CODE_ADDRESS, s_code);
+  MSR.FP = 0;
+  PC = CODE_ADDRESS;
+
+  ExpectSameExecution(12);
+  EXPECT_EQ(CODE_ADDRESS + 9 * 4, SRR0);
+}
+
+TEST_F(InterpreterTest, PredecodedInstructionsAreInvalidated)
+{
+  Interpreter* const interpreter = Interpreter::getInstance();
+  WriteCode(CODE_ADDRESS, {0x38600001, 0x4bfffffc});  // li r3, 1; b -4
+  PC = CODE_ADDRESS;
+  interpreter->SingleStepPredecoded();
+  interpreter->SingleStepPredecoded();
+  EXPECT_EQ(1u, GPR(3));
+
+  // Like on hardware, modified code only runs after the instruction cache was told about it.
+  Memory::Write_U32(0x38600002, CODE_ADDRESS);  // li r3, 2
+  interpreter->SingleStepPredecoded();
+  interpreter->SingleStepPredecoded();
+  EXPECT_EQ(1u, GPR(3));
+
+  PowerPC::ppcState.iCache.Invalidate(CODE_ADDRESS);  // icbi
+  interpreter->SingleStepPredecoded();
+  interpreter->SingleStepPredecoded();
+  EXPECT_EQ(2u, GPR(3));
+
+  Memory::Write_U32(0x38600003, CODE_ADDRESS);  // li r3, 3
+  interpreter->SingleStepPredecoded();
+  interpreter->SingleStepPredecoded();
+  EXPECT_EQ(2u, GPR(3));
+
+  PowerPC::ppcState.iCache.Reset();
+  interpreter->SingleStepPredecoded();
+  interpreter->SingleStepPredecoded();
+  EXPECT_EQ(3u, GPR(3));
+}
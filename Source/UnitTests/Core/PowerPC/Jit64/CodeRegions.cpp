@@ -0,0 +1,222 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MachineContext.h"
+#include "Core/PowerPC/Jit64/Jit.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// SwitchToCodeRegion() keeps 0x10000 bytes free in each region, so only a few dozen blocks fit into
+// the rest of these.
+constexpr size_t TINY_REGION_SIZE = 0x11000;
+
+constexpr u32 FIRST_BLOCK = 0x00010000;
+constexpr u32 BLOCK_SIZE = 8;
+constexpr u32 NUM_BLOCKS = 0x1000;
+
+class TestJit64 final : public Jit64
+{
+public:
+  void UseTinyCodeRegions() { ResetCodeRegions(TINY_REGION_SIZE, TINY_REGION_SIZE); }
+
+  u32 GetLastCodeRegion() const { return m_code_region; }
+
+  // Back patch info for code past the end of what is left of a region, which belonged to blocks
+  // that were evicted.
+  size_t CountStaleBackPatchInfo() const
+  {
+    size_t count = 0;
+    for (const auto& info : m_back_patch_info)
+    {
+      for (const CodeRegion& region : m_code_regions)
+      {
+        if (info.first >= region.ptr && info.first < region.end)
+          count++;
+      }
+    }
+    return count;
+  }
+
+  // The fastmem load of a block, which faults when it accesses MMIO.
+  u8* FindLoad(const JitBlock& block) const
+  {
+    for (const auto& info : m_back_patch_info)
+    {
+      if (info.first >= block.checkedEntry && info.first < block.checkedEntry + block.codeSize)
+        return info.first;
+    }
+    return nullptr;
+  }
+};
+}  // namespace
+
+class Jit64CodeRegionsTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    SConfig::GetInstance().bFastmem = true;
+    PowerPC::Init(PowerPC::CPUCore::Interpreter);
+    CoreTiming::Init();
+    for (ExpansionInterface::TEXIDevices& device : SConfig::GetInstance().m_EXIDevice)
+      device = ExpansionInterface::EXIDEVICE_NONE;
+    ExpansionInterface::Init();  // Needs to be initialized before Memory
+    Memory::Init();
+
+    // Every block loads a word through fastmem and returns.
+    for (u32 i = 0; i < NUM_BLOCKS; i++)
+    {
+      Memory::Write_U32(0x80830000, FIRST_BLOCK + i * BLOCK_SIZE);  // lwz r4, 0(r3)
+      Memory::Write_U32(0x4E800020, FIRST_BLOCK + i * BLOCK_SIZE + 4);  // blr
+    }
+
+    m_jit.Init();
+    ASSERT_TRUE(m_jit.jo.fastmem) << "Fastmem is needed for back patching";
+    m_jit.UseTinyCodeRegions();
+  }
+
+  void TearDown() override
+  {
+    m_jit.Shutdown();
+    Memory::Shutdown();
+    ExpansionInterface::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  JitBlock* GetBlock(u32 address)
+  {
+    return m_jit.GetBlockCache()->GetBlockFromStartAddress(address, MSR.Hex);
+  }
+
+  // Compiles the block at the address, and returns the code region it went into.
+  u32 Compile(u32 address)
+  {
+    m_jit.Jit(address);
+    const JitBlock* block = GetBlock(address);
+    EXPECT_NE(nullptr, block);
+    EXPECT_EQ(0u, m_jit.CountStaleBackPatchInfo());
+    return block ? block->code_region : m_jit.GetLastCodeRegion();
+  }
+
+  // Compiles new blocks until one goes into the given region after others went elsewhere, which
+  // means that the region was evicted. Returns the addresses of the blocks it compiled.
+  std::vector<u32> CompileUntilEvicted(u32 region)
+  {
+    std::vector<u32> addresses;
+    bool left_region = false;
+    while (m_next_block < FIRST_BLOCK + NUM_BLOCKS * BLOCK_SIZE)
+    {
+      const u32 address = m_next_block;
+      m_next_block += BLOCK_SIZE;
+      addresses.push_back(address);
+      const u32 block_region = Compile(address);
+      if (block_region != region)
+        left_region = true;
+      else if (left_region)
+        return addresses;
+    }
+    ADD_FAILURE() << "Region " << region << " was never evicted";
+    return addresses;
+  }
+
+  std::string m_profile_path;
+  TestJit64 m_jit;
+  u32 m_next_block = FIRST_BLOCK;
+};
+
+TEST_F(Jit64CodeRegionsTest, NurseryRegionsAreEvictedInTurn)
+{
+  const std::vector<u32> first_pass = CompileUntilEvicted(0);
+
+  // Only the blocks of the region which was reused are gone.
+  for (size_t i = 0; i + 1 < first_pass.size(); i++)
+  {
+    const u32 address = first_pass[i];
+    const JitBlock* block = GetBlock(address);
+    if (block)
+      EXPECT_NE(0u, block->code_region);
+    if (i == 0)
+      EXPECT_EQ(nullptr, block);
+  }
+  ASSERT_NE(nullptr, GetBlock(first_pass.back()));
+  EXPECT_EQ(0u, GetBlock(first_pass.back())->code_region);
+
+  CompileUntilEvicted(1);
+  for (u32 address : first_pass)
+  {
+    const JitBlock* block = GetBlock(address);
+    if (block)
+      EXPECT_NE(1u, block->code_region);
+  }
+}
+
+TEST_F(Jit64CodeRegionsTest, EvictedBlocksAreTenured)
+{
+  std::vector<u32> evicted = CompileUntilEvicted(0);
+  evicted.pop_back();
+  const std::vector<u32> second_pass = CompileUntilEvicted(1);
+  evicted.insert(evicted.end(), second_pass.begin(), second_pass.end() - 1);
+
+  // Blocks which are requested again after their region was evicted go into the tenured region,
+  // until it is full and evicts itself.
+  const u32 tenured_region = Compile(evicted.front());
+  EXPECT_EQ(3u, tenured_region);
+  bool tenured_region_evicted = false;
+  for (size_t i = 1; i < evicted.size() && !tenured_region_evicted; i++)
+  {
+    if (GetBlock(evicted[i]))
+      continue;
+    EXPECT_EQ(tenured_region, Compile(evicted[i]));
+    tenured_region_evicted = GetBlock(evicted.front()) == nullptr;
+  }
+  EXPECT_TRUE(tenured_region_evicted);
+}
+
+TEST_F(Jit64CodeRegionsTest, BackPatchInfoIsDroppedWithRegion)
+{
+  const u32 address = FIRST_BLOCK;
+  EXPECT_EQ(0u, Compile(address));
+  u8* const load = m_jit.FindLoad(*GetBlock(address));
+  ASSERT_NE(nullptr, load);
+
+  // Accessing MMIO through fastmem faults, and the load is sent to a trampoline.
+  SContext ctx{};
+  ctx.CTX_PC = reinterpret_cast<u64>(load);
+  const uintptr_t mmio_address = reinterpret_cast<uintptr_t>(Memory::physical_base) + 0x0C000000;
+  ASSERT_TRUE(m_jit.HandleFault(mmio_address, &ctx));
+  EXPECT_NE(reinterpret_cast<u64>(load), static_cast<u64>(ctx.CTX_PC));
+
+  // Once the region is reused, the location of the load means nothing anymore. Compile() checks
+  // that no back patch info is left behind for code which was thrown away.
+  CompileUntilEvicted(0);
+  EXPECT_EQ(nullptr, GetBlock(address));
+  EXPECT_NE(nullptr, GetBlock(m_next_block - BLOCK_SIZE));
+}
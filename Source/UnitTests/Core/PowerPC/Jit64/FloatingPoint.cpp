@@ -0,0 +1,436 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Common/BitSet.h"
+#include "Common/BitUtils.h"
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/Jit64/Jit.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr u32 CODE_ADDRESS = 0x00003000;
+constexpr u32 DATA_ADDRESS = 0x00000100;
+
+// Quantized stores are only compiled with data translation on, so they use the cached mirror of
+// MEM1 which DBAT0 maps like the IPL sets it up.
+constexpr u32 DBAT0U_MEM1_CACHED = 0x80001fff;
+constexpr u32 DBAT0L_MEM1_CACHED = 0x00000002;
+constexpr u32 TRANSLATED_DATA_ADDRESS = 0x80000000 | DATA_ADDRESS;
+
+// Dequantizes unsigned bytes, which are always finite.
+constexpr u32 GQR_U8 = 0x00040004;
+constexpr int GQR_U8_INDEX = 2;
+
+constexpr u32 BLR = 0x4e800020;
+constexpr u32 B_SELF = 0x48000000;
+
+// Types of quantized stores, and scales which multiply by 8, by 1, and divide by 8.
+constexpr std::array<u32, 4> QUANTIZED_TYPES = {4, 5, 6, 7};  // U8, U16, S8, S16
+constexpr std::array<u32, 3> QUANTIZED_SCALES = {3, 0, 0x3d};
+
+// Pairs in and out of range of all types, to check the clamping.
+const std::vector<std::pair<double, double>> s_quantized_values = {
+    {1.5, -2.5},         {0.75, 127.9},       {-128.6, 255.5}, {300.0, -300.0},
+    {40000.0, -40000.0}, {70000.0, -70000.0}, {3.0e9, -3.0e9}, {-0.4, 32767.6},
+};
+
+u32 MakeGQRStorePart(u32 type, u32 scale)
+{
+  return (scale << 8) | type;
+}
+
+// psq_st f1, 0(r3), w, qr2 and psq_stx f1, r3, r4, w, qr2.
+u32 PsqSt(bool w)
+{
+  return 0xf0232000 | (w ? 0x8000 : 0);
+}
+
+u32 PsqStx(bool w)
+{
+  return 0x1023210e | (w ? 0x400 : 0);
+}
+
+class TestJit64 final : public Jit64
+{
+public:
+  // Which FPRs are known to be finite at the end of the last block that was compiled.
+  BitSet32 GetFiniteFPRs() const { return js.fprIsFinite; }
+
+  u32 GetGQRGuardFailures(u32 address) const
+  {
+    const auto it = m_gqr_guard_failures.find(address);
+    return it != m_gqr_guard_failures.end() ? it->second : 0;
+  }
+
+  static constexpr u32 GetMaxGQRRespecializations() { return MAX_GQR_RESPECIALIZATIONS; }
+};
+}  // namespace
+
+class Jit64FloatingPointTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    SConfig::GetInstance().bSyncGPUOnSkipIdleHack = false;
+    PowerPC::Init(PowerPC::CPUCore::Interpreter);
+    CoreTiming::Init();
+    for (ExpansionInterface::TEXIDevices& device : SConfig::GetInstance().m_EXIDevice)
+      device = ExpansionInterface::EXIDEVICE_NONE;
+    ExpansionInterface::Init();  // Needs to be initialized before Memory
+    Memory::Init();
+
+    MSR.FP = 1;
+    HID2.PSE = 1;
+    HID2.LSQE = 1;
+    PowerPC::ppcState.spr[SPR_GQR0 + GQR_U8_INDEX] = GQR_U8;
+    GPR(3) = DATA_ADDRESS;
+
+    m_saved_cpu_info = cpu_info;
+    m_jit.Init();
+    JitInterface::SetJit(&m_jit);
+  }
+
+  void TearDown() override
+  {
+    cpu_info = m_saved_cpu_info;
+    JitInterface::SetJit(nullptr);
+    m_jit.Shutdown();
+    Memory::Shutdown();
+    ExpansionInterface::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  static void WriteCode(const std::vector<u32>& code)
+  {
+    u32 address = CODE_ADDRESS;
+    for (u32 inst : code)
+    {
+      Memory::Write_U32(inst, address);
+      address += 4;
+    }
+  }
+
+  // Compiles the code from scratch, and returns the size of the block.
+  u32 Compile(const std::vector<u32>& code)
+  {
+    WriteCode(code);
+    m_jit.ClearCache();
+    m_jit.Jit(CODE_ADDRESS);
+    const JitBlock* block = m_jit.GetBlockCache()->GetBlockFromStartAddress(CODE_ADDRESS, MSR.Hex);
+    EXPECT_NE(nullptr, block);
+    return block ? block->codeSize : 0;
+  }
+
+  static void EnableDataTranslation()
+  {
+    PowerPC::ppcState.spr[SPR_DBAT0U] = DBAT0U_MEM1_CACHED;
+    PowerPC::ppcState.spr[SPR_DBAT0L] = DBAT0L_MEM1_CACHED;
+    PowerPC::DBATUpdated();
+    MSR.DR = 1;
+    GPR(3) = TRANSLATED_DATA_ADDRESS;
+  }
+
+  // Runs the code at CODE_ADDRESS up to the b 0 at its end, with the interpreter and then with the
+  // JIT, and checks that both store the same bytes at DATA_ADDRESS. The JIT keeps its blocks.
+  void ExpectSameStores(size_t num_instructions)
+  {
+    const u32 gqr2 = PowerPC::ppcState.spr[SPR_GQR0 + GQR_U8_INDEX];
+    const u32 gqr3 = PowerPC::ppcState.spr[SPR_GQR0 + 3];
+    const u32 end = CODE_ADDRESS + static_cast<u32>(num_instructions) * 4;
+
+    std::array<u8, 0x10> expected;
+    expected.fill(0xcc);
+    Memory::CopyToEmu(DATA_ADDRESS, expected.data(), expected.size());
+    PC = CODE_ADDRESS;
+    for (int i = 0; i < 100 && PC != end; i++)
+      Interpreter::getInstance()->SingleStepInner();
+    EXPECT_EQ(end, PC);
+    Memory::CopyFromEmu(expected.data(), DATA_ADDRESS, expected.size());
+    const u32 expected_gqr3 = PowerPC::ppcState.spr[SPR_GQR0 + 3];
+
+    std::array<u8, 0x10> actual;
+    actual.fill(0xcc);
+    Memory::CopyToEmu(DATA_ADDRESS, actual.data(), actual.size());
+    PowerPC::ppcState.spr[SPR_GQR0 + GQR_U8_INDEX] = gqr2;
+    PowerPC::ppcState.spr[SPR_GQR0 + 3] = gqr3;
+    PC = CODE_ADDRESS;
+    m_jit.Run();
+    EXPECT_EQ(end, PC);
+    Memory::CopyFromEmu(actual.data(), DATA_ADDRESS, actual.size());
+    EXPECT_EQ(expected, actual);
+    EXPECT_EQ(expected_gqr3, PowerPC::ppcState.spr[SPR_GQR0 + 3]);
+  }
+
+  std::string m_profile_path;
+  CPUInfo m_saved_cpu_info;
+  TestJit64 m_jit;
+};
+
+TEST_F(Jit64FloatingPointTest, FiniteFPRsAreTracked)
+{
+  Compile({
+      0xe0232000,  // psq_l f1, 0(r3), 0, qr2
+      0xe0430008,  // psq_l f2, 8(r3), 0, qr0
+      0x10600890,  // ps_mr f3, f1
+      0x10801850,  // ps_neg f4, f3
+      0x10a11c20,  // ps_merge00 f5, f1, f3
+      0x10c11460,  // ps_merge01 f6, f1, f2
+      0x10e1192e,  // ps_sel f7, f1, f4, f3
+      0x1101182a,  // ps_add f8, f1, f3
+      BLR,
+  });
+
+  // Only the integers loaded through qr2 and what is moved around from them are finite. Floats
+  // may be anything, and arithmetic can overflow.
+  EXPECT_EQ(BitSet32({1, 3, 4, 5, 7}), m_jit.GetFiniteFPRs());
+
+  Compile({
+      0xe0232000,  // psq_l f1, 0(r3), 0, qr2
+      0xe0430008,  // psq_l f2, 8(r3), 0, qr0
+      0x10201090,  // ps_mr f1, f2
+      BLR,
+  });
+  EXPECT_EQ(BitSet32{}, m_jit.GetFiniteFPRs());
+
+  // Blocks start out knowing nothing.
+  Compile({BLR});
+  EXPECT_EQ(BitSet32{}, m_jit.GetFiniteFPRs());
+}
+
+TEST_F(Jit64FloatingPointTest, NaNsAreOnlyHandledForInputsWhichMayBeNaN)
+{
+  // With finite inputs, accurate NaNs don't make the code any different.
+  const std::vector<u32> finite = {
+      0xe0232000,  // psq_l f1, 0(r3), 0, qr2
+      0xe0432000,  // psq_l f2, 0(r3), 0, qr2
+      0x1061102a,  // ps_add f3, f1, f2
+      BLR,
+  };
+  SConfig::GetInstance().bAccurateNaNs = false;
+  const u32 finite_size = Compile(finite);
+  SConfig::GetInstance().bAccurateNaNs = true;
+  EXPECT_EQ(finite_size, Compile(finite));
+
+  const std::vector<u32> any = {
+      0xe0232000,  // psq_l f1, 0(r3), 0, qr2
+      0xe0430008,  // psq_l f2, 8(r3), 0, qr0
+      0x1061102a,  // ps_add f3, f1, f2
+      BLR,
+  };
+  SConfig::GetInstance().bAccurateNaNs = false;
+  const u32 any_size = Compile(any);
+  SConfig::GetInstance().bAccurateNaNs = true;
+  EXPECT_LT(any_size, Compile(any));
+}
+
+// Runs the multiply-add family through Jit64::fmaddXX, with and without FMA, and compares the
+// results with the interpreter. The factors are single precision values, whose products are exact,
+// so FMA and a separate multiply and add round the same way.
+TEST_F(Jit64FloatingPointTest, MultiplyAddMatchesInterpreter)
+{
+  const std::vector<u32> instructions = {
+      0xfc8118ba,  // fmadd f4, f1, f2, f3
+      0xfc8118b8,  // fmsub f4, f1, f2, f3
+      0xfc8118be,  // fnmadd f4, f1, f2, f3
+      0xfc8118bc,  // fnmsub f4, f1, f2, f3
+      0xec8118ba,  // fmadds f4, f1, f2, f3
+      0xec8118b8,  // fmsubs f4, f1, f2, f3
+      0xec8118be,  // fnmadds f4, f1, f2, f3
+      0xec8118bc,  // fnmsubs f4, f1, f2, f3
+      0x108118ba,  // ps_madd f4, f1, f2, f3
+      0x108118b8,  // ps_msub f4, f1, f2, f3
+      0x108118be,  // ps_nmadd f4, f1, f2, f3
+      0x108118bc,  // ps_nmsub f4, f1, f2, f3
+      0x1081189c,  // ps_madds0 f4, f1, f2, f3
+      0x1081189e,  // ps_madds1 f4, f1, f2, f3
+  };
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<u32> any_u32;
+  std::uniform_int_distribution<u64> any_u64;
+  const auto random_single = [&] {
+    while (true)
+    {
+      const double value = Common::BitCast<float>(any_u32(rng));
+      if (std::isfinite(value))
+        return value;
+    }
+  };
+  const auto random_double = [&] {
+    while (true)
+    {
+      const double value = Common::BitCast<double>(any_u64(rng));
+      if (std::isfinite(value))
+        return value;
+    }
+  };
+
+  const bool host_has_fma = cpu_info.bFMA;
+  for (const bool fma : {false, true})
+  {
+    if (fma && !host_has_fma)
+      continue;
+    cpu_info.bFMA = fma;
+
+    for (u32 inst : instructions)
+    {
+      WriteCode({inst, B_SELF});
+      m_jit.ClearCache();
+      for (int i = 0; i < 50; i++)
+      {
+        rPS(1).SetBoth(random_single(), random_single());
+        rPS(2).SetBoth(random_single(), random_single());
+        rPS(3).SetBoth(random_double(), random_single());
+
+        FPSCR.Hex = 0;
+        rPS(4).SetBoth(u64{0}, u64{0});
+        PC = CODE_ADDRESS;
+        Interpreter::getInstance()->SingleStepInner();
+        const u64 expected_ps0 = rPS(4).PS0AsU64();
+        const u64 expected_ps1 = rPS(4).PS1AsU64();
+
+        FPSCR.Hex = 0;
+        rPS(4).SetBoth(u64{0}, u64{0});
+        PC = CODE_ADDRESS;
+        m_jit.Run();
+        EXPECT_EQ(expected_ps0, rPS(4).PS0AsU64())
+            << std::hex << inst << ", FMA " << fma << ", inputs " << rPS(1).PS0AsU64() << " "
+            << rPS(2).PS0AsU64() << " " << rPS(3).PS0AsU64();
+        EXPECT_EQ(expected_ps1, rPS(4).PS1AsU64())
+            << std::hex << inst << ", FMA " << fma << ", inputs " << rPS(1).PS1AsU64() << " "
+            << rPS(2).PS1AsU64() << " " << rPS(3).PS1AsU64();
+
+        if (HasFailure())
+          return;
+      }
+    }
+  }
+}
+
+// Stores through a GQR which is known when the block is compiled are quantized inline, for each
+// type and scale.
+TEST_F(Jit64FloatingPointTest, QuantizedStoresMatchInterpreter)
+{
+  EnableDataTranslation();
+  GPR(4) = 8;
+  for (const bool indexed : {false, true})
+  {
+    for (const bool w : {false, true})
+    {
+      WriteCode({indexed ? PsqStx(w) : PsqSt(w), B_SELF});
+      for (u32 type : QUANTIZED_TYPES)
+      {
+        for (u32 scale : QUANTIZED_SCALES)
+        {
+          PowerPC::ppcState.spr[SPR_GQR0 + GQR_U8_INDEX] = MakeGQRStorePart(type, scale);
+          m_jit.ClearCache();
+          for (const auto& [ps0, ps1] : s_quantized_values)
+          {
+            SCOPED_TRACE(testing::Message() << "indexed " << indexed << ", w " << w << ", type "
+                                            << type << ", scale " << scale << ", " << ps0 << " "
+                                            << ps1);
+            rPS(1).SetBoth(ps0, ps1);
+            ExpectSameStores(1);
+          }
+          if (HasFailure())
+            return;
+        }
+      }
+    }
+  }
+  EXPECT_EQ(0u, m_jit.GetGQRGuardFailures(CODE_ADDRESS));
+}
+
+// A GQR which the block sets to a constant is known for the stores after it, whatever it was when
+// the block was compiled.
+TEST_F(Jit64FloatingPointTest, QuantizedStoreAfterConstantGQRMatchesInterpreter)
+{
+  EnableDataTranslation();
+  for (u32 type : QUANTIZED_TYPES)
+  {
+    for (u32 scale : QUANTIZED_SCALES)
+    {
+      const u32 gqr = MakeGQRStorePart(type, scale);
+      WriteCode({
+          0x38a00000 | gqr,  // li r5, gqr
+          0x7cb3e3a6,        // mtspr GQR3, r5
+          0xf0233000,        // psq_st f1, 0(r3), 0, qr3
+          B_SELF,
+      });
+      m_jit.ClearCache();
+      for (const u32 initial_gqr : {0u, MakeGQRStorePart(7, 0x3d)})
+      {
+        PowerPC::ppcState.spr[SPR_GQR0 + 3] = initial_gqr;
+        for (const auto& [ps0, ps1] : s_quantized_values)
+        {
+          SCOPED_TRACE(testing::Message() << "type " << type << ", scale " << scale
+                                          << ", initial GQR " << initial_gqr << ", " << ps0 << " "
+                                          << ps1);
+          rPS(1).SetBoth(ps0, ps1);
+          ExpectSameStores(3);
+        }
+      }
+      EXPECT_EQ(0u, m_jit.GetGQRGuardFailures(CODE_ADDRESS));
+      if (HasFailure())
+        return;
+    }
+  }
+}
+
+// Every change of the GQR fails the guard of the block, which is compiled again for the new value.
+// Once that happened too often, the block reads the GQR at runtime.
+TEST_F(Jit64FloatingPointTest, QuantizedStoreFallsBackToRuntimeGQR)
+{
+  EnableDataTranslation();
+  WriteCode({PsqSt(false), B_SELF});
+  rPS(1).SetBoth(300.0, -2.5);
+
+  const u32 max_respecializations = TestJit64::GetMaxGQRRespecializations();
+  for (u32 i = 0; i < max_respecializations + 4; i++)
+  {
+    const u32 type = QUANTIZED_TYPES[i % QUANTIZED_TYPES.size()];
+    const u32 scale = QUANTIZED_SCALES[i % QUANTIZED_SCALES.size()];
+    PowerPC::ppcState.spr[SPR_GQR0 + GQR_U8_INDEX] = MakeGQRStorePart(type, scale);
+    SCOPED_TRACE(testing::Message() << "run " << i);
+    ExpectSameStores(1);
+
+    const u32 failures = std::min(i, max_respecializations + 1);
+    EXPECT_EQ(failures, m_jit.GetGQRGuardFailures(CODE_ADDRESS));
+    EXPECT_EQ(failures > max_respecializations,
+              m_jit.js.pairedQuantizeAddresses.count(CODE_ADDRESS) != 0);
+  }
+}
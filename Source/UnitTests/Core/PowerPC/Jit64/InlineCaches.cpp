@@ -0,0 +1,243 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/Jit64/Jit.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr u32 CODE_ADDRESS = 0x00003000;
+constexpr u32 TARGETS_ADDRESS = 0x00004000;
+constexpr u32 TARGET_SIZE = 0x10;
+constexpr u32 NUM_TARGETS = 6;
+constexpr u32 TABLE_ADDRESS = 0x00000100;
+
+// Calls or jumps to each target of the table at r4 in turn, r5 times. The targets accumulate
+// which of them ran and in which order in r3.
+constexpr u32 RETURN_ADDRESS = CODE_ADDRESS + 3 * 4;
+constexpr u32 END_ADDRESS = CODE_ADDRESS + 6 * 4;
+std::vector<u32> GetLoop(bool call)
+{
+  return {
+      0x80e40000,                      // lwz r7, 0(r4)
+      0x7ce903a6,                      // mtctr r7
+      call ? 0x4e800421 : 0x4e800420,  // bctrl or bctr
+      0x38840004,                      // addi r4, r4, 4
+      0x34a5ffff,                      // addic. r5, r5, -1
+      0x4082ffec,                      // bne -20
+      0x48000000,                      // b 0
+  };
+}
+
+std::vector<u32> GetTarget(bool call, u32 index)
+{
+  return {
+      0x1c630007,                                        // mulli r3, r3, 7
+      0x38630001 + index,                                // addi r3, r3, index + 1
+      call ? 0x4e800020 : 0x48000002 | RETURN_ADDRESS,  // blr or ba RETURN_ADDRESS
+  };
+}
+
+u32 GetTargetAddress(u32 index)
+{
+  return TARGETS_ADDRESS + index * TARGET_SIZE;
+}
+
+// Target 3 is the fifth distinct one, which finds all slots taken.
+const std::vector<u32> s_sequence = {2, 0, 5, 1, 3, 4, 2, 3, 5, 0};
+const std::vector<u32> s_slots = {2, 0, 5, 1};
+constexpr u64 EXPECTED_HITS = 3;
+constexpr u64 EXPECTED_MISSES = 7;
+
+class TestJit64 final : public Jit64
+{
+public:
+  // The destinations which the slots of the only inline cache were filled with.
+  std::vector<u32> GetInlineCacheDestinations() const
+  {
+    std::vector<u32> destinations;
+    if (m_inline_caches.size() != 1)
+    {
+      ADD_FAILURE() << m_inline_caches.size() << " inline caches";
+      return destinations;
+    }
+    const InlineCache& cache = m_inline_caches.begin()->second;
+    for (u32 i = 0; i < cache.used_slots; i++)
+    {
+      u32 destination;
+      std::memcpy(&destination, cache.destinations[i], sizeof(destination));
+      destinations.push_back(destination);
+    }
+    return destinations;
+  }
+};
+}  // namespace
+
+class Jit64InlineCachesTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    SConfig::GetInstance().bSyncGPUOnSkipIdleHack = false;
+    PowerPC::Init(PowerPC::CPUCore::Interpreter);
+    CoreTiming::Init();
+    for (ExpansionInterface::TEXIDevices& device : SConfig::GetInstance().m_EXIDevice)
+      device = ExpansionInterface::EXIDEVICE_NONE;
+    ExpansionInterface::Init();  // Needs to be initialized before Memory
+    Memory::Init();
+
+    for (u32 i = 0; i < s_sequence.size(); i++)
+      Memory::Write_U32(GetTargetAddress(s_sequence[i]), TABLE_ADDRESS + i * 4);
+
+    m_jit.Init();
+  }
+
+  void TearDown() override
+  {
+    m_jit.Shutdown();
+    Memory::Shutdown();
+    ExpansionInterface::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  static void WriteCode(u32 address, const std::vector<u32>& code)
+  {
+    for (u32 inst : code)
+    {
+      Memory::Write_U32(inst, address);
+      address += 4;
+    }
+  }
+
+  static void WriteProgram(bool call)
+  {
+    WriteCode(CODE_ADDRESS, GetLoop(call));
+    for (u32 i = 0; i < NUM_TARGETS; i++)
+      WriteCode(GetTargetAddress(i), GetTarget(call, i));
+  }
+
+  static void ResetRegisters()
+  {
+    GPR(3) = 0;
+    GPR(4) = TABLE_ADDRESS;
+    GPR(5) = static_cast<u32>(s_sequence.size());
+    LR = 0;
+    PC = CODE_ADDRESS;
+  }
+
+  // Sums the inline cache hits and misses of all blocks.
+  std::pair<u64, u64> GetInlineCacheStats()
+  {
+    u64 hits = 0;
+    u64 misses = 0;
+    m_jit.GetBlockCache()->RunOnBlocks([&](const JitBlock& block) {
+      hits += block.profile_data.inlineCacheHits;
+      misses += block.profile_data.inlineCacheMisses;
+    });
+    return {hits, misses};
+  }
+
+  // Runs the loop with the interpreter and with the JIT, and compares the results.
+  void ExpectSameResults()
+  {
+    ResetRegisters();
+    for (int i = 0; i < 1000 && PC != END_ADDRESS; i++)
+      Interpreter::getInstance()->SingleStepInner();
+    ASSERT_EQ(END_ADDRESS, PC);
+    const u32 expected = GPR(3);
+
+    ResetRegisters();
+    m_jit.ClearCache();
+    m_jit.Run();
+    ASSERT_EQ(END_ADDRESS, PC);
+    EXPECT_EQ(expected, GPR(3));
+    EXPECT_EQ(TABLE_ADDRESS + s_sequence.size() * 4, GPR(4));
+  }
+
+  std::string m_profile_path;
+  TestJit64 m_jit;
+};
+
+TEST_F(Jit64InlineCachesTest, IndirectBranchesMatchInterpreter)
+{
+  for (const bool call : {false, true})
+  {
+    WriteProgram(call);
+    ExpectSameResults();
+
+    // The slots are filled in the order the destinations first came up.
+    std::vector<u32> expected_slots;
+    for (u32 index : s_slots)
+      expected_slots.push_back(GetTargetAddress(index));
+    EXPECT_EQ(expected_slots, m_jit.GetInlineCacheDestinations()) << "call " << call;
+  }
+}
+
+TEST_F(Jit64InlineCachesTest, HitsAndMissesAreProfiled)
+{
+  m_jit.jo.profile_blocks = true;
+  for (const bool call : {false, true})
+  {
+    WriteProgram(call);
+    ExpectSameResults();
+
+    // Once the slots are taken, the other destinations miss every time and go through the
+    // dispatcher.
+    EXPECT_EQ(std::make_pair(EXPECTED_HITS, EXPECTED_MISSES), GetInlineCacheStats())
+        << "call " << call;
+  }
+}
+
+TEST_F(Jit64InlineCachesTest, TargetBlocksAreLinked)
+{
+  WriteProgram(true);
+  ExpectSameResults();
+
+  // Run again with the cache kept, so that the slots jump to the blocks of the targets directly.
+  m_jit.jo.profile_blocks = false;
+  ResetRegisters();
+  m_jit.Run();
+  EXPECT_EQ(END_ADDRESS, PC);
+
+  const JitBlock* loop = m_jit.GetBlockCache()->GetBlockFromStartAddress(CODE_ADDRESS, MSR.Hex);
+  ASSERT_NE(nullptr, loop);
+  for (u32 index : s_slots)
+  {
+    const auto link =
+        std::find_if(loop->linkData.begin(), loop->linkData.end(), [&](const auto& data) {
+          return data.exitAddress == GetTargetAddress(index);
+        });
+    ASSERT_NE(loop->linkData.end(), link) << index;
+    EXPECT_TRUE(link->linkStatus) << index;
+    EXPECT_TRUE(link->call) << index;
+  }
+}
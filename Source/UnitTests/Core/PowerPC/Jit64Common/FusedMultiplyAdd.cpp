@@ -0,0 +1,122 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Common/BitUtils.h"
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/x64Emitter.h"
+#include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/Interpreter/Interpreter_FPUtils.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+using Function = double (*)(double a, double c, double b);
+
+// Emits the sequences Jit64::fmaddXX uses for madd, msub and nmsub, with and without FMA. The
+// inputs are a, c and b in XMM0, XMM1 and XMM2, which is where both ABIs pass them.
+class TestCode : public Gen::X64CodeBlock
+{
+public:
+  TestCode()
+  {
+    using namespace Gen;
+
+    AllocCodeSpace(4096);
+
+    fma_madd = Emit([this] { VFMADD132SD(XMM1, XMM2, R(XMM0)); });
+    fma_msub = Emit([this] { VFMSUB132SD(XMM1, XMM2, R(XMM0)); });
+    fma_nmsub = Emit([this] { VFNMADD132SD(XMM1, XMM2, R(XMM0)); });
+    madd = Emit([this] {
+      MULSD(XMM1, R(XMM0));
+      ADDSD(XMM1, R(XMM2));
+    });
+    msub = Emit([this] {
+      MULSD(XMM1, R(XMM0));
+      SUBSD(XMM1, R(XMM2));
+    });
+    nmsub = Emit([this] {
+      MULSD(XMM0, R(XMM1));
+      SUBSD(XMM2, R(XMM0));
+      MOVAPD(XMM1, R(XMM2));
+    });
+  }
+
+  Function fma_madd, fma_msub, fma_nmsub;
+  Function madd, msub, nmsub;
+
+private:
+  template <typename F>
+  Function Emit(F body)
+  {
+    const auto function = reinterpret_cast<Function>(AlignCode4());
+    body();
+    MOVAPD(Gen::XMM0, Gen::R(Gen::XMM1));
+    RET();
+    return function;
+  }
+};
+
+u64 Bits(double value)
+{
+  return Common::BitCast<u64>(value);
+}
+}  // namespace
+
+// Jit64 uses FMA even when determinism is required if a and c are single precision, as their
+// product is then exact and FMA can't round differently from a separate multiply and add. Hosts
+// without FMA only check the separate multiply and add against the interpreter.
+TEST(Jit64, FusedMultiplyAddWithSingleFactors)
+{
+  TestCode code;
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<u32> any_u32;
+  std::uniform_int_distribution<u64> any_u64;
+  std::vector<double> singles{0.0, -0.0, 1.0, -1.0, 0x1p-149, -0x1p-149, 0x1.fffffep127};
+  std::vector<double> doubles{0.0, -0.0, 1.0, 0x1p-1074, 0x1.fffffffffffffp1023};
+  while (singles.size() < 300)
+  {
+    const double value = Common::BitCast<float>(any_u32(rng));
+    if (std::isfinite(value))
+      singles.push_back(value);
+  }
+  while (doubles.size() < 100)
+  {
+    const double value = Common::BitCast<double>(any_u64(rng));
+    if (std::isfinite(value))
+      doubles.push_back(value);
+  }
+
+  UReg_FPSCR fpscr{0};
+  const auto check = [&](double a, double c, double b) {
+    const u64 expected_madd = Bits(NI_madd(&fpscr, a, c, b).value);
+    const u64 expected_msub = Bits(NI_msub(&fpscr, a, c, b).value);
+    EXPECT_EQ(expected_madd, Bits(code.madd(a, c, b)));
+    EXPECT_EQ(expected_msub, Bits(code.msub(a, c, b)));
+    if (!cpu_info.bFMA)
+      return;
+
+    EXPECT_EQ(expected_madd, Bits(code.fma_madd(a, c, b)));
+    EXPECT_EQ(expected_msub, Bits(code.fma_msub(a, c, b)));
+    EXPECT_EQ(Bits(code.nmsub(a, c, b)), Bits(code.fma_nmsub(a, c, b)));
+  };
+
+  for (size_t i = 0; i + 1 < singles.size(); i++)
+  {
+    const double a = singles[i];
+    const double c = singles[i + 1];
+    // Also cancel the product out exactly, which is where the sign of zero results is decided.
+    for (double b : {singles[singles.size() - 1 - i], doubles[i % doubles.size()], a * c, -a * c})
+      check(a, c, b);
+
+    if (HasFailure())
+      return;
+  }
+}
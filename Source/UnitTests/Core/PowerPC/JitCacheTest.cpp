@@ -0,0 +1,250 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+
+// include order is important
+#include <gtest/gtest.h>  // NOLINT
+
+namespace
+{
+// Block cache which records the links it would write instead of emitting code.
+class FakeBlockCache final : public JitBaseBlockCache
+{
+public:
+  using JitBaseBlockCache::JitBaseBlockCache;
+
+  struct Link
+  {
+    const JitBlock* dest;
+    u32 dest_address;
+  };
+  std::map<const u8*, Link> links;
+
+private:
+  void WriteLinkBlock(const JitBlock::LinkData& source, const JitBlock* dest) override
+  {
+    if (dest)
+      links[source.exitPtrs] = {dest, dest->effectiveAddress};
+    else
+      links.erase(source.exitPtrs);
+  }
+};
+
+class FakeJit final : public JitBase
+{
+public:
+  // CPUCoreBase methods
+  void Init() override {}
+  void Shutdown() override {}
+  void ClearCache() override {}
+  void Run() override {}
+  void SingleStep() override {}
+  const char* GetName() const override { return nullptr; }
+  // JitBase methods
+  JitBaseBlockCache* GetBlockCache() override { return &m_block_cache; }
+  void Jit(u32 em_address) override {}
+  const CommonAsmRoutinesBase* GetAsmRoutines() override { return nullptr; }
+  bool HandleFault(uintptr_t access_address, SContext* ctx) override { return false; }
+
+  FakeBlockCache m_block_cache{*this};
+};
+
+constexpr u32 BLOCK_SIZE = 0x10;
+constexpr u32 FIRST_BLOCK = 0x80003000;
+}  // namespace
+
+class JitCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override { m_cache.Clear(); }
+  void TearDown() override { m_cache.Clear(); }
+
+  // Adds a block like a JIT would, with a fake address for each exit so the links can be tracked.
+  JitBlock* Compile(u32 address, u32 region, const std::vector<u32>& exits)
+  {
+    JitBlock* block = m_cache.AllocateBlock(address);
+    block->code_region = region;
+    block->checkedEntry = block->normalEntry = NextFakeCodePtr();
+    block->codeSize = 1;
+    block->originalSize = BLOCK_SIZE / 4;
+    for (u32 exit : exits)
+      block->linkData.push_back({NextFakeCodePtr(), exit, false, false});
+
+    std::set<u32> physical_addresses;
+    for (u32 i = 0; i < BLOCK_SIZE; i += 4)
+      physical_addresses.insert(address + i);
+    m_cache.FinalizeBlock(*block, true, physical_addresses);
+    return block;
+  }
+
+  JitBlock* Lookup(u32 address) { return m_cache.GetBlockFromStartAddress(address, 0); }
+
+  // Checks that the maps of the cache only refer to live blocks, and that every exit to a live
+  // block is linked to it.
+  void CheckConsistency()
+  {
+    std::set<const JitBlock*> live_blocks;
+    std::set<const u8*> live_exits;
+    m_cache.RunOnBlocks([&](const JitBlock& block) {
+      live_blocks.insert(&block);
+      for (const auto& e : block.linkData)
+        live_exits.insert(e.exitPtrs);
+    });
+
+    for (const auto& link : m_cache.links)
+    {
+      ASSERT_EQ(1u, live_exits.count(link.first));
+      ASSERT_EQ(link.second.dest, Lookup(link.second.dest_address));
+    }
+
+    JitBlock** fast_block_map = m_cache.GetFastBlockMap();
+    for (u32 i = 0; i < JitBaseBlockCache::FAST_BLOCK_MAP_ELEMENTS; i++)
+      ASSERT_TRUE(!fast_block_map[i] || live_blocks.count(fast_block_map[i]));
+
+    m_cache.RunOnBlocks([&](const JitBlock& block) {
+      for (const auto& e : block.linkData)
+      {
+        const JitBlock* dest = Lookup(e.exitAddress);
+        ASSERT_EQ(dest != nullptr, e.linkStatus);
+        if (dest)
+        {
+          ASSERT_EQ(dest, m_cache.links.at(e.exitPtrs).dest);
+        }
+      }
+    });
+  }
+
+  u8* NextFakeCodePtr() { return reinterpret_cast<u8*>(++m_next_code_ptr); }
+
+  FakeJit m_jit;
+  FakeBlockCache& m_cache = m_jit.m_block_cache;
+
+private:
+  uintptr_t m_next_code_ptr = 0x1000;
+};
+
+TEST_F(JitCacheTest, EraseCodeRegion)
+{
+  const u32 a_address = FIRST_BLOCK;
+  const u32 b_address = FIRST_BLOCK + 0x100;
+
+  JitBlock* a = Compile(a_address, 0, {b_address});
+  JitBlock* b = Compile(b_address, 1, {a_address});
+  EXPECT_TRUE(a->linkData[0].linkStatus);
+  EXPECT_TRUE(b->linkData[0].linkStatus);
+  EXPECT_EQ(2u, m_cache.links.size());
+
+  m_cache.EraseCodeRegion(1);
+  EXPECT_EQ(a, Lookup(a_address));
+  EXPECT_EQ(nullptr, Lookup(b_address));
+  EXPECT_FALSE(a->linkData[0].linkStatus);
+  EXPECT_TRUE(m_cache.links.empty());
+  EXPECT_TRUE(m_cache.WasEvicted(b_address));
+  EXPECT_FALSE(m_cache.WasEvicted(a_address));
+  CheckConsistency();
+
+  // Compiling the block again links the exit of the block which survived to it.
+  b = Compile(b_address, 2, {a_address});
+  EXPECT_TRUE(a->linkData[0].linkStatus);
+  EXPECT_EQ(b, m_cache.links.at(a->linkData[0].exitPtrs).dest);
+  CheckConsistency();
+
+  // Modified code is not in use anymore.
+  m_cache.EraseCodeRegion(2);
+  m_cache.InvalidateICache(b_address, BLOCK_SIZE, false);
+  EXPECT_FALSE(m_cache.WasEvicted(b_address));
+
+  Compile(b_address, 2, {a_address});
+  m_cache.EraseCodeRegion(2);
+  EXPECT_TRUE(m_cache.WasEvicted(b_address));
+  m_cache.Clear();
+  EXPECT_FALSE(m_cache.WasEvicted(b_address));
+}
+
+TEST_F(JitCacheTest, AddBlockExit)
+{
+  const u32 a_address = FIRST_BLOCK;
+  const u32 b_address = FIRST_BLOCK + 0x100;
+  const u32 c_address = FIRST_BLOCK + 0x200;
+
+  JitBlock* a = Compile(a_address, 0, {});
+  JitBlock* b = Compile(b_address, 1, {});
+
+  // Exits added after the block was finalized are linked like the others.
+  m_cache.AddBlockExit(*a, {NextFakeCodePtr(), b_address, false, false});
+  EXPECT_TRUE(a->linkData[0].linkStatus);
+  EXPECT_EQ(b, m_cache.links.at(a->linkData[0].exitPtrs).dest);
+
+  m_cache.AddBlockExit(*a, {NextFakeCodePtr(), c_address, false, false});
+  EXPECT_FALSE(a->linkData[1].linkStatus);
+  JitBlock* c = Compile(c_address, 1, {});
+  EXPECT_TRUE(a->linkData[1].linkStatus);
+  EXPECT_EQ(c, m_cache.links.at(a->linkData[1].exitPtrs).dest);
+  CheckConsistency();
+
+  m_cache.EraseCodeRegion(1);
+  EXPECT_FALSE(a->linkData[0].linkStatus);
+  EXPECT_FALSE(a->linkData[1].linkStatus);
+  EXPECT_TRUE(m_cache.links.empty());
+  CheckConsistency();
+}
+
+// Runs a random program through a deliberately tiny cache which evicts one region after a few
+// blocks, so blocks are constantly destroyed while others still link to them.
+TEST_F(JitCacheTest, TinyCacheStress)
+{
+  constexpr u32 NUM_REGIONS = 4;
+  constexpr u32 TENURED_REGION = NUM_REGIONS - 1;
+  constexpr u32 BLOCKS_PER_REGION = 8;
+  constexpr u32 NUM_BLOCKS = 256;
+  constexpr u32 NUM_HOT_BLOCKS = 4;
+
+  std::mt19937 rng(1234);
+  const auto block_address = [](u32 index) { return FIRST_BLOCK + index * BLOCK_SIZE; };
+  std::uniform_int_distribution<u32> any_block(0, NUM_BLOCKS - 1);
+  std::uniform_int_distribution<u32> hot_block(0, NUM_HOT_BLOCKS - 1);
+  std::uniform_int_distribution<u32> percent(0, 99);
+
+  std::array<u32, NUM_REGIONS> region_blocks{};
+  u32 nursery_region = 0;
+  u32 evictions = 0;
+
+  for (u32 i = 0; i < 5000; i++)
+  {
+    const u32 address = block_address(percent(rng) < 80 ? hot_block(rng) : any_block(rng));
+    if (Lookup(address))
+      continue;
+
+    // Same policy as Jit64: nursery regions are reused in turn, and blocks which are needed again
+    // after being evicted go into the tenured region.
+    const bool tenured = m_cache.WasEvicted(address);
+    u32 region = tenured ? TENURED_REGION : nursery_region;
+    if (region_blocks[region] == BLOCKS_PER_REGION)
+    {
+      if (!tenured)
+        region = nursery_region = (nursery_region + 1) % TENURED_REGION;
+      m_cache.EraseCodeRegion(region);
+      region_blocks[region] = 0;
+      evictions++;
+    }
+
+    Compile(address, region, {block_address(any_block(rng)), block_address(hot_block(rng))});
+    region_blocks[region]++;
+
+    CheckConsistency();
+    if (HasFatalFailure())
+      return;
+  }
+
+  EXPECT_GT(evictions, 100u);
+}
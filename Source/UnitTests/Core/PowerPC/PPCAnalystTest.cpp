@@ -0,0 +1,212 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+constexpr u32 CODE_ADDRESS = 0x00003000;
+constexpr u32 FUNCTION_ADDRESS = 0x00004000;
+constexpr u32 OTHER_FUNCTION_ADDRESS = 0x00005000;
+
+constexpr u32 BLR = 0x4e800020;
+constexpr u32 CMPWI_R3_0 = 0x2c030000;
+constexpr u32 LWZ_R3_0_R4 = 0x80640000;
+constexpr u32 NOP = 0x60000000;
+
+// Conditional and unconditional branches from the given address to the target.
+u32 Beq(u32 address, u32 target)
+{
+  return 0x41820000 | ((target - address) & 0xfffc);
+}
+
+u32 Bne(u32 address, u32 target)
+{
+  return 0x40820000 | ((target - address) & 0xfffc);
+}
+
+u32 B(u32 address, u32 target)
+{
+  return 0x48000000 | ((target - address) & 0x03fffffc);
+}
+
+u32 Bl(u32 address, u32 target)
+{
+  return B(address, target) | 1;
+}
+}  // namespace
+
+class PPCAnalystTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    PowerPC::Init(PowerPC::CPUCore::Interpreter);
+    CoreTiming::Init();
+    for (ExpansionInterface::TEXIDevices& device : SConfig::GetInstance().m_EXIDevice)
+      device = ExpansionInterface::EXIDEVICE_NONE;
+    ExpansionInterface::Init();  // Needs to be initialized before Memory
+    Memory::Init();
+
+    m_block.m_stats = &m_stats;
+    m_block.m_gpa = &m_gpa;
+    m_block.m_fpa = &m_fpa;
+  }
+
+  void TearDown() override
+  {
+    Memory::Shutdown();
+    ExpansionInterface::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  static void WriteCode(u32 address, const std::vector<u32>& code)
+  {
+    for (u32 inst : code)
+    {
+      Memory::Write_U32(inst, address);
+      address += 4;
+    }
+  }
+
+  // Analyzes the block at block_address, and returns whether the branch at the given address was
+  // found to be a busy wait loop.
+  bool IsIdleLoop(u32 branch_address, u32 block_address = CODE_ADDRESS)
+  {
+    m_analyzer.Analyze(block_address, &m_block, &m_buffer, m_buffer.size());
+    for (u32 i = 0; i < m_block.m_num_instructions; i++)
+    {
+      if (m_buffer[i].address == branch_address)
+        return m_buffer[i].branchIsIdleLoop;
+    }
+    ADD_FAILURE() << "The branch isn't part of the block";
+    return false;
+  }
+
+  std::string m_profile_path;
+  PPCAnalyst::PPCAnalyzer m_analyzer;
+  PPCAnalyst::CodeBlock m_block;
+  PPCAnalyst::CodeBuffer m_buffer{32};
+  PPCAnalyst::BlockStats m_stats;
+  PPCAnalyst::BlockRegStats m_gpa;
+  PPCAnalyst::BlockRegStats m_fpa;
+};
+
+TEST_F(PPCAnalystTest, PollingLoopIsIdle)
+{
+  WriteCode(CODE_ADDRESS, {LWZ_R3_0_R4, CMPWI_R3_0, Beq(CODE_ADDRESS + 8, CODE_ADDRESS)});
+  EXPECT_TRUE(IsIdleLoop(CODE_ADDRESS + 8));
+}
+
+TEST_F(PPCAnalystTest, LoopInMiddleOfBlockIsIdle)
+{
+  constexpr u32 loop = CODE_ADDRESS + 8;
+  WriteCode(CODE_ADDRESS, {
+                              0x38a00000,  // li r5, 0
+                              0x7ca62b78,  // mr r6, r5
+                              LWZ_R3_0_R4,
+                              0x7c0004ac,  // sync
+                              CMPWI_R3_0,
+                              Beq(loop + 12, loop),
+                          });
+  EXPECT_TRUE(IsIdleLoop(loop + 12));
+}
+
+TEST_F(PPCAnalystTest, LoopCallingLeafFunctionIsIdle)
+{
+  WriteCode(CODE_ADDRESS, {Bl(CODE_ADDRESS, FUNCTION_ADDRESS), CMPWI_R3_0,
+                           Beq(CODE_ADDRESS + 8, CODE_ADDRESS)});
+  WriteCode(FUNCTION_ADDRESS, {LWZ_R3_0_R4, BLR});
+
+  // Without following branches, the call ends a block, and the loop starts before the next one.
+  EXPECT_TRUE(IsIdleLoop(CODE_ADDRESS + 8, CODE_ADDRESS + 4));
+
+  m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  EXPECT_TRUE(IsIdleLoop(CODE_ADDRESS + 8));
+}
+
+TEST_F(PPCAnalystTest, LoopWithExitAndForwardBranchIsIdle)
+{
+  constexpr u32 exit = CODE_ADDRESS + 0x100;
+  WriteCode(CODE_ADDRESS, {
+                              LWZ_R3_0_R4,
+                              CMPWI_R3_0,
+                              Bne(CODE_ADDRESS + 8, exit),
+                              B(CODE_ADDRESS + 12, CODE_ADDRESS + 20),
+                              NOP,
+                              B(CODE_ADDRESS + 20, CODE_ADDRESS),
+                          });
+  m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+  m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  EXPECT_TRUE(IsIdleLoop(CODE_ADDRESS + 20));
+}
+
+TEST_F(PPCAnalystTest, LoopWritingMemoryIsNotIdle)
+{
+  WriteCode(CODE_ADDRESS, {
+                              0x90a60000,  // stw r5, 0(r6)
+                              LWZ_R3_0_R4,
+                              CMPWI_R3_0,
+                              Beq(CODE_ADDRESS + 12, CODE_ADDRESS),
+                          });
+  EXPECT_FALSE(IsIdleLoop(CODE_ADDRESS + 12));
+}
+
+TEST_F(PPCAnalystTest, LoopCallingNonLeafFunctionIsNotIdle)
+{
+  WriteCode(CODE_ADDRESS, {Bl(CODE_ADDRESS, FUNCTION_ADDRESS), CMPWI_R3_0,
+                           Beq(CODE_ADDRESS + 8, CODE_ADDRESS)});
+  WriteCode(FUNCTION_ADDRESS, {Bl(FUNCTION_ADDRESS, OTHER_FUNCTION_ADDRESS), BLR});
+  WriteCode(OTHER_FUNCTION_ADDRESS, {LWZ_R3_0_R4, BLR});
+  EXPECT_FALSE(IsIdleLoop(CODE_ADDRESS + 8, CODE_ADDRESS + 4));
+}
+
+TEST_F(PPCAnalystTest, LoopWritingSPRIsNotIdle)
+{
+  WriteCode(CODE_ADDRESS, {
+                              LWZ_R3_0_R4,
+                              0x7c7043a6,  // mtsprg0 r3
+                              CMPWI_R3_0,
+                              Beq(CODE_ADDRESS + 12, CODE_ADDRESS),
+                          });
+  EXPECT_FALSE(IsIdleLoop(CODE_ADDRESS + 12));
+}
+
+TEST_F(PPCAnalystTest, LoopMakingProgressIsNotIdle)
+{
+  WriteCode(CODE_ADDRESS, {
+                              0x38630001,  // addi r3, r3, 1
+                              0x2c03000a,  // cmpwi r3, 10
+                              0x4180fff8,  // blt -8
+                          });
+  EXPECT_FALSE(IsIdleLoop(CODE_ADDRESS + 8));
+
+  WriteCode(CODE_ADDRESS, {LWZ_R3_0_R4, 0x4200fffc});  // bdnz -4
+  EXPECT_FALSE(IsIdleLoop(CODE_ADDRESS + 4));
+}
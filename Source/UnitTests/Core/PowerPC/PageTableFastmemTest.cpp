@@ -0,0 +1,221 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <string>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/Swap.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+// A 64KB page table, the smallest there is, whose hash mask is 0x3ff.
+constexpr u32 PAGE_TABLE_ADDRESS = 0x00100000;
+constexpr u32 PAGE_TABLE_HASH_MASK = 0x3ff;
+
+constexpr u32 SEGMENT = 4;
+constexpr u32 VSID = 0x123;
+
+constexpr u32 PTE1_V = 0x80000000;
+constexpr u32 PTE2_R = 0x100;
+constexpr u32 PTE2_C = 0x80;
+constexpr u32 PTE2_PP_READ_WRITE = 2;
+
+// Pages whose translations go into the same set of the data TLB, which has two ways.
+constexpr u32 PAGE_A = 0x40001000;
+constexpr u32 PAGE_B = 0x40041000;
+constexpr u32 PAGE_C = 0x40081000;
+constexpr u32 PHYSICAL_PAGE_A = 0x00200000;
+constexpr u32 PHYSICAL_PAGE_B = 0x00201000;
+constexpr u32 PHYSICAL_PAGE_C = 0x00202000;
+}  // namespace
+
+class PageTableFastmemTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    SConfig::GetInstance().bMMU = true;
+    PowerPC::Init(PowerPC::CPUCore::Interpreter);
+    CoreTiming::Init();
+    for (ExpansionInterface::TEXIDevices& device : SConfig::GetInstance().m_EXIDevice)
+      device = ExpansionInterface::EXIDEVICE_NONE;
+    ExpansionInterface::Init();  // Needs to be initialized before Memory
+    Memory::Init();
+    ASSERT_TRUE(Memory::InitFastmemArena());
+
+    // No BAT is set up, so all data accesses are translated by the page table.
+    MSR.DR = 1;
+    PowerPC::ppcState.spr[SPR_SDR] = PAGE_TABLE_ADDRESS;
+    PowerPC::SDRUpdated();
+    PowerPC::ppcState.sr[SEGMENT] = VSID;
+  }
+
+  void TearDown() override
+  {
+    Memory::ShutdownFastmemArena();
+    Memory::Shutdown();
+    ExpansionInterface::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  // Returns the address of the first free PTE in the primary PTEG of the page.
+  static u32 GetPTEAddress(u32 logical_address)
+  {
+    const u32 page_index = (logical_address >> 12) & 0xffff;
+    const u32 hash = VSID ^ page_index;
+    u32 address = PAGE_TABLE_ADDRESS | ((hash & PAGE_TABLE_HASH_MASK) << 6);
+    while (Memory::Read_U32(address) & PTE1_V)
+      address += 8;
+    return address;
+  }
+
+  void AddPTE(u32 logical_address, u32 physical_address, u32 flags = 0)
+  {
+    const u32 address = GetPTEAddress(logical_address);
+    const u32 api = (logical_address >> 22) & 0x3f;
+    Memory::Write_U32(PTE1_V | (VSID << 7) | api, address);
+    Memory::Write_U32(physical_address | flags | PTE2_PP_READ_WRITE, address + 4);
+    m_pte_addresses[logical_address] = address;
+  }
+
+  u32 GetPTE2(u32 logical_address)
+  {
+    return Memory::Read_U32(m_pte_addresses[logical_address] + 4);
+  }
+
+  static u32 ReadFastmem(u32 logical_address)
+  {
+    u32 value;
+    std::memcpy(&value, Memory::logical_base + logical_address, sizeof(value));
+    return Common::swap32(value);
+  }
+
+  static void WriteFastmem(u32 value, u32 logical_address)
+  {
+    value = Common::swap32(value);
+    std::memcpy(Memory::logical_base + logical_address, &value, sizeof(value));
+  }
+
+  // Whether the host lets the page be written through the logical view. The kernel reports writes
+  // to a read-only page by read() as an error instead of raising a fault.
+  static bool IsWritable(u32 logical_address)
+  {
+    int fds[2];
+    if (pipe(fds) != 0)
+      return false;
+    const u8 byte = 0;
+    const bool written = write(fds[1], &byte, 1) == 1;
+    const bool writable = written && read(fds[0], Memory::logical_base + logical_address, 1) == 1;
+    EXPECT_TRUE(writable || errno == EFAULT);
+    close(fds[0]);
+    close(fds[1]);
+    return writable;
+  }
+
+  std::string m_profile_path;
+  std::map<u32, u32> m_pte_addresses;
+};
+
+TEST_F(PageTableFastmemTest, MapsTranslatedPage)
+{
+  AddPTE(PAGE_A, PHYSICAL_PAGE_A);
+  Memory::Write_U32(0x12345678, PHYSICAL_PAGE_A + 0x10);
+
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_A + 0x10, false));
+  EXPECT_EQ(0x12345678u, ReadFastmem(PAGE_A + 0x10));
+  EXPECT_EQ(PTE2_R, GetPTE2(PAGE_A) & (PTE2_R | PTE2_C));
+
+  // Another fault on a page which is mapped isn't caused by the page table, so it is left to
+  // the back patching.
+  EXPECT_FALSE(PowerPC::MapPageForFastmem(PAGE_A + 0x20, false));
+}
+
+TEST_F(PageTableFastmemTest, DoesNotMapUntranslatedPages)
+{
+  EXPECT_FALSE(PowerPC::MapPageForFastmem(PAGE_A, false));
+
+  AddPTE(PAGE_A, 0x0C000000);  // MMIO
+  EXPECT_FALSE(PowerPC::MapPageForFastmem(PAGE_A, false));
+
+  AddPTE(PAGE_B, PHYSICAL_PAGE_B);
+  MSR.DR = 0;
+  EXPECT_FALSE(PowerPC::MapPageForFastmem(PAGE_B, false));
+}
+
+TEST_F(PageTableFastmemTest, PageIsReadOnlyUntilChanged)
+{
+  AddPTE(PAGE_A, PHYSICAL_PAGE_A);
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_A, false));
+  EXPECT_FALSE(IsWritable(PAGE_A));
+
+  // Writes to the page fault until the C bit is set, then the page is made writable.
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_A, true));
+  EXPECT_EQ(PTE2_R | PTE2_C, GetPTE2(PAGE_A) & (PTE2_R | PTE2_C));
+  EXPECT_TRUE(IsWritable(PAGE_A));
+  EXPECT_FALSE(PowerPC::MapPageForFastmem(PAGE_A, true));
+
+  WriteFastmem(0xdeadbeef, PAGE_A + 0x40);
+  EXPECT_EQ(0xdeadbeefu, Memory::Read_U32(PHYSICAL_PAGE_A + 0x40));
+
+  // A page whose C bit is already set is writable right away.
+  AddPTE(PAGE_B, PHYSICAL_PAGE_B, PTE2_C);
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_B, false));
+  EXPECT_TRUE(IsWritable(PAGE_B));
+  EXPECT_FALSE(PowerPC::MapPageForFastmem(PAGE_B, true));
+}
+
+TEST_F(PageTableFastmemTest, ReplacedTLBEntryIsUnmapped)
+{
+  AddPTE(PAGE_A, PHYSICAL_PAGE_A);
+  AddPTE(PAGE_B, PHYSICAL_PAGE_B);
+  AddPTE(PAGE_C, PHYSICAL_PAGE_C);
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_A, false));
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_B, false));
+
+  // The translation of page C replaces the least recently used one, that of page A.
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_C, false));
+  EXPECT_FALSE(PowerPC::MapPageForFastmem(PAGE_B, false));
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_A, false));
+}
+
+TEST_F(PageTableFastmemTest, InvalidatedTLBEntryIsUnmapped)
+{
+  AddPTE(PAGE_A, PHYSICAL_PAGE_A);
+  AddPTE(PAGE_B, PHYSICAL_PAGE_B);
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_A, false));
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_B, false));
+
+  // tlbie invalidates both ways of the set.
+  PowerPC::InvalidateTLBEntry(PAGE_A);
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_A, false));
+  EXPECT_TRUE(PowerPC::MapPageForFastmem(PAGE_B, false));
+  EXPECT_FALSE(PowerPC::MapPageForFastmem(PAGE_A, false));
+}
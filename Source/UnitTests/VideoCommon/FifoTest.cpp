@@ -0,0 +1,170 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <string>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigLoaders/BaseConfigLoader.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+#include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/Fifo.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/PixelEngine.h"
+#include "VideoCommon/VideoConfig.h"
+
+constexpr u32 FIFO_BASE = 0x00100000;
+constexpr u32 FIFO_SIZE = 0x40000;
+
+class FifoTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    Config::AddLayer(ConfigLoaders::GenerateBaseConfigLoader());
+    SConfig::Init();
+    SConfig::GetInstance().bSyncGPU = false;
+    PowerPC::Init(PowerPC::CPUCore::Interpreter);
+    CoreTiming::Init();
+    for (ExpansionInterface::TEXIDevices& device : SConfig::GetInstance().m_EXIDevice)
+      device = ExpansionInterface::EXIDEVICE_NONE;
+    ExpansionInterface::Init();  // Needs to be initialized before Memory
+    Memory::Init();
+    CommandProcessor::Init();
+    PixelEngine::Init();
+    Fifo::Init();
+
+    // The FIFO is only read in place by the GPU thread, in dual core mode.
+    SConfig::GetInstance().bCPUThread = true;
+
+    m_saved_config = g_ActiveConfig;
+    g_ActiveConfig.bDirectFifoRead = true;
+
+    CommandProcessor::SCPFifoStruct& fifo = CommandProcessor::fifo;
+    fifo.CPBase = FIFO_BASE;
+    fifo.CPEnd = FIFO_BASE + FIFO_SIZE - 32;
+    fifo.CPReadPointer = FIFO_BASE;
+    fifo.CPHiWatermark = FIFO_SIZE - 0x4000;
+    fifo.CPLoWatermark = 0x4000;
+    fifo.bFF_GPReadEnable = 1;
+    Memory::Memset(FIFO_BASE, OpcodeDecoder::GX_NOP, FIFO_SIZE);
+  }
+
+  void TearDown() override
+  {
+    g_ActiveConfig = m_saved_config;
+
+    Fifo::Shutdown();
+    Memory::Shutdown();
+    ExpansionInterface::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  std::string m_profile_path;
+  VideoConfig m_saved_config;
+};
+
+TEST_F(FifoTest, ReadsUpToWritePointer)
+{
+  CommandProcessor::fifo.CPReadWriteDistance = 0x1000;
+
+  u32 cycles = 0;
+  EXPECT_EQ(0x1000u, Fifo::RunFifoDirect(&cycles));
+  // Every NOP takes 6 cycles.
+  EXPECT_EQ(0x1000u * 6, cycles);
+
+  // Nothing was left over in the video buffer, so the next read is in place again.
+  EXPECT_EQ(0x1000u, Fifo::RunFifoDirect(&cycles));
+}
+
+TEST_F(FifoTest, StopsAtEndOfFifo)
+{
+  CommandProcessor::fifo.CPReadPointer = CommandProcessor::fifo.CPEnd - 0x60;
+  CommandProcessor::fifo.CPReadWriteDistance = 0x1000;
+
+  u32 cycles = 0;
+  EXPECT_EQ(0x80u, Fifo::RunFifoDirect(&cycles));
+}
+
+TEST_F(FifoTest, ReadLengthIsLimited)
+{
+  CommandProcessor::fifo.CPReadWriteDistance = FIFO_SIZE - 0x1000;
+
+  u32 cycles = 0;
+  const u32 length = Fifo::RunFifoDirect(&cycles);
+  EXPECT_NE(0u, length);
+  EXPECT_LT(length, FIFO_SIZE - 0x1000);
+}
+
+TEST_F(FifoTest, StopsWhereHighWatermarkIsCleared)
+{
+  CommandProcessor::fifo.CPReadWriteDistance = CommandProcessor::fifo.CPHiWatermark + 0x820;
+  CommandProcessor::fifo.bFF_HiWatermarkInt = 1;
+
+  u32 cycles = 0;
+  EXPECT_EQ(0x820u, Fifo::RunFifoDirect(&cycles));
+}
+
+TEST_F(FifoTest, StopsWhenTokenIsPending)
+{
+  CommandProcessor::fifo.CPReadWriteDistance = 0x1000;
+  PixelEngine::SetToken(0x1234, false);
+  ASSERT_TRUE(PixelEngine::IsTokenFinishEventPending());
+
+  u32 cycles = 0;
+  EXPECT_EQ(32u, Fifo::RunFifoDirect(&cycles));
+}
+
+TEST_F(FifoTest, IncompleteCommandIsCompletedFromVideoBuffer)
+{
+  CommandProcessor::fifo.CPReadWriteDistance = 0x1000;
+  // A CP register load is 6 bytes long, so only half of it is before the write pointer.
+  Memory::Write_U8(OpcodeDecoder::GX_LOAD_CP_REG, FIFO_BASE + 0x1000 - 3);
+  Memory::Write_U8(0x50, FIFO_BASE + 0x1000 - 2);
+
+  u32 cycles = 0;
+  EXPECT_EQ(0x1000u, Fifo::RunFifoDirect(&cycles));
+
+  // The rest of the command has to be appended to the video buffer, 32 bytes at a time.
+  CommandProcessor::fifo.CPReadPointer += 0x1000;
+  EXPECT_EQ(0u, Fifo::RunFifoDirect(&cycles));
+}
+
+TEST_F(FifoTest, NotReadInPlaceWhenGPUActsOnEveryBlock)
+{
+  CommandProcessor::SCPFifoStruct& fifo = CommandProcessor::fifo;
+  fifo.CPReadWriteDistance = 0x1000;
+  u32 cycles = 0;
+
+  fifo.bFF_BPEnable = 1;
+  EXPECT_EQ(0u, Fifo::RunFifoDirect(&cycles));
+  fifo.bFF_BPEnable = 0;
+
+  fifo.bFF_LoWatermarkInt = 1;
+  EXPECT_EQ(0u, Fifo::RunFifoDirect(&cycles));
+  fifo.bFF_LoWatermarkInt = 0;
+
+  g_ActiveConfig.bDirectFifoRead = false;
+  EXPECT_EQ(0u, Fifo::RunFifoDirect(&cycles));
+  g_ActiveConfig.bDirectFifoRead = true;
+
+  fifo.CPReadWriteDistance = 32;
+  EXPECT_EQ(0u, Fifo::RunFifoDirect(&cycles));
+}
@@ -0,0 +1,442 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/CPUCull.h"
+#include "VideoCommon/IndexGenerator.h"
+#include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/VideoConfig.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace
+{
+constexpr u16 PRIMITIVE_RESTART = 0xFFFF;
+
+// Writes the indices one at a time, like IndexGenerator did before it wrote them in groups.
+class ReferenceIndices
+{
+public:
+  explicit ReferenceIndices(bool pr) : m_pr(pr) {}
+
+  void Add(int primitive, u32 num_verts)
+  {
+    switch (primitive)
+    {
+    case OpcodeDecoder::GX_DRAW_QUADS:
+    case OpcodeDecoder::GX_DRAW_QUADS_2:
+      AddQuads(num_verts);
+      break;
+    case OpcodeDecoder::GX_DRAW_TRIANGLES:
+      for (u32 i = 2; i < num_verts; i += 3)
+        Triangle(i - 2, i - 1, i);
+      break;
+    case OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP:
+      AddStrip(num_verts);
+      break;
+    case OpcodeDecoder::GX_DRAW_TRIANGLE_FAN:
+      AddFan(num_verts);
+      break;
+    case OpcodeDecoder::GX_DRAW_LINES:
+      for (u32 i = 1; i < num_verts; i += 2)
+        Indices({i - 1, i});
+      break;
+    case OpcodeDecoder::GX_DRAW_LINE_STRIP:
+      for (u32 i = 1; i < num_verts; ++i)
+        Indices({i - 1, i});
+      break;
+    case OpcodeDecoder::GX_DRAW_POINTS:
+      for (u32 i = 0; i < num_verts; ++i)
+        Indices({i});
+      break;
+    }
+    m_base += num_verts;
+  }
+
+  const std::vector<u16>& Get() const { return m_indices; }
+
+private:
+  void Indices(std::initializer_list<u32> vertices)
+  {
+    for (u32 vertex : vertices)
+      m_indices.push_back(static_cast<u16>(m_base + vertex));
+  }
+
+  void Restart() { m_indices.push_back(PRIMITIVE_RESTART); }
+
+  void Triangle(u32 a, u32 b, u32 c)
+  {
+    Indices({a, b, c});
+    if (m_pr)
+      Restart();
+  }
+
+  void AddStrip(u32 num_verts)
+  {
+    if (m_pr)
+    {
+      for (u32 i = 0; i < num_verts; ++i)
+        Indices({i});
+      Restart();
+      return;
+    }
+
+    for (u32 i = 2; i < num_verts; ++i)
+    {
+      if (i % 2 == 0)
+        Triangle(i - 2, i - 1, i);
+      else
+        Triangle(i - 2, i, i - 1);
+    }
+  }
+
+  void AddFan(u32 num_verts)
+  {
+    u32 i = 2;
+    if (m_pr)
+    {
+      for (; i + 3 <= num_verts; i += 3)
+      {
+        Indices({i - 1, i, 0, i + 1, i + 2});
+        Restart();
+      }
+      for (; i + 2 <= num_verts; i += 2)
+      {
+        Indices({i - 1, i, 0, i + 1});
+        Restart();
+      }
+    }
+    for (; i < num_verts; ++i)
+      Triangle(0, i - 1, i);
+  }
+
+  void AddQuads(u32 num_verts)
+  {
+    u32 i = 3;
+    for (; i < num_verts; i += 4)
+    {
+      if (m_pr)
+      {
+        Indices({i - 2, i - 1, i - 3, i});
+        Restart();
+      }
+      else
+      {
+        Triangle(i - 3, i - 2, i - 1);
+        Triangle(i - 3, i - 1, i);
+      }
+    }
+    if (i == num_verts)
+      Triangle(num_verts - 3, num_verts - 2, num_verts - 1);
+  }
+
+  std::vector<u16> m_indices;
+  u32 m_base = 0;
+  bool m_pr;
+};
+
+constexpr int PRIMITIVES[] = {
+    OpcodeDecoder::GX_DRAW_QUADS,         OpcodeDecoder::GX_DRAW_QUADS_2,
+    OpcodeDecoder::GX_DRAW_TRIANGLES,     OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP,
+    OpcodeDecoder::GX_DRAW_TRIANGLE_FAN,  OpcodeDecoder::GX_DRAW_LINES,
+    OpcodeDecoder::GX_DRAW_LINE_STRIP,    OpcodeDecoder::GX_DRAW_POINTS,
+};
+
+// The most any primitive needs, for the triangles of fans with a restart index after each one.
+constexpr u32 MAX_INDICES_PER_VERTEX = 4;
+
+constexpr int TRIANGLE_PRIMITIVES[] = {
+    OpcodeDecoder::GX_DRAW_QUADS,         OpcodeDecoder::GX_DRAW_QUADS_2,
+    OpcodeDecoder::GX_DRAW_TRIANGLES,     OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP,
+    OpcodeDecoder::GX_DRAW_TRIANGLE_FAN,
+};
+
+// The vertex indices of a triangle, rotated so that the smallest comes first, which keeps the
+// winding but doesn't depend on which vertex the triangle started with.
+using Triangle = std::array<u16, 3>;
+
+Triangle MakeTriangle(u16 a, u16 b, u16 c)
+{
+  if (b < a && b < c)
+    return {b, c, a};
+  if (c < a && c < b)
+    return {c, a, b};
+  return {a, b, c};
+}
+
+// Splits indices into the triangles the GPU would draw from them, sorted. Triangles which use the
+// same vertex twice are the padding of restarted strips, and are left out.
+std::vector<Triangle> GetTriangles(const u16* indices, size_t count, bool pr)
+{
+  std::vector<Triangle> triangles;
+  if (!pr)
+  {
+    for (size_t i = 0; i + 2 < count; i += 3)
+      triangles.push_back(MakeTriangle(indices[i], indices[i + 1], indices[i + 2]));
+  }
+  else
+  {
+    size_t strip_start = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (indices[i] == PRIMITIVE_RESTART)
+      {
+        strip_start = i + 1;
+        continue;
+      }
+      if (i < strip_start + 2)
+        continue;
+
+      const u16 a = indices[i - 2];
+      const u16 b = indices[i - 1];
+      const u16 c = indices[i];
+      if (a == b || b == c || a == c)
+        continue;
+      if ((i - strip_start) % 2 == 0)
+        triangles.push_back(MakeTriangle(a, b, c));
+      else
+        triangles.push_back(MakeTriangle(b, a, c));
+    }
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+// Whether the GPU draws a triangle, with the facing rules of the software renderer, for positions
+// which are already in clip space with w = 1.
+bool IsReferenceTriangleVisible(const std::array<float, 3>& v0, const std::array<float, 3>& v1,
+                                const std::array<float, 3>& v2, GenMode::CullMode cull_mode)
+{
+  for (int axis = 0; axis < 2; ++axis)
+  {
+    if ((v0[axis] > 1.0f && v1[axis] > 1.0f && v2[axis] > 1.0f) ||
+        (v0[axis] < -1.0f && v1[axis] < -1.0f && v2[axis] < -1.0f))
+    {
+      return false;
+    }
+  }
+
+  const float area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v2[0] - v0[0]) * (v1[1] - v0[1]);
+  // Zero-area triangles don't cover any pixels.
+  if (area == 0.0f)
+    return false;
+  if (cull_mode == GenMode::CULL_BACK)
+    return area < 0.0f;
+  if (cull_mode == GenMode::CULL_FRONT)
+    return area > 0.0f;
+  return true;
+}
+}  // Anonymous namespace
+
+class IndexGeneratorTest : public testing::TestWithParam<bool>
+{
+protected:
+  void SetUp() override
+  {
+    g_Config.backend_info.bSupportsPrimitiveRestart = GetParam();
+    m_generator.Init();
+  }
+
+  IndexGenerator m_generator;
+};
+
+TEST_P(IndexGeneratorTest, MatchesReference)
+{
+  for (int primitive : PRIMITIVES)
+  {
+    for (u32 num_verts = 0; num_verts <= 100; ++num_verts)
+    {
+      // Start from a few different vertices, so that every place in a group is at every offset.
+      for (u32 first_vertex : {0u, 1u, 7u, 65000u})
+      {
+        std::vector<u16> indices((first_vertex + num_verts) * MAX_INDICES_PER_VERTEX + 8);
+        m_generator.Start(indices.data());
+        m_generator.AddIndices(OpcodeDecoder::GX_DRAW_POINTS, first_vertex);
+        m_generator.AddIndices(primitive, num_verts);
+
+        ReferenceIndices reference(GetParam());
+        reference.Add(OpcodeDecoder::GX_DRAW_POINTS, first_vertex);
+        reference.Add(primitive, num_verts);
+
+        indices.resize(m_generator.GetIndexLen());
+        ASSERT_EQ(reference.Get(), indices)
+            << "primitive " << primitive << ", " << num_verts << " vertices from " << first_vertex;
+      }
+    }
+  }
+}
+
+// Remapped indices have to be the regular indices of the primitive with every vertex replaced.
+TEST_P(IndexGeneratorTest, RemappedIndices)
+{
+  for (int primitive : PRIMITIVES)
+  {
+    for (u32 num_verts = 0; num_verts <= 100; ++num_verts)
+    {
+      // Every third vertex repeats an earlier one.
+      std::vector<u16> remap(num_verts);
+      u32 num_unique = 0;
+      for (u32 i = 0; i < num_verts; ++i)
+        remap[i] = i % 3 == 2 ? remap[i / 2] : num_unique++;
+
+      constexpr u32 first_vertex = 7;
+      std::vector<u16> expected((first_vertex + num_verts) * MAX_INDICES_PER_VERTEX + 8);
+      m_generator.Start(expected.data());
+      m_generator.AddIndices(OpcodeDecoder::GX_DRAW_POINTS, first_vertex);
+      m_generator.AddIndices(primitive, num_verts);
+      expected.resize(m_generator.GetIndexLen());
+      for (u32 i = first_vertex; i < expected.size(); ++i)
+      {
+        if (expected[i] != PRIMITIVE_RESTART)
+          expected[i] = first_vertex + remap[expected[i] - first_vertex];
+      }
+
+      std::vector<u16> indices((first_vertex + num_verts) * MAX_INDICES_PER_VERTEX + 8);
+      m_generator.Start(indices.data());
+      m_generator.AddIndices(OpcodeDecoder::GX_DRAW_POINTS, first_vertex);
+      m_generator.AddRemappedIndices(primitive, num_verts, remap.data(), num_unique);
+      indices.resize(m_generator.GetIndexLen());
+
+      ASSERT_EQ(expected, indices) << "primitive " << primitive << ", " << num_verts << " vertices";
+      EXPECT_EQ(first_vertex + num_unique, m_generator.GetNumVerts());
+    }
+  }
+}
+
+// Generates the indices of a large batch of each kind of primitive over and over again.
+TEST_P(IndexGeneratorTest, Speed)
+{
+  constexpr u32 NUM_VERTS = 60000;
+  std::vector<u16> indices(NUM_VERTS * MAX_INDICES_PER_VERTEX);
+
+  for (int primitive : PRIMITIVES)
+  {
+    for (int round = 0; round < 200; ++round)
+    {
+      m_generator.Start(indices.data());
+      for (u32 i = 0; i < NUM_VERTS / 200; ++i)
+        m_generator.AddIndices(primitive, 200);
+      EXPECT_EQ(NUM_VERTS, m_generator.GetNumVerts());
+    }
+  }
+}
+
+// Culled indices have to draw exactly the triangles of the primitive which the GPU would draw.
+TEST_P(IndexGeneratorTest, CulledIndices)
+{
+  // Identity position matrix and orthographic projection, so positions are in clip space.
+  xfmem.projection.type = GX_ORTHOGRAPHIC;
+  xfmem.projection.rawProjection = {1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f};
+  std::fill(std::begin(xfmem.posMatrices), std::begin(xfmem.posMatrices) + 12, 0.0f);
+  xfmem.posMatrices[0] = xfmem.posMatrices[5] = xfmem.posMatrices[10] = 1.0f;
+  g_main_cp_state.matrix_index_a.PosNormalMtxIdx = 0;
+  g_ActiveConfig.bFreeLook = false;
+  g_ActiveConfig.bWireFrame = false;
+  g_ActiveConfig.stereo_mode = StereoMode::Off;
+
+  PortableVertexDeclaration vtx_decl = {};
+  vtx_decl.stride = sizeof(std::array<float, 3>);
+  vtx_decl.position = {VAR_FLOAT, 3, 0, true, false};
+
+  // Coordinates well away from the edges of the screen, so that the slack CPUCull allows for
+  // doesn't matter.
+  constexpr std::array<float, 8> COORDINATES = {-3.0f, -1.5f, -0.75f, -0.25f,
+                                                0.25f, 0.75f, 1.5f,   3.0f};
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<size_t> any_coordinate(0, COORDINATES.size() - 1);
+  std::uniform_int_distribution<int> percent(0, 99);
+
+  constexpr u32 first_vertex = 3;
+  u32 total_culled = 0;
+
+  for (GenMode::CullMode cull_mode : {GenMode::CULL_NONE, GenMode::CULL_BACK, GenMode::CULL_FRONT})
+  {
+    bpmem.genMode.cullmode = cull_mode;
+    for (int primitive : TRIANGLE_PRIMITIVES)
+    {
+      for (u32 num_verts = 0; num_verts <= 60; ++num_verts)
+      {
+        // Some vertices repeat the position of the previous one, for zero-area triangles.
+        std::vector<std::array<float, 3>> positions(num_verts);
+        for (u32 i = 0; i < num_verts; ++i)
+        {
+          if (i != 0 && percent(rng) < 10)
+            positions[i] = positions[i - 1];
+          else
+            positions[i] = {COORDINATES[any_coordinate(rng)], COORDINATES[any_coordinate(rng)], 0};
+        }
+
+        ReferenceIndices reference(false);
+        reference.Add(primitive, num_verts);
+        const std::vector<u16>& reference_indices = reference.Get();
+        std::vector<Triangle> expected;
+        for (size_t i = 0; i + 2 < reference_indices.size(); i += 3)
+        {
+          const u16 a = reference_indices[i];
+          const u16 b = reference_indices[i + 1];
+          const u16 c = reference_indices[i + 2];
+          if (IsReferenceTriangleVisible(positions[a], positions[b], positions[c], cull_mode))
+          {
+            expected.push_back(MakeTriangle(first_vertex + a, first_vertex + b, first_vertex + c));
+          }
+        }
+        std::sort(expected.begin(), expected.end());
+        const u32 num_triangles = static_cast<u32>(reference_indices.size() / 3);
+        const u32 expected_culled = num_triangles - static_cast<u32>(expected.size());
+
+        CPUCull cull;
+        ASSERT_TRUE(cull.TransformVertices(reinterpret_cast<const u8*>(positions.data()),
+                                           num_verts, vtx_decl));
+
+        std::vector<u16> unculled((first_vertex + num_verts) * MAX_INDICES_PER_VERTEX + 8);
+        m_generator.Start(unculled.data());
+        m_generator.AddIndices(OpcodeDecoder::GX_DRAW_POINTS, first_vertex);
+        m_generator.AddIndices(primitive, num_verts);
+        unculled.resize(m_generator.GetIndexLen());
+
+        std::vector<u16> indices((first_vertex + num_verts) * MAX_INDICES_PER_VERTEX + 8);
+        m_generator.Start(indices.data());
+        m_generator.AddIndices(OpcodeDecoder::GX_DRAW_POINTS, first_vertex);
+        const u32 num_culled = m_generator.AddCulledIndices(primitive, num_verts, cull);
+        indices.resize(m_generator.GetIndexLen());
+        EXPECT_EQ(first_vertex + num_verts, m_generator.GetNumVerts());
+
+        // The regular indices are kept when culling doesn't make them shorter, which can only
+        // happen with primitive restart, where strips and fans take fewer indices per triangle.
+        if (num_culled == 0)
+        {
+          ASSERT_EQ(unculled, indices) << "primitive " << primitive << ", " << num_verts
+                                       << " vertices, cull mode " << cull_mode;
+          if (!GetParam())
+          {
+            ASSERT_EQ(0u, expected_culled);
+          }
+          continue;
+        }
+
+        ASSERT_EQ(expected_culled, num_culled) << "primitive " << primitive << ", " << num_verts
+                                               << " vertices, cull mode " << cull_mode;
+        ASSERT_EQ(expected, GetTriangles(indices.data() + first_vertex,
+                                         indices.size() - first_vertex, GetParam()))
+            << "primitive " << primitive << ", " << num_verts << " vertices, cull mode "
+            << cull_mode;
+        total_culled += num_culled;
+      }
+    }
+  }
+
+  EXPECT_GT(total_culled, 0u);
+}
+
+INSTANTIATE_TEST_CASE_P(PrimitiveRestart, IndexGeneratorTest, testing::Bool());
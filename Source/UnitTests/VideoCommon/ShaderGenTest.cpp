@@ -0,0 +1,345 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/GeometryShaderGen.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/RenderState.h"
+#include "VideoCommon/TextureCacheBase.h"
+#include "VideoCommon/TextureConversionShader.h"
+#include "VideoCommon/TextureConverterShaderGen.h"
+#include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/UberShaderPixel.h"
+#include "VideoCommon/UberShaderVertex.h"
+#include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VertexShaderGen.h"
+#include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace
+{
+struct RecordedPipeline
+{
+  VertexShaderUid vs_uid;
+  PixelShaderUid ps_uid;
+  GeometryShaderUid gs_uid;
+  UberShader::VertexShaderUid uber_vs_uid;
+  UberShader::PixelShaderUid uber_ps_uid;
+};
+
+// Records the UIDs of the pipelines a game with random register state would draw with, as a
+// stand-in for the UID cache of a real game.
+std::vector<RecordedPipeline> RecordPipelines(u32 count)
+{
+  std::mt19937 rng(0x5AD3C0DE);
+  std::vector<RecordedPipeline> pipelines;
+
+  for (u32 i = 0; i < count; ++i)
+  {
+    u32* const bp_regs = reinterpret_cast<u32*>(&bpmem);
+    for (u32 address = 0; address < 0x100; ++address)
+      bp_regs[address] = rng() & 0xFFFFFF;
+    bpmem.genMode.numindstages = bpmem.genMode.numindstages % 5;
+    for (TevStageIndirect& tevind : bpmem.tevind)
+    {
+      // Matrix 0 doesn't exist for any of the three kinds of indirect matrices, and there are
+      // only 7 wrapping modes.
+      if (tevind.mid % 4 == 0)
+        tevind.mid = 0;
+      tevind.sw = tevind.sw % 7;
+      tevind.tw = tevind.tw % 7;
+    }
+
+    bpmem.genMode.numtexgens = rng() % 9;
+    bpmem.genMode.numcolchans = rng() % 3;
+    xfmem.numTexGen.numTexGens = bpmem.genMode.numtexgens;
+    xfmem.numChan.numColorChans = bpmem.genMode.numcolchans;
+    xfmem.dualTexTrans.enabled = rng() & 1;
+    for (u32 chan = 0; chan < 2; ++chan)
+    {
+      xfmem.color[chan].hex = rng() & 0x7FFF;
+      xfmem.color[chan].diffusefunc = xfmem.color[chan].diffusefunc % 3;
+      xfmem.alpha[chan].hex = rng() & 0x7FFF;
+      xfmem.alpha[chan].diffusefunc = xfmem.alpha[chan].diffusefunc % 3;
+    }
+    for (u32 texgen = 0; texgen < 8; ++texgen)
+    {
+      xfmem.texMtxInfo[texgen].hex = rng();
+      xfmem.texMtxInfo[texgen].sourcerow = rng() % (XF_SRCTEX7_INROW + 1);
+      xfmem.texMtxInfo[texgen].texgentype = rng() % (XF_TEXGEN_COLOR_STRGBC1 + 1);
+      if (xfmem.texMtxInfo[texgen].sourcerow == XF_SRCCOLORS_INROW)
+        xfmem.texMtxInfo[texgen].texgentype = XF_TEXGEN_COLOR_STRGBC0;
+      xfmem.postMtxInfo[texgen].hex = rng();
+    }
+    VertexLoaderManager::g_current_components = rng() & ((1 << 23) - 1);
+
+    const PrimitiveType primitive_type = static_cast<PrimitiveType>(rng() % 4);
+    pipelines.push_back({GetVertexShaderUid(), GetPixelShaderUid(),
+                         GetGeometryShaderUid(primitive_type), UberShader::GetVertexShaderUid(),
+                         UberShader::GetPixelShaderUid()});
+  }
+
+  return pipelines;
+}
+
+size_t GenerateShaders(APIType api_type, const ShaderHostConfig& host_config,
+                       const RecordedPipeline& pipeline)
+{
+  return GenerateVertexShaderCode(api_type, host_config, pipeline.vs_uid.GetUidData())
+             .GetBuffer()
+             .size() +
+         GeneratePixelShaderCode(api_type, host_config, pipeline.ps_uid.GetUidData())
+             .GetBuffer()
+             .size() +
+         GenerateGeometryShaderCode(api_type, host_config, pipeline.gs_uid.GetUidData())
+             .GetBuffer()
+             .size() +
+         UberShader::GenVertexShader(api_type, host_config, pipeline.uber_vs_uid.GetUidData())
+             .GetBuffer()
+             .size() +
+         UberShader::GenPixelShader(api_type, host_config, pipeline.uber_ps_uid.GetUidData())
+             .GetBuffer()
+             .size();
+}
+
+// FNV-1a, so that the reference hashes below don't depend on the host.
+u64 HashSource(u64 hash, std::string_view source)
+{
+  for (const char c : source)
+    hash = (hash ^ static_cast<u8>(c)) * 0x100000001B3;
+  return hash;
+}
+
+u64 HashPipelineShaders(u64 hash, APIType api_type, const ShaderHostConfig& host_config,
+                        const RecordedPipeline& pipeline)
+{
+  const std::array<ShaderCode, 5> sources{
+      GenerateVertexShaderCode(api_type, host_config, pipeline.vs_uid.GetUidData()),
+      GeneratePixelShaderCode(api_type, host_config, pipeline.ps_uid.GetUidData()),
+      GenerateGeometryShaderCode(api_type, host_config, pipeline.gs_uid.GetUidData()),
+      UberShader::GenVertexShader(api_type, host_config, pipeline.uber_vs_uid.GetUidData()),
+      UberShader::GenPixelShader(api_type, host_config, pipeline.uber_ps_uid.GetUidData())};
+  for (const ShaderCode& source : sources)
+    hash = HashSource(hash, source.GetBuffer());
+  return hash;
+}
+
+constexpr std::array<EFBCopyFormat, 14> s_copy_formats{
+    EFBCopyFormat::R4, EFBCopyFormat::R8_0x1, EFBCopyFormat::RA4, EFBCopyFormat::RA8,
+    EFBCopyFormat::RGB565, EFBCopyFormat::RGB5A3, EFBCopyFormat::RGBA8, EFBCopyFormat::A8,
+    EFBCopyFormat::R8, EFBCopyFormat::G8, EFBCopyFormat::B8, EFBCopyFormat::RG8, EFBCopyFormat::GB8,
+    EFBCopyFormat::XFB};
+
+constexpr std::array<TLUTFormat, 3> s_tlut_formats{TLUTFormat::IA8, TLUTFormat::RGB565,
+                                                   TLUTFormat::RGB5A3};
+
+// Hashes the EFB copy, texture decoding and palette conversion shaders of every format.
+u64 HashTextureConversionShaders(u64 hash, APIType api_type)
+{
+  for (const EFBCopyFormat copy_format : s_copy_formats)
+  {
+    for (const PEControl::PixelFormat efb_format :
+         {PEControl::RGB8_Z24, PEControl::RGBA6_Z24, PEControl::RGB565_Z16, PEControl::Z24})
+    {
+      for (u32 flags = 0; flags < 4; ++flags)
+      {
+        const EFBCopyParams params(efb_format, copy_format, efb_format == PEControl::Z24,
+                                   (flags & 1) != 0, (flags & 2) != 0);
+        hash = HashSource(hash, TextureConversionShaderTiled::GenerateEncodingShader(params,
+                                                                                     api_type));
+      }
+    }
+
+    for (u32 flags = 0; flags < 32; ++flags)
+    {
+      TextureConversionShaderGen::TCShaderUid uid = TextureConversionShaderGen::GetShaderUid(
+          copy_format, (flags & 1) != 0, (flags & 2) != 0, (flags & 4) != 0, (flags & 8) != 0);
+      uid.GetUidData()->efb_has_alpha = (flags & 16) != 0;
+      hash = HashSource(
+          hash, TextureConversionShaderGen::GeneratePixelShader(api_type, uid.GetUidData())
+                    .GetBuffer());
+    }
+  }
+  hash = HashSource(hash, TextureConversionShaderGen::GenerateVertexShader(api_type).GetBuffer());
+
+  for (const TLUTFormat tlut_format : s_tlut_formats)
+  {
+    for (u32 format = 0; format <= static_cast<u32>(TextureFormat::XFB); ++format)
+    {
+      if (TextureConversionShaderTiled::GetDecodingShaderInfo(static_cast<TextureFormat>(format)))
+      {
+        hash = HashSource(hash, TextureConversionShaderTiled::GenerateDecodingShader(
+                                    static_cast<TextureFormat>(format), tlut_format, api_type));
+      }
+    }
+    hash = HashSource(
+        hash, TextureConversionShaderTiled::GeneratePaletteConversionShader(tlut_format, api_type));
+  }
+
+  return hash;
+}
+
+ShaderHostConfig GetFullFeaturedHostConfig()
+{
+  ShaderHostConfig host_config = {};
+  host_config.backend_dual_source_blend = true;
+  host_config.backend_geometry_shaders = true;
+  host_config.backend_early_z = true;
+  host_config.backend_clip_control = true;
+  host_config.backend_bitfield = true;
+  host_config.backend_dynamic_sampler_indexing = true;
+  host_config.backend_logic_op = true;
+  return host_config;
+}
+
+struct HostConfigCase
+{
+  const char* name;
+  ShaderHostConfig host_config;
+};
+
+std::vector<HostConfigCase> GetHostConfigCases()
+{
+  std::vector<HostConfigCase> cases;
+  cases.push_back({"full featured", GetFullFeaturedHostConfig()});
+
+  // A backend that supports none of the optional features.
+  cases.push_back({"no optional features", {}});
+
+  ShaderHostConfig host_config = GetFullFeaturedHostConfig();
+  host_config.per_pixel_lighting = true;
+  cases.push_back({"per-pixel lighting", host_config});
+
+  host_config = GetFullFeaturedHostConfig();
+  host_config.stereo = true;
+  cases.push_back({"stereo", host_config});
+  host_config.backend_gs_instancing = true;
+  cases.push_back({"stereo with instancing", host_config});
+
+  host_config = GetFullFeaturedHostConfig();
+  host_config.msaa = true;
+  cases.push_back({"MSAA", host_config});
+  host_config.ssaa = true;
+  host_config.backend_ssaa = true;
+  cases.push_back({"SSAA", host_config});
+
+  host_config = GetFullFeaturedHostConfig();
+  host_config.wireframe = true;
+  host_config.vertex_rounding = true;
+  host_config.fast_depth_calc = true;
+  host_config.bounding_box = true;
+  host_config.backend_bbox = true;
+  host_config.backend_atomics = true;
+  host_config.backend_depth_clamp = true;
+  host_config.backend_reversed_depth_range = true;
+  host_config.backend_shader_framebuffer_fetch = true;
+  host_config.backend_palette_conversion = true;
+  cases.push_back({"remaining features", host_config});
+
+  host_config = {};
+  host_config.backend_shader_framebuffer_fetch = true;
+  cases.push_back({"framebuffer fetch only", host_config});
+
+  return cases;
+}
+}  // Anonymous namespace
+
+// Generates the shaders of a corpus of pipelines for each API, which is the work done when the
+// shader cache is cold.
+TEST(ShaderGen, PipelineCorpusSpeed)
+{
+  const std::vector<RecordedPipeline> pipelines = RecordPipelines(200);
+  const ShaderHostConfig host_config = GetFullFeaturedHostConfig();
+
+  for (APIType api_type : {APIType::OpenGL, APIType::D3D, APIType::Vulkan})
+  {
+    for (int round = 0; round < 5; ++round)
+    {
+      for (const RecordedPipeline& pipeline : pipelines)
+        EXPECT_NE(0u, GenerateShaders(api_type, host_config, pipeline));
+    }
+  }
+}
+
+// Hashes of the sources generated for the corpus by the printf-based generators that were replaced
+// by fmt, for each host config and API. The fmt conversion must not change a single byte.
+TEST(ShaderGen, GeneratedSourcesMatchReference)
+{
+  struct ReferenceHashes
+  {
+    u64 pipelines;
+    u64 texture_conversion;
+  };
+  static constexpr std::array<std::array<ReferenceHashes, 3>, 9> reference_hashes{{
+      {{{0x2B66145FB038E575, 0x991772C70E2C2637},
+        {0xE5DB31DDEBB181E7, 0x32354A2F92D6C484},
+        {0x0E2A7339CCA7B346, 0xE15DA491D398F696}}},  // full featured
+      {{{0xBF84951D3F0C9D4A, 0xBBB932015F982E05},
+        {0x17232143AAA1D7A5, 0x32354A2F92D6C484},
+        {0x590B48A08B0563CB, 0xFFF0FF73D609DD38}}},  // no optional features
+      {{{0xE1DAE7B233EEC769, 0x991772C70E2C2637},
+        {0xBF2B14BC872552AF, 0x32354A2F92D6C484},
+        {0x32EB0CFA0274E7A8, 0xE15DA491D398F696}}},  // per-pixel lighting
+      {{{0x1FB5DC92B0DECC6C, 0x1C69D032688F2947},
+        {0x2F1C921065C51438, 0x588851CB92178734},
+        {0x5ECB0D7A18C4665F, 0x799B41CD71C724B6}}},  // stereo
+      {{{0x7F3A15D4DC986AC7, 0x1C69D032688F2947},
+        {0xD527A7326C4AF629, 0x588851CB92178734},
+        {0xAF2E8FA41AA4B7E6, 0x799B41CD71C724B6}}},  // stereo with instancing
+      {{{0xF1C569AC8AAD6A1D, 0x991772C70E2C2637},
+        {0xF2BE8A0B2173E72B, 0x32354A2F92D6C484},
+        {0xCA42F3695E76C9E4, 0xE15DA491D398F696}}},  // MSAA
+      {{{0x3602020D4A1CFCA1, 0x991772C70E2C2637},
+        {0xE6AC43CFE6780E37, 0x32354A2F92D6C484},
+        {0xB96B218CE1F0E1DC, 0xE15DA491D398F696}}},  // SSAA
+      {{{0x964F929174AA460A, 0xD91E6164E057844B},
+        {0x6B34F7C00958E88C, 0xBA15AA240536C8AC},
+        {0xD5E1C088404B3B5D, 0x8A6729DDC975115E}}},  // remaining features
+      {{{0xCFA7A09431BD2C6C, 0xBBB932015F982E05},
+        {0xFB80DD436216EF3B, 0x32354A2F92D6C484},
+        {0xFFEE027DD173713B, 0xFFF0FF73D609DD38}}},  // framebuffer fetch only
+  }};
+
+  const VideoConfig saved_config = g_ActiveConfig;
+  const std::vector<RecordedPipeline> pipelines = RecordPipelines(200);
+  const std::vector<HostConfigCase> host_config_cases = GetHostConfigCases();
+  ASSERT_EQ(reference_hashes.size(), host_config_cases.size());
+
+  for (size_t i = 0; i < host_config_cases.size(); ++i)
+  {
+    const ShaderHostConfig& host_config = host_config_cases[i].host_config;
+
+    // The texture conversion shaders read the backend features from the active config.
+    g_ActiveConfig.backend_info.bSupportsGeometryShaders = host_config.backend_geometry_shaders;
+    g_ActiveConfig.backend_info.bSupportsReversedDepthRange =
+        host_config.backend_reversed_depth_range;
+    g_ActiveConfig.bStereoEFBMonoDepth = host_config.stereo;
+
+    const std::array<APIType, 3> api_types{APIType::OpenGL, APIType::D3D, APIType::Vulkan};
+    for (size_t j = 0; j < api_types.size(); ++j)
+    {
+      u64 pipelines_hash = 0xCBF29CE484222325;
+      for (const RecordedPipeline& pipeline : pipelines)
+        pipelines_hash = HashPipelineShaders(pipelines_hash, api_types[j], host_config, pipeline);
+      const u64 texture_conversion_hash =
+          HashTextureConversionShaders(0xCBF29CE484222325, api_types[j]);
+
+      EXPECT_EQ(reference_hashes[i][j].pipelines, pipelines_hash)
+          << host_config_cases[i].name << ", API " << static_cast<int>(api_types[j]);
+      EXPECT_EQ(reference_hashes[i][j].texture_conversion, texture_conversion_hash)
+          << host_config_cases[i].name << ", API " << static_cast<int>(api_types[j]);
+    }
+  }
+
+  g_ActiveConfig = saved_config;
+}
@@ -0,0 +1,88 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <random>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/BPStructs.h"
+#include "VideoCommon/GeometryShaderGen.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/VertexShaderGen.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace
+{
+void RandomizeBPMemory(std::mt19937& rng)
+{
+  u32* const regs = reinterpret_cast<u32*>(&bpmem);
+  for (u32 address = 0; address < 0x100; ++address)
+    regs[address] = rng() & 0xFFFFFF;
+
+  // The UIDs only have room for the indirect stages the hardware supports, and the XF unit has to
+  // agree with the BP unit about the number of texgens and color channels.
+  bpmem.genMode.numindstages = bpmem.genMode.numindstages % 5;
+  bpmem.genMode.numtexgens = bpmem.genMode.numtexgens % 9;
+  bpmem.genMode.numcolchans = bpmem.genMode.numcolchans % 3;
+  xfmem.numTexGen.numTexGens = bpmem.genMode.numtexgens;
+  xfmem.numChan.numColorChans = bpmem.genMode.numcolchans;
+}
+}  // Anonymous namespace
+
+// The vertex manager only regenerates the pixel shader UID after writes to the registers listed
+// by BPRegisterAffectsPixelShaderUid, so writes to any other register must not change it.
+TEST(ShaderUid, PixelShaderUidOnlyDependsOnFlaggedRegisters)
+{
+  std::mt19937 rng(0x5EED);
+  u32* const regs = reinterpret_cast<u32*>(&bpmem);
+
+  for (int round = 0; round < 16; ++round)
+  {
+    RandomizeBPMemory(rng);
+    const PixelShaderUid ps_uid = GetPixelShaderUid();
+    const VertexShaderUid vs_uid = GetVertexShaderUid();
+
+    for (u32 address = 0; address < 0x100; ++address)
+    {
+      if (BPRegisterAffectsPixelShaderUid(address))
+        continue;
+
+      const u32 old_value = regs[address];
+      regs[address] = rng() & 0xFFFFFF;
+      EXPECT_TRUE(GetPixelShaderUid() == ps_uid) << "BP register " << address;
+      // GenMode is the only BP register the vertex shader UID depends on, and is flagged.
+      EXPECT_TRUE(GetVertexShaderUid() == vs_uid) << "BP register " << address;
+      regs[address] = old_value;
+    }
+  }
+}
+
+// Generates all three UIDs over and over again, like every draw call did before the UIDs were
+// only updated after register writes.
+TEST(ShaderUid, UidGenerationSpeed)
+{
+  std::mt19937 rng(0x5EED);
+  RandomizeBPMemory(rng);
+  bpmem.genMode.numtevstages = 15;
+  bpmem.genMode.numtexgens = 8;
+  xfmem.numTexGen.numTexGens = 8;
+
+  u32 changes = 0;
+  VertexShaderUid vs_uid = GetVertexShaderUid();
+  PixelShaderUid ps_uid = GetPixelShaderUid();
+  GeometryShaderUid gs_uid = GetGeometryShaderUid(PrimitiveType::Triangles);
+  for (int i = 0; i < 100000; ++i)
+  {
+    const VertexShaderUid new_vs_uid = GetVertexShaderUid();
+    const PixelShaderUid new_ps_uid = GetPixelShaderUid();
+    const GeometryShaderUid new_gs_uid = GetGeometryShaderUid(PrimitiveType::Triangles);
+    changes += new_vs_uid != vs_uid || new_ps_uid != ps_uid || new_gs_uid != gs_uid;
+    vs_uid = new_vs_uid;
+    ps_uid = new_ps_uid;
+    gs_uid = new_gs_uid;
+  }
+  EXPECT_EQ(0u, changes);
+}
@@ -0,0 +1,213 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+enum class InstructionSet
+{
+  Generic,
+  SSSE3,
+  AVX2,
+};
+
+// Restricts the decoders to a given instruction set for the lifetime of the object.
+class ScopedInstructionSet
+{
+public:
+  explicit ScopedInstructionSet(InstructionSet set) : m_saved(cpu_info)
+  {
+    if (set < InstructionSet::AVX2)
+      cpu_info.bAVX2 = false;
+    if (set < InstructionSet::SSSE3)
+      cpu_info.bSSSE3 = false;
+  }
+  ~ScopedInstructionSet() { cpu_info = m_saved; }
+
+private:
+  CPUInfo m_saved;
+};
+
+static bool IsSupported(InstructionSet set)
+{
+  switch (set)
+  {
+  case InstructionSet::AVX2:
+    return cpu_info.bAVX2;
+  case InstructionSet::SSSE3:
+    return cpu_info.bSSSE3;
+  default:
+    return true;
+  }
+}
+
+// Big enough for a 256x256 RGBA8 texture. The data is made of two shuffled runs of every possible
+// big-endian 16-bit value, so that 16-bit formats see each texel value exactly once.
+static std::vector<u8> MakeSourceData()
+{
+  std::mt19937 rng(0x7E87E4);
+  std::vector<u8> data;
+  for (int run = 0; run < 2; run++)
+  {
+    std::vector<u16> values(0x10000);
+    std::iota(values.begin(), values.end(), 0);
+    std::shuffle(values.begin(), values.end(), rng);
+    for (u16 value : values)
+    {
+      data.push_back(static_cast<u8>(value >> 8));
+      data.push_back(static_cast<u8>(value));
+    }
+  }
+  return data;
+}
+
+// A full-size C14X2 palette. Some slack is left at the end, as TMEM would have.
+static std::vector<u8> MakePalette()
+{
+  std::mt19937 rng(0x7107);
+  std::uniform_int_distribution<int> dist(0, 0xFF);
+  std::vector<u8> palette(0x4000 * sizeof(u16) + 16);
+  std::generate(palette.begin(), palette.end(), [&] { return static_cast<u8>(dist(rng)); });
+  return palette;
+}
+
+using TextureDecoderParams = std::tuple<TextureFormat, TLUTFormat, int, int, InstructionSet>;
+
+class TextureDecoderTest : public testing::TestWithParam<TextureDecoderParams>
+{
+protected:
+  void SetUp() override
+  {
+    std::tie(m_format, m_tlut_format, m_width, m_height, m_instruction_set) = GetParam();
+    m_src = MakeSourceData();
+    m_tlut = MakePalette();
+  }
+
+  TextureFormat m_format;
+  TLUTFormat m_tlut_format;
+  int m_width;
+  int m_height;
+  InstructionSet m_instruction_set;
+  std::vector<u8> m_src;
+  std::vector<u8> m_tlut;
+};
+
+TEST_P(TextureDecoderTest, MatchesTexelDecoder)
+{
+  if (!IsSupported(m_instruction_set))
+    return;
+
+  ASSERT_LE(static_cast<size_t>(TexDecoder_GetTextureSizeInBytes(m_width, m_height, m_format)),
+            m_src.size());
+
+  std::vector<u32> decoded(m_width * m_height);
+  {
+    ScopedInstructionSet set(m_instruction_set);
+    TexDecoder_Decode(reinterpret_cast<u8*>(decoded.data()), m_src.data(), m_width, m_height,
+                      m_format, m_tlut.data(), m_tlut_format);
+  }
+
+  // The texel decoder is the plain C reference used by the software renderer.
+  for (int y = 0; y < m_height; y++)
+  {
+    for (int x = 0; x < m_width; x++)
+    {
+      u32 expected;
+      TexDecoder_DecodeTexel(reinterpret_cast<u8*>(&expected), m_src.data(), x, y, m_width - 1,
+                             m_format, m_tlut.data(), m_tlut_format);
+      ASSERT_EQ(expected, decoded[y * m_width + x]) << "at (" << x << ", " << y << ")";
+    }
+  }
+}
+
+static auto AllInstructionSets()
+{
+  return testing::Values(InstructionSet::Generic, InstructionSet::SSSE3, InstructionSet::AVX2);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    DirectFormats, TextureDecoderTest,
+    testing::Combine(testing::Values(TextureFormat::I4, TextureFormat::I8, TextureFormat::IA4,
+                                     TextureFormat::IA8, TextureFormat::RGB565,
+                                     TextureFormat::RGB5A3, TextureFormat::RGBA8,
+                                     TextureFormat::CMPR),
+                     testing::Values(TLUTFormat::IA8),
+                     testing::Values(8, 24, 256), testing::Values(8, 256), AllInstructionSets()));
+
+INSTANTIATE_TEST_CASE_P(
+    PaletteFormats, TextureDecoderTest,
+    testing::Combine(testing::Values(TextureFormat::C4, TextureFormat::C8, TextureFormat::C14X2),
+                     testing::Values(TLUTFormat::IA8, TLUTFormat::RGB565, TLUTFormat::RGB5A3),
+                     testing::Values(8, 24, 256), testing::Values(8, 256), AllInstructionSets()));
+
+TEST(TextureDecoderRGBA8FromTmem, MatchesTexelDecoder)
+{
+  const std::vector<u8> src = MakeSourceData();
+  const u8* src_ar = src.data();
+  const u8* src_gb = src.data() + src.size() / 2;
+
+  for (const auto& [width, height] : {std::pair(8, 8), std::pair(6, 10), std::pair(256, 128)})
+  {
+    std::vector<u32> decoded(width * height);
+    TexDecoder_DecodeRGBA8FromTmem(reinterpret_cast<u8*>(decoded.data()), src_ar, src_gb, width,
+                                   height);
+
+    for (int y = 0; y < height; y++)
+    {
+      for (int x = 0; x < width; x++)
+      {
+        u32 expected;
+        TexDecoder_DecodeTexelRGBA8FromTmem(reinterpret_cast<u8*>(&expected), src_ar, src_gb, x, y,
+                                            width - 1);
+        ASSERT_EQ(expected, decoded[y * width + x]) << "at (" << x << ", " << y << ")";
+      }
+    }
+  }
+}
+
+class TextureDecoderSpeedTest
+    : public testing::TestWithParam<std::tuple<TextureFormat, InstructionSet>>
+{
+};
+
+TEST_P(TextureDecoderSpeedTest, Decode1024x1024)
+{
+  const auto [format, instruction_set] = GetParam();
+  if (!IsSupported(instruction_set))
+    return;
+
+  constexpr int size = 1024;
+  std::vector<u8> src(TexDecoder_GetTextureSizeInBytes(size, size, format));
+  const std::vector<u8> source_data = MakeSourceData();
+  for (size_t i = 0; i < src.size(); i += source_data.size())
+    std::copy_n(source_data.begin(), std::min(source_data.size(), src.size() - i), &src[i]);
+  const std::vector<u8> tlut = MakePalette();
+  std::vector<u32> dst(size * size);
+
+  ScopedInstructionSet set(instruction_set);
+  for (int i = 0; i < 10; i++)
+  {
+    TexDecoder_Decode(reinterpret_cast<u8*>(dst.data()), src.data(), size, size, format,
+                      tlut.data(), TLUTFormat::RGB5A3);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(AllFormats, TextureDecoderSpeedTest,
+                        testing::Combine(testing::Values(TextureFormat::I4, TextureFormat::I8,
+                                                         TextureFormat::IA4, TextureFormat::IA8,
+                                                         TextureFormat::RGB565,
+                                                         TextureFormat::RGB5A3,
+                                                         TextureFormat::RGBA8, TextureFormat::C4,
+                                                         TextureFormat::C8, TextureFormat::C14X2,
+                                                         TextureFormat::CMPR),
+                                         AllInstructionSets()));
@@ -12,6 +12,7 @@
 
 #include "Common/BitUtils.h"
 #include "Common/Common.h"
+#include "Common/Swap.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/OpcodeDecoding.h"
@@ -354,3 +355,88 @@ TEST_F(VertexLoaderTest, LargeFloatVertexSpeed)
   for (int i = 0; i < 100; ++i)
     RunVertices(100000);
 }
+
+class VertexLoaderParallelTest : public VertexLoaderTest,
+                                 public ::testing::WithParamInterface<u32>
+{
+protected:
+  void SetUp() override
+  {
+    VertexLoaderTest::SetUp();
+    VertexLoaderBase::SetWorkerThreads(GetParam());
+  }
+
+  void TearDown() override { VertexLoaderBase::SetWorkerThreads(0); }
+};
+INSTANTIATE_TEST_CASE_P(WorkerThreads, VertexLoaderParallelTest,
+                        ::testing::Values(0u, 1u, 2u, 3u, 7u));
+
+TEST_P(VertexLoaderParallelTest, SkippedVertices)
+{
+  m_vtx_desc.Position = INDEX16;
+  m_vtx_attr.g0.PosElements = 1;  // XYZ
+  m_vtx_attr.g0.PosFormat = FORMAT_FLOAT;
+  m_vtx_desc.Color0 = DIRECT;
+  m_vtx_attr.g0.Color0Comp = FORMAT_32B_8888;
+  CreateAndCheckSizes(sizeof(u16) + sizeof(u32), 3 * sizeof(float) + sizeof(u32));
+
+  // Skip vertices at and around the chunk boundaries of every number of workers, as well as the
+  // very first and last ones.
+  constexpr int count = 20000;
+  const auto skipped = [](int i) {
+    return i == 0 || i == count - 1 || i % 2500 == 0 || i % 2500 == 1 || i % 3333 == 7 ||
+           i % 5000 == 4999 || i % 777 == 5;
+  };
+  int expected_count = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    Input<u16>(skipped(i) ? 0xFFFF : static_cast<u16>(i));
+    Input<u32>(i);
+    expected_count += !skipped(i);
+  }
+  VertexLoaderManager::cached_arraybases[ARRAY_POSITION] = m_src.GetPointer();
+  g_main_cp_state.array_strides[ARRAY_POSITION] = 3 * sizeof(float);
+  for (int i = 0; i < count; ++i)
+  {
+    Input(static_cast<float>(i));
+    Input(static_cast<float>(i) + 0.25f);
+    Input(static_cast<float>(i) + 0.5f);
+  }
+
+  RunVertices(count, expected_count);
+  for (int i = 0; i < count; ++i)
+  {
+    if (skipped(i))
+      continue;
+    ExpectOut(static_cast<float>(i));
+    ExpectOut(static_cast<float>(i) + 0.25f);
+    ExpectOut(static_cast<float>(i) + 0.5f);
+    const u32 color = m_dst.Read<u32, false>();
+    ASSERT_EQ(Common::swap32(i), color) << "vertex " << i;
+  }
+
+  // The zfreeze state comes from the last vertices of the batch.
+  EXPECT_EQ(static_cast<float>(count - 2), VertexLoaderManager::position_cache[1][0]);
+  EXPECT_EQ(static_cast<float>(count - 3), VertexLoaderManager::position_cache[2][0]);
+}
+
+// Loads large batches of vertices with a typical format, to show how splitting them across more
+// threads scales.
+TEST_P(VertexLoaderParallelTest, LargeBatchSpeed)
+{
+  m_vtx_desc.Position = DIRECT;
+  m_vtx_attr.g0.PosElements = 1;  // XYZ
+  m_vtx_attr.g0.PosFormat = FORMAT_FLOAT;
+  m_vtx_desc.Normal = DIRECT;
+  m_vtx_attr.g0.NormalFormat = FORMAT_SHORT;
+  m_vtx_desc.Color0 = DIRECT;
+  m_vtx_attr.g0.Color0Comp = FORMAT_32B_8888;
+  m_vtx_desc.Tex0Coord = DIRECT;
+  m_vtx_attr.g0.Tex0CoordElements = 1;  // ST
+  m_vtx_attr.g0.Tex0CoordFormat = FORMAT_SHORT;
+  CreateAndCheckSizes(3 * sizeof(float) + 3 * sizeof(s16) + sizeof(u32) + 2 * sizeof(s16),
+                      3 * sizeof(float) + 3 * sizeof(float) + sizeof(u32) + 2 * sizeof(float));
+
+  for (int i = 0; i < 1000; ++i)
+    RunVertices(65536);
+}
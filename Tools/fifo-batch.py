@@ -0,0 +1,113 @@
+#! /usr/bin/env python3
+
+"""
+fifo-batch.py [options] <dolphin-emu-nogui> <fifo log...>
+
+Replays FIFO logs with dolphin-emu-nogui --fifo-batch, several at a time, and
+reports the frame rate of each replay.
+
+Each log gets its own user folder under the output folder, so replays don't
+share any state. With --dump-frames=hashes, the frame hashes of each log are
+left in <output>/<log name>/Dump/Frames/framehashes.txt. If --reference points
+to the output folder of an earlier run, the hashes are compared to it and the
+first differing frame of each log is reported.
+
+Example:
+
+$ Tools/fifo-batch.py -j 4 -b Software --dump-frames=hashes \\
+    -o /tmp/fifo-new -r /tmp/fifo-old build/Binaries/dolphin-emu-nogui logs/*.dff
+"""
+
+import argparse
+import concurrent.futures
+import os
+import re
+import subprocess
+import sys
+
+HASHES_PATH = os.path.join('Dump', 'Frames', 'framehashes.txt')
+FPS_RE = re.compile(r'Presented (\d+) frames in ([\d.]+) seconds \(([\d.]+) FPS\)')
+
+
+def log_name(path):
+    return os.path.splitext(os.path.basename(path))[0]
+
+
+def replay(args, log):
+    user_dir = os.path.join(args.output, log_name(log))
+    os.makedirs(user_dir, exist_ok=True)
+
+    command = [args.dolphin, '--platform=headless', '--video_backend=' + args.backend,
+               '--user=' + user_dir, '--fifo-batch']
+    if args.dump_frames:
+        command.append('--dump-frames=' + args.dump_frames)
+    command.append(log)
+
+    result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            universal_newlines=True)
+    match = FPS_RE.search(result.stdout)
+    if result.returncode != 0 or not match:
+        return log, None, result.stdout
+    return log, (int(match.group(1)), float(match.group(2)), float(match.group(3))), None
+
+
+def read_hashes(path):
+    try:
+        with open(path) as f:
+            return f.read().splitlines()
+    except OSError:
+        return None
+
+
+def compare_hashes(args, log):
+    name = log_name(log)
+    new = read_hashes(os.path.join(args.output, name, HASHES_PATH))
+    old = read_hashes(os.path.join(args.reference, name, HASHES_PATH))
+    if new is None or old is None:
+        return 'missing hashes'
+
+    for new_line, old_line in zip(new, old):
+        if new_line != old_line:
+            return 'differs from frame %s' % new_line.split()[0]
+    if len(new) != len(old):
+        return '%d frames, reference has %d' % (len(new), len(old))
+    return 'matches'
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('dolphin', help='path to dolphin-emu-nogui')
+    parser.add_argument('logs', nargs='+', help='FIFO logs (.dff) to replay')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                        help='number of replays to run at once')
+    parser.add_argument('-b', '--backend', default='Software', help='video backend to use')
+    parser.add_argument('-o', '--output', default='fifo-batch', help='output folder')
+    parser.add_argument('-d', '--dump-frames', choices=['images', 'hashes'],
+                        help='dump every frame as images or hashes')
+    parser.add_argument('-r', '--reference', help='output folder of a previous run to compare to')
+    args = parser.parse_args()
+
+    if args.reference and args.dump_frames != 'hashes':
+        parser.error('--reference requires --dump-frames=hashes')
+
+    failed = False
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as executor:
+        for log, stats, output in executor.map(lambda log: replay(args, log), args.logs):
+            if stats is None:
+                failed = True
+                print('%s: failed\n%s' % (log, output))
+                continue
+
+            line = '%s: %d frames, %.3f s, %.2f FPS' % ((log,) + stats)
+            if args.reference:
+                comparison = compare_hashes(args, log)
+                failed = failed or comparison != 'matches'
+                line += ', ' + comparison
+            print(line)
+
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())